@@ -0,0 +1,812 @@
+#include "BlockCompression.h"
+#include "Utilities.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace VALX
+{
+    // structure of arrays, so the SIMD kernels process several pixels per register
+    struct PixelBlock
+    {
+        float Channels[4][16];
+    };
+
+    // positions of the palette entries between the endpoints
+    static const float BC1_FOUR_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    static const float BC1_THREE_COLOR_WEIGHTS[3] = { 0.0f, 1.0f, 0.5f };
+    static const float BC4_EIGHT_VALUE_WEIGHTS[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+    static const float BC4_SIX_VALUE_WEIGHTS[6] = { 0.0f, 1.0f, 1.0f / 5.0f, 2.0f / 5.0f, 3.0f / 5.0f, 4.0f / 5.0f };
+    static const uint32_t BC7_INDEX_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    static uint32_t GetIterationCount(CompressionQuality quality)
+    {
+        switch (quality)
+        {
+        case CompressionQuality::FAST:
+            return 1;
+        case CompressionQuality::NORMAL:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    // nearest palette entry search over the channels [firstChannel, firstChannel + channelCount), returns the total squared error.
+    // the vector variants may resolve exact ties between two entries differently, the error is the same either way
+
+    static float FindNearestIndicesScalar(const PixelBlock& block, uint32_t firstChannel, uint32_t channelCount, const float (*palette)[4], uint32_t paletteSize, uint8_t* indices)
+    {
+        float totalError = 0.0f;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            float bestError = FLT_MAX;
+            uint32_t bestIndex = 0;
+            for (uint32_t entry = 0; entry < paletteSize; entry++)
+            {
+                float error = 0.0f;
+                for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+                {
+                    float difference = block.Channels[channel][pixel] - palette[entry][channel];
+                    error += difference * difference;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = entry;
+                }
+            }
+            indices[pixel] = static_cast<uint8_t>(bestIndex);
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+#if defined(VALX_SIMD_X86)
+    static float FindNearestIndicesSSE(const PixelBlock& block, uint32_t firstChannel, uint32_t channelCount, const float (*palette)[4], uint32_t paletteSize, uint8_t* indices)
+    {
+        float totalError = 0.0f;
+        for (uint32_t group = 0; group < 16; group += 4)
+        {
+            __m128 bestError = _mm_set1_ps(FLT_MAX);
+            __m128 bestIndex = _mm_setzero_ps();
+            for (uint32_t entry = 0; entry < paletteSize; entry++)
+            {
+                __m128 error = _mm_setzero_ps();
+                for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+                {
+                    __m128 difference = _mm_sub_ps(_mm_loadu_ps(&block.Channels[channel][group]), _mm_set1_ps(palette[entry][channel]));
+                    error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+                }
+                __m128 isBetter = _mm_cmplt_ps(error, bestError);
+                bestError = _mm_min_ps(error, bestError);
+                bestIndex = _mm_or_ps(_mm_and_ps(isBetter, _mm_set1_ps(float(entry))), _mm_andnot_ps(isBetter, bestIndex));
+            }
+
+            alignas(16) int32_t groupIndices[4];
+            alignas(16) float groupErrors[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), _mm_cvttps_epi32(bestIndex));
+            _mm_store_ps(groupErrors, bestError);
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                indices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+                totalError += groupErrors[i];
+            }
+        }
+        return totalError;
+    }
+
+    VALX_TARGET_AVX2 static float FindNearestIndicesAVX2(const PixelBlock& block, uint32_t firstChannel, uint32_t channelCount, const float (*palette)[4], uint32_t paletteSize, uint8_t* indices)
+    {
+        float totalError = 0.0f;
+        for (uint32_t group = 0; group < 16; group += 8)
+        {
+            __m256 bestError = _mm256_set1_ps(FLT_MAX);
+            __m256 bestIndex = _mm256_setzero_ps();
+            for (uint32_t entry = 0; entry < paletteSize; entry++)
+            {
+                __m256 error = _mm256_setzero_ps();
+                for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+                {
+                    __m256 difference = _mm256_sub_ps(_mm256_loadu_ps(&block.Channels[channel][group]), _mm256_set1_ps(palette[entry][channel]));
+                    error = _mm256_add_ps(error, _mm256_mul_ps(difference, difference));
+                }
+                __m256 isBetter = _mm256_cmp_ps(error, bestError, _CMP_LT_OQ);
+                bestError = _mm256_min_ps(error, bestError);
+                bestIndex = _mm256_blendv_ps(bestIndex, _mm256_set1_ps(float(entry)), isBetter);
+            }
+
+            alignas(32) int32_t groupIndices[8];
+            alignas(32) float groupErrors[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(groupIndices), _mm256_cvttps_epi32(bestIndex));
+            _mm256_store_ps(groupErrors, bestError);
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                indices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+                totalError += groupErrors[i];
+            }
+        }
+        return totalError;
+    }
+#endif
+
+    static float FindNearestIndices(SIMDLevel level, const PixelBlock& block, uint32_t firstChannel, uint32_t channelCount, const float (*palette)[4], uint32_t paletteSize, uint8_t* indices)
+    {
+#if defined(VALX_SIMD_X86)
+        if (level == SIMDLevel::AVX2)
+            return FindNearestIndicesAVX2(block, firstChannel, channelCount, palette, paletteSize, indices);
+        if (level == SIMDLevel::SSE)
+            return FindNearestIndicesSSE(block, firstChannel, channelCount, palette, paletteSize, indices);
+#endif
+        return FindNearestIndicesScalar(block, firstChannel, channelCount, palette, paletteSize, indices);
+    }
+
+    // endpoint selection and refinement, endpoints are indexed by absolute channel
+
+    static void ComputeEndpoints(const PixelBlock& block, uint32_t channelCount, CompressionQuality quality, float* endpoint0, float* endpoint1)
+    {
+        if (quality == CompressionQuality::FAST)
+        {
+            for (uint32_t channel = 0; channel < channelCount; channel++)
+            {
+                endpoint0[channel] = *std::min_element(block.Channels[channel], block.Channels[channel] + 16);
+                endpoint1[channel] = *std::max_element(block.Channels[channel], block.Channels[channel] + 16);
+            }
+            return;
+        }
+
+        float mean[4] = { };
+        for (uint32_t channel = 0; channel < channelCount; channel++)
+        {
+            for (uint32_t pixel = 0; pixel < 16; pixel++)
+                mean[channel] += block.Channels[channel][pixel];
+            mean[channel] /= 16.0f;
+        }
+
+        float covariance[4][4] = { };
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            for (uint32_t i = 0; i < channelCount; i++)
+            {
+                for (uint32_t j = 0; j < channelCount; j++)
+                    covariance[i][j] += (block.Channels[i][pixel] - mean[i]) * (block.Channels[j][pixel] - mean[j]);
+            }
+        }
+
+        // power iteration, starting from the row of the channel with the largest variance
+        uint32_t largestChannel = 0;
+        for (uint32_t channel = 1; channel < channelCount; channel++)
+        {
+            if (covariance[channel][channel] > covariance[largestChannel][largestChannel])
+                largestChannel = channel;
+        }
+        float axis[4] = { };
+        for (uint32_t channel = 0; channel < channelCount; channel++)
+            axis[channel] = covariance[largestChannel][channel];
+
+        for (uint32_t iteration = 0; iteration < 8; iteration++)
+        {
+            float next[4] = { };
+            float length = 0.0f;
+            for (uint32_t i = 0; i < channelCount; i++)
+            {
+                for (uint32_t j = 0; j < channelCount; j++)
+                    next[i] += covariance[i][j] * axis[j];
+                length += next[i] * next[i];
+            }
+            if (length < 1e-12f)
+                break;
+
+            length = std::sqrt(length);
+            for (uint32_t channel = 0; channel < channelCount; channel++)
+                axis[channel] = next[channel] / length;
+        }
+
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            float projection = 0.0f;
+            for (uint32_t channel = 0; channel < channelCount; channel++)
+                projection += (block.Channels[channel][pixel] - mean[channel]) * axis[channel];
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        for (uint32_t channel = 0; channel < channelCount; channel++)
+        {
+            endpoint0[channel] = std::clamp(mean[channel] + minProjection * axis[channel], 0.0f, 255.0f);
+            endpoint1[channel] = std::clamp(mean[channel] + maxProjection * axis[channel], 0.0f, 255.0f);
+        }
+    }
+
+    // least squares endpoints for fixed indices, weights[i] is the position of palette entry i between the endpoints
+    static bool RefineEndpoints(const PixelBlock& block, uint32_t firstChannel, uint32_t channelCount, const uint8_t* indices, const float* weights,
+        const bool* ignoredPixels, float* endpoint0, float* endpoint1)
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        float sum0[4] = { };
+        float sum1[4] = { };
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            if (ignoredPixels != nullptr && ignoredPixels[pixel])
+                continue;
+
+            float weight1 = weights[indices[pixel]];
+            float weight0 = 1.0f - weight1;
+            a += weight0 * weight0;
+            b += weight0 * weight1;
+            c += weight1 * weight1;
+            for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+            {
+                sum0[channel] += weight0 * block.Channels[channel][pixel];
+                sum1[channel] += weight1 * block.Channels[channel][pixel];
+            }
+        }
+
+        float determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-6f)
+            return false;
+
+        for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+        {
+            endpoint0[channel] = std::clamp((c * sum0[channel] - b * sum1[channel]) / determinant, 0.0f, 255.0f);
+            endpoint1[channel] = std::clamp((a * sum1[channel] - b * sum0[channel]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    // BC1
+
+    static uint16_t QuantizeRGB565(const float* color)
+    {
+        uint32_t r = static_cast<uint32_t>(std::lround(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+        uint32_t g = static_cast<uint32_t>(std::lround(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+        uint32_t b = static_cast<uint32_t>(std::lround(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    static void ExpandRGB565(uint16_t value, float* color)
+    {
+        uint32_t r = (value >> 11) & 31;
+        uint32_t g = (value >> 5) & 63;
+        uint32_t b = value & 31;
+        color[0] = float((r << 3) | (r >> 2));
+        color[1] = float((g << 2) | (g >> 4));
+        color[2] = float((b << 3) | (b >> 2));
+        color[3] = 255.0f;
+    }
+
+    static void EncodeBC1Color(SIMDLevel level, const PixelBlock& block, CompressionQuality quality, bool allowTransparency, uint8_t* output)
+    {
+        bool transparentPixels[16] = { };
+        bool hasTransparency = false;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            transparentPixels[pixel] = allowTransparency && block.Channels[3][pixel] < 128.0f;
+            hasTransparency |= transparentPixels[pixel];
+        }
+
+        // transparent blocks use the 3 color mode, index 3 is transparent black
+        const float* weights = hasTransparency ? BC1_THREE_COLOR_WEIGHTS : BC1_FOUR_COLOR_WEIGHTS;
+        uint32_t paletteSize = hasTransparency ? 3 : 4;
+
+        float endpoint0[4] = { };
+        float endpoint1[4] = { };
+        ComputeEndpoints(block, 3, quality, endpoint0, endpoint1);
+
+        float bestError = FLT_MAX;
+        uint16_t bestColor0 = 0;
+        uint16_t bestColor1 = 0;
+        uint8_t bestIndices[16] = { };
+        uint32_t iterationCount = GetIterationCount(quality);
+        for (uint32_t iteration = 0; iteration < iterationCount; iteration++)
+        {
+            uint16_t color0 = QuantizeRGB565(endpoint0);
+            uint16_t color1 = QuantizeRGB565(endpoint1);
+            float palette[4][4] = { };
+            ExpandRGB565(color0, palette[0]);
+            ExpandRGB565(color1, palette[1]);
+            for (uint32_t entry = 2; entry < paletteSize; entry++)
+            {
+                for (uint32_t channel = 0; channel < 3; channel++)
+                    palette[entry][channel] = palette[0][channel] + (palette[1][channel] - palette[0][channel]) * weights[entry];
+            }
+
+            uint8_t indices[16];
+            float error = FindNearestIndices(level, block, 0, 3, palette, paletteSize, indices);
+            if (hasTransparency)
+            {
+                // the color of transparent pixels is discarded, so they do not count
+                error = 0.0f;
+                for (uint32_t pixel = 0; pixel < 16; pixel++)
+                {
+                    for (uint32_t channel = 0; channel < 3 && !transparentPixels[pixel]; channel++)
+                    {
+                        float difference = block.Channels[channel][pixel] - palette[indices[pixel]][channel];
+                        error += difference * difference;
+                    }
+                }
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                bestColor0 = color0;
+                bestColor1 = color1;
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+
+            if (iteration + 1 < iterationCount && !RefineEndpoints(block, 0, 3, indices, weights, transparentPixels, endpoint0, endpoint1))
+                break;
+        }
+
+        // the decoder selects the mode from the endpoint order, swapping the endpoints mirrors the indices
+        if (hasTransparency)
+        {
+            if (bestColor0 > bestColor1)
+            {
+                std::swap(bestColor0, bestColor1);
+                for (uint8_t& index : bestIndices)
+                    index = index < 2 ? index ^ 1 : index;
+            }
+            for (uint32_t pixel = 0; pixel < 16; pixel++)
+            {
+                if (transparentPixels[pixel])
+                    bestIndices[pixel] = 3;
+            }
+        }
+        else if (bestColor0 < bestColor1)
+        {
+            std::swap(bestColor0, bestColor1);
+            for (uint8_t& index : bestIndices)
+                index ^= 1;
+        }
+        else if (bestColor0 == bestColor1)
+        {
+            std::memset(bestIndices, 0, sizeof(bestIndices));
+        }
+
+        uint32_t packedIndices = 0;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+            packedIndices |= uint32_t(bestIndices[pixel]) << (2 * pixel);
+
+        std::memcpy(output + 0, &bestColor0, sizeof(bestColor0));
+        std::memcpy(output + 2, &bestColor1, sizeof(bestColor1));
+        std::memcpy(output + 4, &packedIndices, sizeof(packedIndices));
+    }
+
+    // BC4, also the alpha block of BC3 and both halves of BC5
+
+    static void EncodeBC4Channel(SIMDLevel level, const PixelBlock& block, uint32_t channel, CompressionQuality quality, uint8_t* output)
+    {
+        float minValue = *std::min_element(block.Channels[channel], block.Channels[channel] + 16);
+        float maxValue = *std::max_element(block.Channels[channel], block.Channels[channel] + 16);
+
+        float bestError = FLT_MAX;
+        uint8_t bestValue0 = static_cast<uint8_t>(std::lround(maxValue));
+        uint8_t bestValue1 = bestValue0;
+        uint8_t bestIndices[16] = { };
+
+        // the eight value mode needs value0 > value1, the six value mode (with explicit 0 and 255) value0 <= value1,
+        // the quantized endpoints in stored order are written back, the indices refer to them
+        auto tryEndpoints = [&](float& endpoint0, float& endpoint1, bool sixValueMode, uint8_t* indices) -> bool
+        {
+            uint8_t value0 = static_cast<uint8_t>(std::lround(std::clamp(endpoint0, 0.0f, 255.0f)));
+            uint8_t value1 = static_cast<uint8_t>(std::lround(std::clamp(endpoint1, 0.0f, 255.0f)));
+            if (value0 == value1)
+                return false;
+            if ((value0 < value1) != sixValueMode)
+                std::swap(value0, value1);
+            endpoint0 = float(value0);
+            endpoint1 = float(value1);
+
+            float palette[8][4] = { };
+            const float* weights = sixValueMode ? BC4_SIX_VALUE_WEIGHTS : BC4_EIGHT_VALUE_WEIGHTS;
+            uint32_t interpolatedCount = sixValueMode ? 6 : 8;
+            for (uint32_t entry = 0; entry < interpolatedCount; entry++)
+                palette[entry][channel] = float(value0) + (float(value1) - float(value0)) * weights[entry];
+            if (sixValueMode)
+            {
+                palette[6][channel] = 0.0f;
+                palette[7][channel] = 255.0f;
+            }
+
+            float error = FindNearestIndices(level, block, channel, 1, palette, 8, indices);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestValue0 = value0;
+                bestValue1 = value1;
+                std::memcpy(bestIndices, indices, 16);
+            }
+            return true;
+        };
+
+        if (maxValue > minValue)
+        {
+            float endpoint0[4] = { };
+            float endpoint1[4] = { };
+            endpoint0[channel] = maxValue;
+            endpoint1[channel] = minValue;
+            uint32_t iterationCount = GetIterationCount(quality);
+            for (uint32_t iteration = 0; iteration < iterationCount; iteration++)
+            {
+                uint8_t indices[16];
+                if (!tryEndpoints(endpoint0[channel], endpoint1[channel], false, indices))
+                    break;
+                if (iteration + 1 < iterationCount && !RefineEndpoints(block, channel, 1, indices, BC4_EIGHT_VALUE_WEIGHTS, nullptr, endpoint0, endpoint1))
+                    break;
+            }
+
+            // blocks reaching 0 or 255 can spend the whole interpolated range on the other values
+            if (quality == CompressionQuality::HIGH)
+            {
+                float innerMin = 255.0f;
+                float innerMax = 0.0f;
+                for (uint32_t pixel = 0; pixel < 16; pixel++)
+                {
+                    float value = block.Channels[channel][pixel];
+                    if (value > 0.0f && value < 255.0f)
+                    {
+                        innerMin = std::min(innerMin, value);
+                        innerMax = std::max(innerMax, value);
+                    }
+                }
+                uint8_t indices[16];
+                if (innerMax > innerMin)
+                    tryEndpoints(innerMin, innerMax, true, indices);
+            }
+        }
+
+        // value0 == value1 decodes in the six value mode, where index 0 is value0
+        uint64_t packedIndices = 0;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+            packedIndices |= uint64_t(bestIndices[pixel]) << (3 * pixel);
+
+        output[0] = bestValue0;
+        output[1] = bestValue1;
+        for (uint32_t i = 0; i < 6; i++)
+            output[2 + i] = static_cast<uint8_t>(packedIndices >> (8 * i));
+    }
+
+    // BC7, mode 6 only: one subset, RGBA endpoints of 7 bits plus a shared low bit each, 4 bit indices
+
+    struct BlockBitWriter
+    {
+        uint8_t* Output = nullptr;
+        uint32_t Position = 0;
+
+        void Write(uint32_t value, uint32_t bitCount)
+        {
+            for (uint32_t bit = 0; bit < bitCount; bit++, this->Position++)
+            {
+                if ((value >> bit) & 1)
+                    this->Output[this->Position >> 3] |= static_cast<uint8_t>(1 << (this->Position & 7));
+            }
+        }
+    };
+
+    static float QuantizeBC7Endpoint(const float* endpoint, uint32_t lowBit, uint8_t* quantized)
+    {
+        float error = 0.0f;
+        for (uint32_t channel = 0; channel < 4; channel++)
+        {
+            long value = std::lround((std::clamp(endpoint[channel], 0.0f, 255.0f) - float(lowBit)) * 0.5f);
+            quantized[channel] = static_cast<uint8_t>(std::clamp(value, 0L, 127L));
+            float difference = endpoint[channel] - float(2 * quantized[channel] + lowBit);
+            error += difference * difference;
+        }
+        return error;
+    }
+
+    static void EncodeBC7Mode6(SIMDLevel level, const PixelBlock& block, CompressionQuality quality, uint8_t* output)
+    {
+        float weights[16];
+        for (uint32_t i = 0; i < 16; i++)
+            weights[i] = float(BC7_INDEX_WEIGHTS[i]) / 64.0f;
+
+        float endpoint0[4] = { };
+        float endpoint1[4] = { };
+        ComputeEndpoints(block, 4, quality, endpoint0, endpoint1);
+
+        float bestError = FLT_MAX;
+        uint8_t bestQuantized[2][4] = { };
+        uint32_t bestLowBits[2] = { };
+        uint8_t bestIndices[16] = { };
+        uint32_t iterationCount = GetIterationCount(quality);
+        for (uint32_t iteration = 0; iteration < iterationCount; iteration++)
+        {
+            // low bits closest to the endpoints, high quality tries every combination against the block
+            uint32_t lowBitCandidates[4][2];
+            uint32_t candidateCount = 0;
+            if (quality == CompressionQuality::HIGH)
+            {
+                for (uint32_t combination = 0; combination < 4; combination++)
+                {
+                    lowBitCandidates[candidateCount][0] = combination & 1;
+                    lowBitCandidates[candidateCount][1] = combination >> 1;
+                    candidateCount++;
+                }
+            }
+            else
+            {
+                uint8_t scratch[4];
+                lowBitCandidates[0][0] = QuantizeBC7Endpoint(endpoint0, 1, scratch) < QuantizeBC7Endpoint(endpoint0, 0, scratch) ? 1 : 0;
+                lowBitCandidates[0][1] = QuantizeBC7Endpoint(endpoint1, 1, scratch) < QuantizeBC7Endpoint(endpoint1, 0, scratch) ? 1 : 0;
+                candidateCount = 1;
+            }
+
+            float iterationError = FLT_MAX;
+            uint8_t iterationIndices[16] = { };
+            for (uint32_t candidate = 0; candidate < candidateCount; candidate++)
+            {
+                uint8_t quantized[2][4];
+                uint32_t lowBits[2] = { lowBitCandidates[candidate][0], lowBitCandidates[candidate][1] };
+                QuantizeBC7Endpoint(endpoint0, lowBits[0], quantized[0]);
+                QuantizeBC7Endpoint(endpoint1, lowBits[1], quantized[1]);
+
+                float palette[16][4];
+                for (uint32_t entry = 0; entry < 16; entry++)
+                {
+                    for (uint32_t channel = 0; channel < 4; channel++)
+                    {
+                        uint32_t value0 = 2 * quantized[0][channel] + lowBits[0];
+                        uint32_t value1 = 2 * quantized[1][channel] + lowBits[1];
+                        palette[entry][channel] = float(((64 - BC7_INDEX_WEIGHTS[entry]) * value0 + BC7_INDEX_WEIGHTS[entry] * value1 + 32) >> 6);
+                    }
+                }
+
+                uint8_t indices[16];
+                float error = FindNearestIndices(level, block, 0, 4, palette, 16, indices);
+                if (error < iterationError)
+                {
+                    iterationError = error;
+                    std::memcpy(iterationIndices, indices, sizeof(indices));
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    std::memcpy(bestQuantized, quantized, sizeof(quantized));
+                    bestLowBits[0] = lowBits[0];
+                    bestLowBits[1] = lowBits[1];
+                    std::memcpy(bestIndices, indices, sizeof(indices));
+                }
+            }
+
+            if (iteration + 1 < iterationCount && !RefineEndpoints(block, 0, 4, iterationIndices, weights, nullptr, endpoint0, endpoint1))
+                break;
+        }
+
+        // the most significant index bit of the first pixel is implicit zero
+        if (bestIndices[0] >= 8)
+        {
+            std::swap(bestQuantized[0], bestQuantized[1]);
+            std::swap(bestLowBits[0], bestLowBits[1]);
+            for (uint8_t& index : bestIndices)
+                index = 15 - index;
+        }
+
+        std::memset(output, 0, 16);
+        BlockBitWriter writer;
+        writer.Output = output;
+        writer.Write(1 << 6, 7);
+        for (uint32_t channel = 0; channel < 4; channel++)
+        {
+            writer.Write(bestQuantized[0][channel], 7);
+            writer.Write(bestQuantized[1][channel], 7);
+        }
+        writer.Write(bestLowBits[0], 1);
+        writer.Write(bestLowBits[1], 1);
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+            writer.Write(bestIndices[pixel], pixel == 0 ? 3 : 4);
+    }
+
+    bool IsBlockCompressionSupported(Format target)
+    {
+        switch (GetLinearFormat(target))
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+        case Format::BC1_RGBA_UNORM_BLOCK:
+        case Format::BC3_UNORM_BLOCK:
+        case Format::BC4_UNORM_BLOCK:
+        case Format::BC5_UNORM_BLOCK:
+        case Format::BC7_UNORM_BLOCK:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    uint32_t GetCompressedBlockByteSize(Format target)
+    {
+        switch (GetLinearFormat(target))
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+        case Format::BC1_RGBA_UNORM_BLOCK:
+        case Format::BC4_UNORM_BLOCK:
+            return 8;
+        default:
+            return 16;
+        }
+    }
+
+    Format GetSRGBBlockFormat(Format target)
+    {
+        switch (target)
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+            return Format::BC1_RGB_SRGB_BLOCK;
+        case Format::BC1_RGBA_UNORM_BLOCK:
+            return Format::BC1_RGBA_SRGB_BLOCK;
+        case Format::BC3_UNORM_BLOCK:
+            return Format::BC3_SRGB_BLOCK;
+        case Format::BC7_UNORM_BLOCK:
+            return Format::BC7_SRGB_BLOCK;
+        default:
+            return target;
+        }
+    }
+
+    void EncodeBlock(const uint8_t* pixels, Format target, CompressionQuality quality, bool useSIMD, uint8_t* output)
+    {
+        PixelBlock block;
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+        {
+            for (uint32_t channel = 0; channel < 4; channel++)
+                block.Channels[channel][pixel] = float(pixels[4 * pixel + channel]);
+        }
+
+        SIMDLevel level = useSIMD ? GetSIMDLevel() : SIMDLevel::SCALAR;
+        switch (GetLinearFormat(target))
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+            EncodeBC1Color(level, block, quality, false, output);
+            break;
+        case Format::BC1_RGBA_UNORM_BLOCK:
+            EncodeBC1Color(level, block, quality, true, output);
+            break;
+        case Format::BC3_UNORM_BLOCK:
+            EncodeBC4Channel(level, block, 3, quality, output);
+            EncodeBC1Color(level, block, quality, false, output + 8);
+            break;
+        case Format::BC4_UNORM_BLOCK:
+            EncodeBC4Channel(level, block, 0, quality, output);
+            break;
+        case Format::BC5_UNORM_BLOCK:
+            EncodeBC4Channel(level, block, 0, quality, output);
+            EncodeBC4Channel(level, block, 1, quality, output + 8);
+            break;
+        case Format::BC7_UNORM_BLOCK:
+            EncodeBC7Mode6(level, block, quality, output);
+            break;
+        default:
+            VALX_ASSERT(false && "unsupported block compression format");
+            break;
+        }
+    }
+
+    // decoding, for devices without BC support
+
+    static void DecodeBC1Color(const uint8_t* block, bool alwaysFourColor, bool allowTransparency, uint8_t* pixels)
+    {
+        uint16_t endpoints[2] = { };
+        std::memcpy(endpoints, block, sizeof(endpoints));
+
+        uint8_t palette[4][4] = { };
+        for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+        {
+            float color[4];
+            ExpandRGB565(endpoints[endpoint], color);
+            for (uint32_t channel = 0; channel < 4; channel++)
+                palette[endpoint][channel] = static_cast<uint8_t>(color[channel]);
+        }
+
+        // the 3 color mode is chosen by the endpoint order, its last entry is black and transparent only in BC1_RGBA.
+        // BC2 and BC3 color blocks always interpolate 4 colors
+        bool isFourColor = alwaysFourColor || endpoints[0] > endpoints[1];
+        for (uint32_t channel = 0; channel < 3; channel++)
+        {
+            uint32_t value0 = palette[0][channel];
+            uint32_t value1 = palette[1][channel];
+            if (isFourColor)
+            {
+                palette[2][channel] = static_cast<uint8_t>((2 * value0 + value1 + 1) / 3);
+                palette[3][channel] = static_cast<uint8_t>((value0 + 2 * value1 + 1) / 3);
+            }
+            else
+            {
+                palette[2][channel] = static_cast<uint8_t>((value0 + value1 + 1) / 2);
+                palette[3][channel] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = isFourColor || !allowTransparency ? 255 : 0;
+
+        uint32_t indices = 0;
+        std::memcpy(&indices, block + 4, sizeof(indices));
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+            std::memcpy(pixels + 4 * pixel, palette[(indices >> (2 * pixel)) & 3], 4);
+    }
+
+    static void DecodeBC4Channel(const uint8_t* block, uint32_t channel, uint8_t* pixels)
+    {
+        uint32_t value0 = block[0];
+        uint32_t value1 = block[1];
+        uint8_t palette[8] = { block[0], block[1] };
+        if (value0 > value1)
+        {
+            for (uint32_t i = 1; i < 7; i++)
+                palette[i + 1] = static_cast<uint8_t>(((7 - i) * value0 + i * value1 + 3) / 7);
+        }
+        else
+        {
+            for (uint32_t i = 1; i < 5; i++)
+                palette[i + 1] = static_cast<uint8_t>(((5 - i) * value0 + i * value1 + 2) / 5);
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        std::memcpy(&indices, block + 2, 6);
+        for (uint32_t pixel = 0; pixel < 16; pixel++)
+            pixels[4 * pixel + channel] = palette[(indices >> (3 * pixel)) & 7];
+    }
+
+    bool IsBlockDecodeSupported(Format source)
+    {
+        switch (GetLinearFormat(source))
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+        case Format::BC1_RGBA_UNORM_BLOCK:
+        case Format::BC2_UNORM_BLOCK:
+        case Format::BC3_UNORM_BLOCK:
+        case Format::BC4_UNORM_BLOCK:
+        case Format::BC5_UNORM_BLOCK:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void DecodeBlock(const uint8_t* block, Format source, uint8_t* pixels)
+    {
+        switch (GetLinearFormat(source))
+        {
+        case Format::BC1_RGB_UNORM_BLOCK:
+            DecodeBC1Color(block, false, false, pixels);
+            break;
+        case Format::BC1_RGBA_UNORM_BLOCK:
+            DecodeBC1Color(block, false, true, pixels);
+            break;
+        case Format::BC2_UNORM_BLOCK:
+            DecodeBC1Color(block + 8, true, false, pixels);
+            for (uint32_t pixel = 0; pixel < 16; pixel++)
+                pixels[4 * pixel + 3] = static_cast<uint8_t>(((block[pixel / 2] >> (4 * (pixel % 2))) & 15) * 17);
+            break;
+        case Format::BC3_UNORM_BLOCK:
+            DecodeBC1Color(block + 8, true, false, pixels);
+            DecodeBC4Channel(block, 3, pixels);
+            break;
+        case Format::BC4_UNORM_BLOCK:
+            std::memset(pixels, 0, 64);
+            DecodeBC4Channel(block, 0, pixels);
+            for (uint32_t pixel = 0; pixel < 16; pixel++)
+                pixels[4 * pixel + 3] = 255;
+            break;
+        case Format::BC5_UNORM_BLOCK:
+            std::memset(pixels, 0, 64);
+            DecodeBC4Channel(block, 0, pixels);
+            DecodeBC4Channel(block + 8, 1, pixels);
+            for (uint32_t pixel = 0; pixel < 16; pixel++)
+                pixels[4 * pixel + 3] = 255;
+            break;
+        default:
+            VALX_ASSERT(false && "unsupported block decode format");
+            break;
+        }
+    }
+}
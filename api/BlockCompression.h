@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Format.h"
+
+namespace VALX
+{
+    enum class CompressionQuality
+    {
+        // bounding box endpoints, no refinement
+        FAST,
+        // principal axis endpoints with one least squares refinement
+        NORMAL,
+        // more refinement passes and alternative block modes
+        HIGH,
+    };
+
+    struct TextureCompressionInfo
+    {
+        // BC1_RGB, BC1_RGBA, BC3, BC4_UNORM, BC5_UNORM or BC7, switched to the sRGB variant for sRGB sources
+        Format TargetFormat = Format::BC7_UNORM_BLOCK;
+        CompressionQuality Quality = CompressionQuality::NORMAL;
+        // false selects the scalar reference kernels
+        bool UseSIMD = true;
+        bool Multithreaded = true;
+    };
+
+    bool IsBlockCompressionSupported(Format target);
+    // 8 for BC1 and BC4, 16 for the other supported formats
+    uint32_t GetCompressedBlockByteSize(Format target);
+    // sRGB variant of a block format if it has one
+    Format GetSRGBBlockFormat(Format target);
+
+    // encodes 16 RGBA8 pixels in row order into one block of the target format,
+    // BC4 encodes the red channel and BC5 the red and green channels
+    void EncodeBlock(const uint8_t* pixels, Format target, CompressionQuality quality, bool useSIMD, uint8_t* output);
+
+    // BC1 to BC3 in both color spaces, BC4_UNORM and BC5_UNORM
+    bool IsBlockDecodeSupported(Format source);
+    // decodes one block into 16 RGBA8 pixels in row order, channels missing from BC4 and BC5 read as 0 with an opaque alpha like sampling does
+    void DecodeBlock(const uint8_t* block, Format source, uint8_t* pixels);
+}
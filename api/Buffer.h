@@ -44,6 +44,9 @@ namespace VALX
 
         virtual const BufferInfo& GetInfo() const = 0;
         virtual Buffer::Handle GetHandle() const = 0;
+        // only valid for buffers with CPU visible memory, unmapping flushes the written range
+        virtual uint8_t* MapMemory() = 0;
+        virtual void UnmapMemory() = 0;
         virtual ~Buffer() = default;
     };
 }
\ No newline at end of file
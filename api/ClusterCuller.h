@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "MeshletBuilder.h"
+
+#include <glm/glm.hpp>
+
+namespace VALX
+{
+    // matches VkDrawIndexedIndirectCommand
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t IndexCount = 0;
+        uint32_t InstanceCount = 0;
+        uint32_t FirstIndex = 0;
+        int32_t VertexOffset = 0;
+        uint32_t FirstInstance = 0;
+    };
+
+    enum class ClusterCullingFlags
+    {
+        NONE = 0,
+        FRUSTUM = 1 << 0,
+        BACKFACE_CONE = 1 << 1,
+    };
+    VALX_GENERATE_ENUM_OPS(ClusterCullingFlags)
+
+    struct ClusterCullingInfo
+    {
+        glm::mat4 ViewProjection = glm::mat4(1.0f);
+        // rotation, uniform scale and translation of the culled instance
+        glm::mat4 Model = glm::mat4(1.0f);
+        glm::vec3 CameraPosition = glm::vec3(0.0f);
+        ClusterCullingFlags Flags = ClusterCullingFlags::FRUSTUM | ClusterCullingFlags::BACKFACE_CONE;
+    };
+
+    // culls meshlets on the GPU and compacts the triangles of the visible ones into an index buffer,
+    // which is drawn with one indexed indirect draw per submesh and the vertex buffer of the mesh
+    class ClusterCuller
+    {
+    public:
+        // records culling commands, the results are valid for draws recorded before the next Cull call
+        virtual void Cull(CommandBuffer& commandBuffer, const ClusterCullingInfo& info) = 0;
+        // 32 bit indices, relative to the VertexOffset of the submesh
+        virtual Buffer& GetIndexBuffer() = 0;
+        // one DrawIndexedIndirectCommand per submesh, in submesh order
+        virtual Buffer& GetIndirectBuffer() = 0;
+        virtual uint32_t GetDrawCount() const = 0;
+        virtual ~ClusterCuller() = default;
+    };
+}
@@ -14,8 +14,11 @@ namespace VALX
     class CommandBuffer
     {
     public:
+        using Handle = void*;
+
         virtual void Begin(CommandBufferFlags flags) = 0;
         virtual void End() = 0;
+        virtual CommandBuffer::Handle GetHandle() const = 0;
         virtual ~CommandBuffer() = default;
     };
 }
\ No newline at end of file
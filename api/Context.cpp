@@ -1,4 +1,7 @@
 #include "api/Context.h"
+#include "api/ThreadPool.h"
+
+#include <algorithm>
 
 namespace VALX
 {
@@ -15,4 +18,43 @@ namespace VALX
     {
         return currentContext;
     }
-}
\ No newline at end of file
+
+    std::vector<std::future<std::unique_ptr<Texture>>> Context::LoadTexturesAsync(const std::vector<std::string>& filepaths,
+        const TextureCookInfo& cookInfo, const TextureUploadInfo& uploadInfo)
+    {
+        std::vector<std::future<std::unique_ptr<Texture>>> result;
+        result.reserve(filepaths.size());
+        for (const std::string& filepath : filepaths)
+        {
+            result.push_back(GetThreadPool()->Submit([this, filepath, cookInfo, uploadInfo]() -> std::unique_ptr<Texture>
+            {
+                TextureData data = this->GetTextureLoader()->LoadTextureFromFile(filepath, cookInfo);
+                if (data.IsEmpty())
+                    return nullptr;
+
+                // block-compressed data and data with its whole chain keep the mips of the file
+                uint32_t depth = std::max(data.Depth, 1u);
+                TextureUploadInfo textureUploadInfo = uploadInfo;
+                textureUploadInfo.GenerateMips = uploadInfo.GenerateMips && !IsBlockCompressedFormat(data.TextureFormat) &&
+                    data.MipCount < GetMipLevelCount(std::max({ data.Width, data.Height, depth }));
+
+                TextureInfo textureInfo;
+                textureInfo.Name = filepath;
+                textureInfo.Type = data.Type;
+                textureInfo.TextureFormat = data.TextureFormat;
+                textureInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST | (textureUploadInfo.GenerateMips ? TextureFlags::GENERATE_MIPS : TextureFlags::NONE);
+                textureInfo.Width = data.Width;
+                textureInfo.Height = data.Height;
+                textureInfo.Depth = depth;
+                textureInfo.Layers = data.Layers;
+                textureInfo.Mips = textureUploadInfo.GenerateMips ? ALL_MIPS : data.MipCount;
+                textureInfo.TopDown = data.TopDown;
+
+                std::unique_ptr<Texture> texture = this->CreateTexture(textureInfo);
+                this->UploadTexture(*texture, data, textureUploadInfo);
+                return texture;
+            }));
+        }
+        return result;
+    }
+}
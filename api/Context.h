@@ -3,15 +3,22 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <future>
 
 #include "Surface.h"
 #include "SwapChain.h"
 #include "Texture.h"
+#include "FormatSupport.h"
 #include "Buffer.h"
 #include "Shader.h"
 #include "Sampler.h"
 #include "ShaderLoader.h"
 #include "TextureLoader.h"
+#include "MeshLoader.h"
+#include "ClusterCuller.h"
+#include "EnvironmentBaker.h"
+#include "VirtualTexture.h"
+#include "TextureStreamer.h"
 
 namespace VALX
 {
@@ -44,14 +51,44 @@ namespace VALX
     {
     public:
         virtual TextureLoader* GetTextureLoader() = 0;
+        virtual MeshLoader* GetMeshLoader() = 0;
         virtual ShaderLoader* GetShaderLoader() = 0;
 
+        // queried for every format when the context is created
+        virtual const FormatCapabilities& GetFormatCapabilities(Format format) const = 0;
+        // format CreateTexture gives a texture of this format and these flags: the format itself if the device supports it, else its
+        // fallback if that is supported, else UNKNOWN. Uploads of data in the original format are converted on the CPU
+        virtual Format GetSupportedTextureFormat(Format format, TextureFlags flags) const = 0;
+
         virtual std::unique_ptr<Surface> CreateSurface(const class Window& window) = 0;
         virtual std::unique_ptr<SwapChain> CreateSwapChain(const Surface& surface) = 0;
         virtual std::unique_ptr<Texture> CreateTexture(const TextureInfo& info) = 0;
         virtual std::unique_ptr<Buffer> CreateBuffer(const BufferInfo& info) = 0;
         virtual std::unique_ptr<Shader> CreateShader(const ShaderInfo& info) = 0;
+        // a sampler of its own, GetSampler shares one between equal infos
         virtual std::unique_ptr<Sampler> CreateSampler(const SamplerInfo& info) = 0;
+        // shared sampler for every info equal to this one apart from the name, destroyed when the last reference is released.
+        // Devices limit the samplers alive at once, prefer this one for samplers that repeat across materials
+        virtual std::shared_ptr<Sampler> GetSampler(const SamplerInfo& info) = 0;
+        virtual std::unique_ptr<ClusterCuller> CreateClusterCuller(const MeshData& mesh, const MeshletData& meshlets) = 0;
+        virtual std::unique_ptr<EnvironmentBaker> CreateEnvironmentBaker() = 0;
+        virtual std::unique_ptr<VirtualTexture> CreateVirtualTexture(const VirtualTextureInfo& info) = 0;
+        virtual std::unique_ptr<TextureStreamer> CreateTextureStreamer(const TextureStreamerInfo& info) = 0;
+        // converts a 2D cross or panorama to a cube map on the GPU and generates its mips, blocks until it is ready for sampling
+        virtual std::unique_ptr<Texture> CreateCubeMap(const TextureData& source, const CubeMapConversionInfo& info) = 0;
+
+        // blocks until the data is copied, the texture is left ready for sampling
+        virtual void UploadTexture(Texture& texture, const TextureData& data, const TextureUploadInfo& info) = 0;
+        // copies straight from the file mapping into the staging memory
+        virtual void UploadTexture(Texture& texture, const MappedTextureData& data, const TextureUploadInfo& info) = 0;
+
+        // loads and cooks every file on the thread pool like TextureLoader::LoadTexturesAsync, then creates its texture and uploads
+        // it from the same worker, so decoding and uploads of different files overlap. The futures are in the order of the paths,
+        // files that fail to load give a null texture. The row order of the data is reported by TextureInfo::TopDown of each texture.
+        // uploadInfo.GenerateMips only completes uncompressed textures whose files store part of the chain.
+        // The context has to outlive the returned futures
+        std::vector<std::future<std::unique_ptr<Texture>>> LoadTexturesAsync(const std::vector<std::string>& filepaths,
+            const TextureCookInfo& cookInfo = {}, const TextureUploadInfo& uploadInfo = {});
 
         virtual ~Context() = default;
     };
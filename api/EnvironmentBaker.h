@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Texture.h"
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace VALX
+{
+    struct EnvironmentBakeInfo
+    {
+        std::string Name;
+        // layout of 2D sources, cube map sources are used as they are
+        CubeMapLayout SourceLayout = CubeMapLayout::EQUIRECTANGULAR;
+        // face size of the environment the maps are filtered from, 0 takes a quarter of the width of 2D sources
+        uint32_t EnvironmentSize = 0;
+        uint32_t IrradianceSize = 32;
+        uint32_t IrradianceSampleCount = 512;
+        // face size of the top mip of the prefiltered map, 0 keeps the environment size
+        uint32_t PrefilteredSize = 0;
+        uint32_t PrefilteredSampleCount = 1024;
+        // outputs are written as pow(color, 1 / OutputGamma) for shaders that decode them manually, 1 stores linear values
+        float OutputGamma = 1.0f;
+    };
+
+    struct EnvironmentMaps
+    {
+        // R16G16B16A16_SFLOAT cube map of the cosine convolved radiance
+        std::shared_ptr<Texture> Irradiance;
+        // R16G16B16A16_SFLOAT cube map, GGX prefiltered per mip, see GetPrefilteredMipRoughness
+        std::shared_ptr<Texture> Prefiltered;
+        // R16G16_SFLOAT split sum scale and bias, addressed with (NdotV, 1 - roughness). Shared by every environment
+        std::shared_ptr<Texture> BRDFLUT;
+    };
+
+    // roughness mip m of the prefiltered map is convolved with, sqrt(2^m / size), so sampling at lod log2(size * roughness^2)
+    // selects the right mip. The top mip is a plain copy of the environment
+    inline float GetPrefilteredMipRoughness(uint32_t mip, uint32_t size)
+    {
+        return mip == 0 ? 0.0f : std::min(std::sqrt(float(1u << mip) / float(size)), 1.0f);
+    }
+
+    // precomputes image based lighting on the GPU, results are cached by the contents of the source and the settings,
+    // so switching back to an environment baked before costs a lookup
+    class EnvironmentBaker
+    {
+    public:
+        // blocks until the maps are ready for sampling
+        virtual EnvironmentMaps Bake(const TextureData& environment, const EnvironmentBakeInfo& info) = 0;
+        // least recently used environments are released beyond this count, textures still referenced elsewhere stay alive
+        virtual void SetCacheCapacity(size_t capacity) = 0;
+        virtual void ClearCache() = 0;
+        virtual ~EnvironmentBaker() = default;
+    };
+}
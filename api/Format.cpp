@@ -1,323 +1,397 @@
 #include "Format.h"
 #include "Utilities.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 namespace VALX
 {
-    uint32_t GetPixelByteSize(Format format)
+    Format GetLinearFormat(Format format)
     {
         switch (format)
         {
-        case VALX::Format::UNKNOWN:
-            return 0;
-        case VALX::Format::R4G4_UNORM_PACK8:
-            return 1;
-        case VALX::Format::R4G4B4A4_UNORM_PACK16:
-            return 2;
-        case VALX::Format::B4G4R4A4_UNORM_PACK16:
-            return 2;
-        case VALX::Format::R5G6B5_UNORM_PACK16:
-            return 2;
-        case VALX::Format::B5G6R5_UNORM_PACK16:
-            return 2;
-        case VALX::Format::R5G5B5A1_UNORM_PACK16:
-            return 2;
-        case VALX::Format::B5G5R5A1_UNORM_PACK16:
-            return 2;
-        case VALX::Format::A1R5G5B5_UNORM_PACK16:
-            return 2;
-        case VALX::Format::R8_UNORM:
-            return 1;
-        case VALX::Format::R8_SNORM:
-            return 1;
-        case VALX::Format::R8_USCALED:
-            return 1;
-        case VALX::Format::R8_SSCALED:
-            return 1;
-        case VALX::Format::R8_UINT:
-            return 1;
-        case VALX::Format::R8_SINT:
-            return 1;
         case VALX::Format::R8_SRGB:
-            return 1;
-        case VALX::Format::R8G8_UNORM:
-            return 2;
-        case VALX::Format::R8G8_SNORM:
-            return 2;
-        case VALX::Format::R8G8_USCALED:
-            return 2;
-        case VALX::Format::R8G8_SSCALED:
-            return 2;
-        case VALX::Format::R8G8_UINT:
-            return 2;
-        case VALX::Format::R8G8_SINT:
-            return 2;
+            return Format::R8_UNORM;
         case VALX::Format::R8G8_SRGB:
-            return 2;
-        case VALX::Format::R8G8B8_UNORM:
-            return 3;
-        case VALX::Format::R8G8B8_SNORM:
-            return 3;
-        case VALX::Format::R8G8B8_USCALED:
-            return 3;
-        case VALX::Format::R8G8B8_SSCALED:
-            return 3;
-        case VALX::Format::R8G8B8_UINT:
-            return 3;
-        case VALX::Format::R8G8B8_SINT:
-            return 3;
+            return Format::R8G8_UNORM;
         case VALX::Format::R8G8B8_SRGB:
-            return 3;
-        case VALX::Format::B8G8R8_UNORM:
-            return 3;
-        case VALX::Format::B8G8R8_SNORM:
-            return 3;
-        case VALX::Format::B8G8R8_USCALED:
-            return 3;
-        case VALX::Format::B8G8R8_SSCALED:
-            return 3;
-        case VALX::Format::B8G8R8_UINT:
-            return 3;
-        case VALX::Format::B8G8R8_SINT:
-            return 3;
+            return Format::R8G8B8_UNORM;
         case VALX::Format::B8G8R8_SRGB:
-            return 3;
-        case VALX::Format::R8G8B8A8_UNORM:
-            return 4;
-        case VALX::Format::R8G8B8A8_SNORM:
-            return 4;
-        case VALX::Format::R8G8B8A8_USCALED:
-            return 4;
-        case VALX::Format::R8G8B8A8_SSCALED:
-            return 4;
-        case VALX::Format::R8G8B8A8_UINT:
-            return 4;
-        case VALX::Format::R8G8B8A8_SINT:
-            return 4;
+            return Format::B8G8R8_UNORM;
         case VALX::Format::R8G8B8A8_SRGB:
-            return 4;
-        case VALX::Format::B8G8R8A8_UNORM:
-            return 4;
-        case VALX::Format::B8G8R8A8_SNORM:
-            return 4;
-        case VALX::Format::B8G8R8A8_USCALED:
-            return 4;
-        case VALX::Format::B8G8R8A8_SSCALED:
-            return 4;
-        case VALX::Format::B8G8R8A8_UINT:
-            return 4;
-        case VALX::Format::B8G8R8A8_SINT:
-            return 4;
+            return Format::R8G8B8A8_UNORM;
         case VALX::Format::B8G8R8A8_SRGB:
-            return 4;
-        case VALX::Format::A8B8G8R8_UNORM_PACK32:
-            return 4;
-        case VALX::Format::A8B8G8R8_SNORM_PACK32:
-            return 4;
-        case VALX::Format::A8B8G8R8_USCALED_PACK32:
-            return 4;
-        case VALX::Format::A8B8G8R8_SSCALED_PACK32:
-            return 4;
-        case VALX::Format::A8B8G8R8_UINT_PACK32:
-            return 4;
-        case VALX::Format::A8B8G8R8_SINT_PACK32:
-            return 4;
+            return Format::B8G8R8A8_UNORM;
         case VALX::Format::A8B8G8R8_SRGB_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_UNORM_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_SNORM_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_USCALED_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_SSCALED_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_UINT_PACK32:
-            return 4;
-        case VALX::Format::A2R10G10B10_SINT_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_UNORM_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_SNORM_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_USCALED_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_SSCALED_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_UINT_PACK32:
-            return 4;
-        case VALX::Format::A2B10G10R10_SINT_PACK32:
-            return 4;
-        case VALX::Format::R16_UNORM:
-            return 2;
-        case VALX::Format::R16_SNORM:
-            return 2;
-        case VALX::Format::R16_USCALED:
-            return 2;
-        case VALX::Format::R16_SSCALED:
-            return 2;
-        case VALX::Format::R16_UINT:
-            return 2;
-        case VALX::Format::R16_SINT:
-            return 2;
-        case VALX::Format::R16_SFLOAT:
-            return 2;
-        case VALX::Format::R16G16_UNORM:
-            return 4;
-        case VALX::Format::R16G16_SNORM:
-            return 4;
-        case VALX::Format::R16G16_USCALED:
-            return 4;
-        case VALX::Format::R16G16_SSCALED:
-            return 4;
-        case VALX::Format::R16G16_UINT:
-            return 4;
-        case VALX::Format::R16G16_SINT:
-            return 4;
-        case VALX::Format::R16G16_SFLOAT:
-            return 4;
-        case VALX::Format::R16G16B16_UNORM:
-            return 6;
-        case VALX::Format::R16G16B16_SNORM:
-            return 6;
-        case VALX::Format::R16G16B16_USCALED:
-            return 6;
-        case VALX::Format::R16G16B16_SSCALED:
-            return 6;
-        case VALX::Format::R16G16B16_UINT:
-            return 6;
-        case VALX::Format::R16G16B16_SINT:
-            return 6;
-        case VALX::Format::R16G16B16_SFLOAT:
-            return 6;
-        case VALX::Format::R16G16B16A16_UNORM:
-            return 8;
-        case VALX::Format::R16G16B16A16_SNORM:
-            return 8;
-        case VALX::Format::R16G16B16A16_USCALED:
-            return 8;
-        case VALX::Format::R16G16B16A16_SSCALED:
-            return 8;
-        case VALX::Format::R16G16B16A16_UINT:
-            return 8;
-        case VALX::Format::R16G16B16A16_SINT:
-            return 8;
-        case VALX::Format::R16G16B16A16_SFLOAT:
-            return 8;
-        case VALX::Format::R32_UINT:
-            return 4;
-        case VALX::Format::R32_SINT:
-            return 4;
-        case VALX::Format::R32_SFLOAT:
-            return 4;
-        case VALX::Format::R32G32_UINT:
-            return 8;
-        case VALX::Format::R32G32_SINT:
-            return 8;
-        case VALX::Format::R32G32_SFLOAT:
-            return 8;
-        case VALX::Format::R32G32B32_UINT:
-            return 12;
-        case VALX::Format::R32G32B32_SINT:
-            return 12;
-        case VALX::Format::R32G32B32_SFLOAT:
-            return 12;
-        case VALX::Format::R32G32B32A32_UINT:
-            return 16;
-        case VALX::Format::R32G32B32A32_SINT:
-            return 16;
-        case VALX::Format::R32G32B32A32_SFLOAT:
-            return 16;
-        case VALX::Format::R64_UINT:
-            return 8;
-        case VALX::Format::R64_SINT:
-            return 8;
-        case VALX::Format::R64_SFLOAT:
-            return 8;
-        case VALX::Format::R64G64_UINT:
-            return 16;
-        case VALX::Format::R64G64_SINT:
-            return 16;
-        case VALX::Format::R64G64_SFLOAT:
-            return 16;
-        case VALX::Format::R64G64B64_UINT:
-            return 24;
-        case VALX::Format::R64G64B64_SINT:
-            return 24;
-        case VALX::Format::R64G64B64_SFLOAT:
-            return 24;
-        case VALX::Format::R64G64B64A64_UINT:
-            return 32;
-        case VALX::Format::R64G64B64A64_SINT:
-            return 32;
-        case VALX::Format::R64G64B64A64_SFLOAT:
-            return 32;
-        case VALX::Format::B10G11R11_UFLOAT_PACK32:
-            return 4;
-        case VALX::Format::E5B9G9R9_UFLOAT_PACK32:
-            return 4;
-        case VALX::Format::D16_UNORM:
-            return 2;
-        case VALX::Format::X8_D24_UNORM_PACK32:
-            return 4;
-        case VALX::Format::D32_SFLOAT:
-            return 4;
-        case VALX::Format::S8_UINT:
-            return 1;
-        case VALX::Format::D16_UNORM_S8_UINT:
-            return 3;
-        case VALX::Format::D24_UNORM_S8_UINT:
-            return 4;
-        case VALX::Format::D32_SFLOAT_S8_UINT:
-            return 5;
-        case VALX::Format::BC1_RGB_UNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
+            return Format::A8B8G8R8_UNORM_PACK32;
         case VALX::Format::BC1_RGB_SRGB_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC1_RGBA_UNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
+            return Format::BC1_RGB_UNORM_BLOCK;
         case VALX::Format::BC1_RGBA_SRGB_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC2_UNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
+            return Format::BC1_RGBA_UNORM_BLOCK;
         case VALX::Format::BC2_SRGB_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC3_UNORM_BLOCK:
-            break;
+            return Format::BC2_UNORM_BLOCK;
         case VALX::Format::BC3_SRGB_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC4_UNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC4_SNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC5_UNORM_BLOCK:
-            break;
-        case VALX::Format::BC5_SNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC6H_UFLOAT_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC6H_SFLOAT_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
-        case VALX::Format::BC7_UNORM_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
+            return Format::BC3_UNORM_BLOCK;
         case VALX::Format::BC7_SRGB_BLOCK:
-            VALX_ASSERT(false && "compressed format");
-            return 0;
+            return Format::BC7_UNORM_BLOCK;
+        default:
+            return format;
+        }
+    }
+
+    uint16_t FloatToHalf(float value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const uint32_t exponent = (bits >> 23) & 0xFFu;
+        uint32_t mantissa = bits & 0x7FFFFFu;
+
+        if (exponent == 0xFF) // infinity or NaN
+            return static_cast<uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+
+        const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1F) // overflow
+            return static_cast<uint16_t>(sign | 0x7C00u);
+
+        if (halfExponent <= 0) // subnormal half or zero
+        {
+            if (halfExponent < -10)
+                return static_cast<uint16_t>(sign);
+
+            mantissa |= 0x800000u;
+            const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t halfMantissa = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u)))
+                halfMantissa++;
+            return static_cast<uint16_t>(sign | halfMantissa);
+        }
+
+        // carry from rounding may propagate into the exponent, which also correctly rounds to infinity
+        uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            half++;
+        return static_cast<uint16_t>(half);
+    }
+
+    float HalfToFloat(uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        int32_t exponent = (value >> 10) & 0x1F;
+        uint32_t mantissa = value & 0x3FFu;
+
+        uint32_t bits = 0;
+        if (exponent == 0)
+        {
+            if (mantissa == 0)
+            {
+                bits = sign;
+            }
+            else
+            {
+                // renormalize subnormal value
+                exponent = 1;
+                while ((mantissa & 0x400u) == 0)
+                {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                mantissa &= 0x3FFu;
+                bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+            }
+        }
+        else if (exponent == 0x1F)
+        {
+            bits = sign | 0x7F800000u | (mantissa << 13);
+        }
+        else
+        {
+            bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+
+        float result = 0.0f;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    int16_t FloatToSnorm16(float value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    float Snorm16ToFloat(int16_t value)
+    {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    // unsigned float with a 5 bit exponent biased by 15 and no sign, as the channels of B10G11R11_UFLOAT_PACK32
+    static uint32_t FloatToUnsignedSmallFloat(float value, uint32_t mantissaBits)
+    {
+        const float maxValue = std::ldexp(2.0f - std::ldexp(1.0f, -(int)mantissaBits), 15);
+        // NaN fails the comparison as well
+        value = value > 0.0f ? std::min(value, maxValue) : 0.0f;
+
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t shift = 23 - mantissaBits;
+        if (bits < (113u << 23))
+        {
+            // below the smallest normal value, adding a power of two moves the rounded mantissa into the low bits
+            const uint32_t magicBits = ((127u - 15u) + shift + 1u) << 23;
+            float magic = 0.0f;
+            std::memcpy(&magic, &magicBits, sizeof(magic));
+            float sum = value + magic;
+            uint32_t sumBits = 0;
+            std::memcpy(&sumBits, &sum, sizeof(sumBits));
+            return sumBits - magicBits;
+        }
+
+        // rebias the exponent and round to nearest even, a carry moves into the exponent
+        const uint32_t odd = (bits >> shift) & 1u;
+        bits += (uint32_t)(15 - 127) * (1u << 23) + (1u << (shift - 1)) - 1u + odd;
+        return bits >> shift;
+    }
+
+    static float UnsignedSmallFloatToFloat(uint32_t value, uint32_t mantissaBits)
+    {
+        const uint32_t exponent = value >> mantissaBits;
+        const uint32_t mantissa = value & ((1u << mantissaBits) - 1u);
+        if (exponent == 0)
+            return std::ldexp(static_cast<float>(mantissa), -14 - (int)mantissaBits);
+        if (exponent == 0x1F)
+            return mantissa != 0 ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+        return std::ldexp(1.0f + std::ldexp(static_cast<float>(mantissa), -(int)mantissaBits), (int)exponent - 15);
+    }
+
+    uint32_t FloatToR11G11B10(float red, float green, float blue)
+    {
+        return FloatToUnsignedSmallFloat(red, 6) | (FloatToUnsignedSmallFloat(green, 6) << 11) | (FloatToUnsignedSmallFloat(blue, 5) << 22);
+    }
+
+    void R11G11B10ToFloat(uint32_t value, float& red, float& green, float& blue)
+    {
+        red = UnsignedSmallFloatToFloat(value & 0x7FFu, 6);
+        green = UnsignedSmallFloatToFloat((value >> 11) & 0x7FFu, 6);
+        blue = UnsignedSmallFloatToFloat(value >> 22, 5);
+    }
+
+    static void ConvertFloatToHalfScalar(const float* source, uint16_t* target, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            target[i] = FloatToHalf(source[i]);
+    }
+
+    static void ConvertFloatToR11G11B10Scalar(const float* source, uint32_t* target, size_t texelCount)
+    {
+        for (size_t i = 0; i < texelCount; i++)
+            target[i] = FloatToR11G11B10(source[i * 4 + 0], source[i * 4 + 1], source[i * 4 + 2]);
+    }
+
+#if defined(VALX_SIMD_X86)
+    static __m128i SelectSSE(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // the scalar FloatToHalf in four 32 bit lanes: the same rebias and round to nearest even for normal values, a magic number
+    // addition for subnormal ones
+    static __m128i FloatToHalfSSE(__m128 value)
+    {
+        const __m128i bits = _mm_castps_si128(value);
+        const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+        const __m128i magnitude = _mm_xor_si128(bits, sign);
+
+        const __m128i denormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(denormalMagic))), denormalMagic);
+
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+        __m128i normal = _mm_add_epi32(magnitude, _mm_set1_epi32((15 - 127) * (1 << 23) + 0xFFF));
+        normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), 13);
+
+        // magnitudes are positive, so the signed comparisons hold. Values rounding to 65536 and above become infinity
+        const __m128i isSubnormal = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(113 << 23));
+        const __m128i isOverflow = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x477FEFFF));
+        const __m128i isNaN = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x7F800000));
+        const __m128i special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNaN, _mm_set1_epi32(0x200)));
+
+        __m128i half = SelectSSE(isSubnormal, subnormal, normal);
+        half = SelectSSE(isOverflow, special, half);
+        return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+    }
+
+    static void ConvertFloatToHalfSSE(const float* source, uint16_t* target, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // sign extend the low halves, so the saturating pack keeps them unchanged
+            __m128i low = FloatToHalfSSE(_mm_loadu_ps(source + i));
+            __m128i high = FloatToHalfSSE(_mm_loadu_ps(source + i + 4));
+            low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+            high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_packs_epi32(low, high));
+        }
+        ConvertFloatToHalfScalar(source + i, target + i, count - i);
+    }
+
+    VALX_TARGET_AVX2 static void ConvertFloatToHalfAVX2(const float* source, uint16_t* target, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i low = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            __m128i high = _mm256_cvtps_ph(_mm256_loadu_ps(source + i + 8), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i + 8), high);
+        }
+        ConvertFloatToHalfScalar(source + i, target + i, count - i);
+    }
+
+    template<int MantissaBits>
+    static __m128i FloatToUnsignedSmallFloatSSE(__m128 value)
+    {
+        constexpr int SHIFT = 23 - MantissaBits;
+        // (2 - 2^-MantissaBits) * 2^15, the largest finite value
+        const __m128i maxBits = _mm_set1_epi32(((15 + 127) << 23) | (((1 << MantissaBits) - 1) << SHIFT));
+        // max returns its second operand for NaN
+        value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_castsi128_ps(maxBits));
+        const __m128i bits = _mm_castps_si128(value);
+
+        const __m128i denormalMagic = _mm_set1_epi32(((127 - 15) + SHIFT + 1) << 23);
+        const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(value, _mm_castsi128_ps(denormalMagic))), denormalMagic);
+
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, SHIFT), _mm_set1_epi32(1));
+        __m128i normal = _mm_add_epi32(bits, _mm_set1_epi32((15 - 127) * (1 << 23) + (1 << (SHIFT - 1)) - 1));
+        normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), SHIFT);
+
+        return SelectSSE(_mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23)), subnormal, normal);
+    }
+
+    static void ConvertFloatToR11G11B10SSE(const float* source, uint32_t* target, size_t texelCount)
+    {
+        size_t i = 0;
+        for (; i + 4 <= texelCount; i += 4)
+        {
+            // four RGBA texels turn into one register per channel
+            __m128 red = _mm_loadu_ps(source + i * 4 + 0);
+            __m128 green = _mm_loadu_ps(source + i * 4 + 4);
+            __m128 blue = _mm_loadu_ps(source + i * 4 + 8);
+            __m128 alpha = _mm_loadu_ps(source + i * 4 + 12);
+            _MM_TRANSPOSE4_PS(red, green, blue, alpha);
+
+            __m128i packed = FloatToUnsignedSmallFloatSSE<6>(red);
+            packed = _mm_or_si128(packed, _mm_slli_epi32(FloatToUnsignedSmallFloatSSE<6>(green), 11));
+            packed = _mm_or_si128(packed, _mm_slli_epi32(FloatToUnsignedSmallFloatSSE<5>(blue), 22));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), packed);
+        }
+        ConvertFloatToR11G11B10Scalar(source + i * 4, target + i, texelCount - i);
+    }
+#endif
+
+    void ConvertFloatToHalf(const float* source, uint16_t* target, size_t count, bool useSIMD)
+    {
+#if defined(VALX_SIMD_X86)
+        SIMDLevel level = useSIMD ? GetSIMDLevel() : SIMDLevel::SCALAR;
+        if (level == SIMDLevel::AVX2)
+            return ConvertFloatToHalfAVX2(source, target, count);
+        if (level == SIMDLevel::SSE)
+            return ConvertFloatToHalfSSE(source, target, count);
+#endif
+        ConvertFloatToHalfScalar(source, target, count);
+    }
+
+    void ConvertFloatToR11G11B10(const float* source, uint32_t* target, size_t texelCount, bool useSIMD)
+    {
+        // the packing is bound by the transpose and shifts, wider registers gain little over SSE
+#if defined(VALX_SIMD_X86)
+        if (useSIMD && GetSIMDLevel() != SIMDLevel::SCALAR)
+            return ConvertFloatToR11G11B10SSE(source, target, texelCount);
+#endif
+        ConvertFloatToR11G11B10Scalar(source, target, texelCount);
+    }
+
+    // bytes of an opaque alpha value for a channel size, little endian
+    static uint32_t GetOpaqueAlpha(uint32_t channelByteSize)
+    {
+        switch (channelByteSize)
+        {
+        case 1:
+            return 0xFFu;
+        case 2:
+            return 0x3C00u;
         default:
-            VALX_ASSERT(false && "invalid format");
-            return 0;
+            return 0x3F800000u;
+        }
+    }
+
+    static void ExpandRGBToRGBAScalar(const uint8_t* source, uint8_t* target, size_t texelCount, uint32_t channelByteSize)
+    {
+        const uint32_t alpha = GetOpaqueAlpha(channelByteSize);
+        for (size_t i = 0; i < texelCount; i++)
+        {
+            std::memcpy(target + i * 4 * channelByteSize, source + i * 3 * channelByteSize, 3 * channelByteSize);
+            std::memcpy(target + i * 4 * channelByteSize + 3 * channelByteSize, &alpha, channelByteSize);
+        }
+    }
+
+#if defined(VALX_SIMD_X86)
+    // every 128 bit lane spreads the texels of 16 loaded bytes over 16 stored bytes, the loaded bytes past those texels are dropped.
+    // SSE2 has no byte shuffle, CPUs below the AVX2 level take the scalar loop
+    template<uint32_t ChannelByteSize>
+    VALX_TARGET_AVX2 static void ExpandRGBToRGBAAVX2(const uint8_t* source, uint8_t* target, size_t texelCount)
+    {
+        constexpr uint32_t TEXELS_PER_LANE = 4 / ChannelByteSize;
+        constexpr uint32_t SOURCE_TEXEL_SIZE = 3 * ChannelByteSize;
+        constexpr uint32_t TARGET_TEXEL_SIZE = 4 * ChannelByteSize;
+
+        alignas(32) int8_t shuffleBytes[32] = { };
+        alignas(32) uint8_t alphaBytes[32] = { };
+        const uint32_t alpha = GetOpaqueAlpha(ChannelByteSize);
+        for (uint32_t byte = 0; byte < 32; byte++)
+        {
+            uint32_t texel = (byte % 16) / TARGET_TEXEL_SIZE;
+            uint32_t texelByte = (byte % 16) % TARGET_TEXEL_SIZE;
+            bool isAlpha = texelByte >= SOURCE_TEXEL_SIZE;
+            shuffleBytes[byte] = isAlpha ? int8_t(-1) : static_cast<int8_t>(texel * SOURCE_TEXEL_SIZE + texelByte);
+            alphaBytes[byte] = isAlpha ? static_cast<uint8_t>(alpha >> (8 * (texelByte - SOURCE_TEXEL_SIZE))) : 0;
+        }
+        const __m256i shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffleBytes));
+        const __m256i alphaMask = _mm256_load_si256(reinterpret_cast<const __m256i*>(alphaBytes));
+
+        // the load of the upper lane reads past its texels, the loop stops while those bytes still belong to the source
+        size_t i = 0;
+        for (; i + 2 * TEXELS_PER_LANE + 2 <= texelCount; i += 2 * TEXELS_PER_LANE)
+        {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * SOURCE_TEXEL_SIZE));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + (i + TEXELS_PER_LANE) * SOURCE_TEXEL_SIZE));
+            __m256i texels = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+            texels = _mm256_or_si256(_mm256_shuffle_epi8(texels, shuffle), alphaMask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * TARGET_TEXEL_SIZE), texels);
+        }
+        ExpandRGBToRGBAScalar(source + i * SOURCE_TEXEL_SIZE, target + i * TARGET_TEXEL_SIZE, texelCount - i, ChannelByteSize);
+    }
+#endif
+
+    void ExpandRGBToRGBA(const uint8_t* source, uint8_t* target, size_t texelCount, uint32_t channelByteSize, bool useSIMD)
+    {
+        VALX_ASSERT(channelByteSize == 1 || channelByteSize == 2 || channelByteSize == 4);
+#if defined(VALX_SIMD_X86)
+        if (useSIMD && GetSIMDLevel() == SIMDLevel::AVX2)
+        {
+            if (channelByteSize == 1)
+                return ExpandRGBToRGBAAVX2<1>(source, target, texelCount);
+            if (channelByteSize == 2)
+                return ExpandRGBToRGBAAVX2<2>(source, target, texelCount);
+            return ExpandRGBToRGBAAVX2<4>(source, target, texelCount);
         }
+#endif
+        ExpandRGBToRGBAScalar(source, target, texelCount, channelByteSize);
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 
 namespace VALX
 {
@@ -155,5 +156,243 @@ namespace VALX
         BC7_SRGB_BLOCK,
     };
 
-    uint32_t GetPixelByteSize(Format format);
+    // sizes are given per texel block, which is a single texel for formats that are not block compressed
+    struct FormatInfo
+    {
+        uint8_t BlockWidth;
+        uint8_t BlockHeight;
+        uint8_t BlockByteSize;
+        uint8_t ChannelCount;
+        bool IsSRGB;
+        bool HasDepth;
+        bool HasStencil;
+        bool IsCompressed;
+    };
+
+    // indexed by Format. Packed depth stencil formats list the bytes both aspects take in a host copy
+    inline constexpr FormatInfo FORMAT_INFOS[] = {
+        { 1, 1,  0, 0, false, false, false, false }, // UNKNOWN
+        { 1, 1,  1, 2, false, false, false, false }, // R4G4_UNORM_PACK8
+        { 1, 1,  2, 4, false, false, false, false }, // R4G4B4A4_UNORM_PACK16
+        { 1, 1,  2, 4, false, false, false, false }, // B4G4R4A4_UNORM_PACK16
+        { 1, 1,  2, 3, false, false, false, false }, // R5G6B5_UNORM_PACK16
+        { 1, 1,  2, 3, false, false, false, false }, // B5G6R5_UNORM_PACK16
+        { 1, 1,  2, 4, false, false, false, false }, // R5G5B5A1_UNORM_PACK16
+        { 1, 1,  2, 4, false, false, false, false }, // B5G5R5A1_UNORM_PACK16
+        { 1, 1,  2, 4, false, false, false, false }, // A1R5G5B5_UNORM_PACK16
+        { 1, 1,  1, 1, false, false, false, false }, // R8_UNORM
+        { 1, 1,  1, 1, false, false, false, false }, // R8_SNORM
+        { 1, 1,  1, 1, false, false, false, false }, // R8_USCALED
+        { 1, 1,  1, 1, false, false, false, false }, // R8_SSCALED
+        { 1, 1,  1, 1, false, false, false, false }, // R8_UINT
+        { 1, 1,  1, 1, false, false, false, false }, // R8_SINT
+        { 1, 1,  1, 1,  true, false, false, false }, // R8_SRGB
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_UNORM
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_SNORM
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_USCALED
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_SSCALED
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_UINT
+        { 1, 1,  2, 2, false, false, false, false }, // R8G8_SINT
+        { 1, 1,  2, 2,  true, false, false, false }, // R8G8_SRGB
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_UNORM
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_SNORM
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_USCALED
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_SSCALED
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_UINT
+        { 1, 1,  3, 3, false, false, false, false }, // R8G8B8_SINT
+        { 1, 1,  3, 3,  true, false, false, false }, // R8G8B8_SRGB
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_UNORM
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_SNORM
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_USCALED
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_SSCALED
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_UINT
+        { 1, 1,  3, 3, false, false, false, false }, // B8G8R8_SINT
+        { 1, 1,  3, 3,  true, false, false, false }, // B8G8R8_SRGB
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_UNORM
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_SNORM
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_USCALED
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_SSCALED
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_UINT
+        { 1, 1,  4, 4, false, false, false, false }, // R8G8B8A8_SINT
+        { 1, 1,  4, 4,  true, false, false, false }, // R8G8B8A8_SRGB
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_UNORM
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_SNORM
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_USCALED
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_SSCALED
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_UINT
+        { 1, 1,  4, 4, false, false, false, false }, // B8G8R8A8_SINT
+        { 1, 1,  4, 4,  true, false, false, false }, // B8G8R8A8_SRGB
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_UNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_SNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_USCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_SSCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_UINT_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A8B8G8R8_SINT_PACK32
+        { 1, 1,  4, 4,  true, false, false, false }, // A8B8G8R8_SRGB_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_UNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_SNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_USCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_SSCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_UINT_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2R10G10B10_SINT_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_UNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_SNORM_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_USCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_SSCALED_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_UINT_PACK32
+        { 1, 1,  4, 4, false, false, false, false }, // A2B10G10R10_SINT_PACK32
+        { 1, 1,  2, 1, false, false, false, false }, // R16_UNORM
+        { 1, 1,  2, 1, false, false, false, false }, // R16_SNORM
+        { 1, 1,  2, 1, false, false, false, false }, // R16_USCALED
+        { 1, 1,  2, 1, false, false, false, false }, // R16_SSCALED
+        { 1, 1,  2, 1, false, false, false, false }, // R16_UINT
+        { 1, 1,  2, 1, false, false, false, false }, // R16_SINT
+        { 1, 1,  2, 1, false, false, false, false }, // R16_SFLOAT
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_UNORM
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_SNORM
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_USCALED
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_SSCALED
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_UINT
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_SINT
+        { 1, 1,  4, 2, false, false, false, false }, // R16G16_SFLOAT
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_UNORM
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_SNORM
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_USCALED
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_SSCALED
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_UINT
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_SINT
+        { 1, 1,  6, 3, false, false, false, false }, // R16G16B16_SFLOAT
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_UNORM
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_SNORM
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_USCALED
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_SSCALED
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_UINT
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_SINT
+        { 1, 1,  8, 4, false, false, false, false }, // R16G16B16A16_SFLOAT
+        { 1, 1,  4, 1, false, false, false, false }, // R32_UINT
+        { 1, 1,  4, 1, false, false, false, false }, // R32_SINT
+        { 1, 1,  4, 1, false, false, false, false }, // R32_SFLOAT
+        { 1, 1,  8, 2, false, false, false, false }, // R32G32_UINT
+        { 1, 1,  8, 2, false, false, false, false }, // R32G32_SINT
+        { 1, 1,  8, 2, false, false, false, false }, // R32G32_SFLOAT
+        { 1, 1, 12, 3, false, false, false, false }, // R32G32B32_UINT
+        { 1, 1, 12, 3, false, false, false, false }, // R32G32B32_SINT
+        { 1, 1, 12, 3, false, false, false, false }, // R32G32B32_SFLOAT
+        { 1, 1, 16, 4, false, false, false, false }, // R32G32B32A32_UINT
+        { 1, 1, 16, 4, false, false, false, false }, // R32G32B32A32_SINT
+        { 1, 1, 16, 4, false, false, false, false }, // R32G32B32A32_SFLOAT
+        { 1, 1,  8, 1, false, false, false, false }, // R64_UINT
+        { 1, 1,  8, 1, false, false, false, false }, // R64_SINT
+        { 1, 1,  8, 1, false, false, false, false }, // R64_SFLOAT
+        { 1, 1, 16, 2, false, false, false, false }, // R64G64_UINT
+        { 1, 1, 16, 2, false, false, false, false }, // R64G64_SINT
+        { 1, 1, 16, 2, false, false, false, false }, // R64G64_SFLOAT
+        { 1, 1, 24, 3, false, false, false, false }, // R64G64B64_UINT
+        { 1, 1, 24, 3, false, false, false, false }, // R64G64B64_SINT
+        { 1, 1, 24, 3, false, false, false, false }, // R64G64B64_SFLOAT
+        { 1, 1, 32, 4, false, false, false, false }, // R64G64B64A64_UINT
+        { 1, 1, 32, 4, false, false, false, false }, // R64G64B64A64_SINT
+        { 1, 1, 32, 4, false, false, false, false }, // R64G64B64A64_SFLOAT
+        { 1, 1,  4, 3, false, false, false, false }, // B10G11R11_UFLOAT_PACK32
+        { 1, 1,  4, 3, false, false, false, false }, // E5B9G9R9_UFLOAT_PACK32
+        { 1, 1,  2, 1, false,  true, false, false }, // D16_UNORM
+        { 1, 1,  4, 1, false,  true, false, false }, // X8_D24_UNORM_PACK32
+        { 1, 1,  4, 1, false,  true, false, false }, // D32_SFLOAT
+        { 1, 1,  1, 1, false, false,  true, false }, // S8_UINT
+        { 1, 1,  3, 2, false,  true,  true, false }, // D16_UNORM_S8_UINT
+        { 1, 1,  4, 2, false,  true,  true, false }, // D24_UNORM_S8_UINT
+        { 1, 1,  5, 2, false,  true,  true, false }, // D32_SFLOAT_S8_UINT
+        { 4, 4,  8, 3, false, false, false,  true }, // BC1_RGB_UNORM_BLOCK
+        { 4, 4,  8, 3,  true, false, false,  true }, // BC1_RGB_SRGB_BLOCK
+        { 4, 4,  8, 4, false, false, false,  true }, // BC1_RGBA_UNORM_BLOCK
+        { 4, 4,  8, 4,  true, false, false,  true }, // BC1_RGBA_SRGB_BLOCK
+        { 4, 4, 16, 4, false, false, false,  true }, // BC2_UNORM_BLOCK
+        { 4, 4, 16, 4,  true, false, false,  true }, // BC2_SRGB_BLOCK
+        { 4, 4, 16, 4, false, false, false,  true }, // BC3_UNORM_BLOCK
+        { 4, 4, 16, 4,  true, false, false,  true }, // BC3_SRGB_BLOCK
+        { 4, 4,  8, 1, false, false, false,  true }, // BC4_UNORM_BLOCK
+        { 4, 4,  8, 1, false, false, false,  true }, // BC4_SNORM_BLOCK
+        { 4, 4, 16, 2, false, false, false,  true }, // BC5_UNORM_BLOCK
+        { 4, 4, 16, 2, false, false, false,  true }, // BC5_SNORM_BLOCK
+        { 4, 4, 16, 3, false, false, false,  true }, // BC6H_UFLOAT_BLOCK
+        { 4, 4, 16, 3, false, false, false,  true }, // BC6H_SFLOAT_BLOCK
+        { 4, 4, 16, 4, false, false, false,  true }, // BC7_UNORM_BLOCK
+        { 4, 4, 16, 4,  true, false, false,  true }, // BC7_SRGB_BLOCK
+    };
+
+    inline constexpr size_t FORMAT_COUNT = sizeof(FORMAT_INFOS) / sizeof(FORMAT_INFOS[0]);
+    static_assert(FORMAT_COUNT == static_cast<size_t>(Format::BC7_SRGB_BLOCK) + 1, "every format needs an entry in FORMAT_INFOS");
+
+    // values outside the enum get the empty entry of UNKNOWN
+    constexpr const FormatInfo& GetFormatInfo(Format format)
+    {
+        return static_cast<size_t>(format) < FORMAT_COUNT ? FORMAT_INFOS[static_cast<size_t>(format)] : FORMAT_INFOS[0];
+    }
+
+    // bytes of one texel, or of one 4x4 block for block compressed formats. 0 for UNKNOWN
+    constexpr uint32_t GetPixelByteSize(Format format)
+    {
+        return GetFormatInfo(format).BlockByteSize;
+    }
+
+    constexpr bool IsBlockCompressedFormat(Format format)
+    {
+        return GetFormatInfo(format).IsCompressed;
+    }
+
+    constexpr bool IsSRGBFormat(Format format)
+    {
+        return GetFormatInfo(format).IsSRGB;
+    }
+
+    constexpr bool IsDepthFormat(Format format)
+    {
+        return GetFormatInfo(format).HasDepth;
+    }
+
+    constexpr bool IsStencilFormat(Format format)
+    {
+        return GetFormatInfo(format).HasStencil;
+    }
+
+    // bytes of one tightly packed row of texel blocks, partial blocks at the edge count as whole ones
+    constexpr size_t GetImageRowPitch(Format format, uint32_t width)
+    {
+        const FormatInfo& info = GetFormatInfo(format);
+        return size_t((width + info.BlockWidth - 1) / info.BlockWidth) * info.BlockByteSize;
+    }
+
+    // rows of texel blocks in one slice
+    constexpr uint32_t GetImageRowCount(Format format, uint32_t height)
+    {
+        const FormatInfo& info = GetFormatInfo(format);
+        return (height + info.BlockHeight - 1) / info.BlockHeight;
+    }
+
+    // bytes of one mip of one layer
+    constexpr size_t GetImageByteSize(Format format, uint32_t width, uint32_t height, uint32_t depth = 1)
+    {
+        return GetImageRowPitch(format, width) * GetImageRowCount(format, height) * depth;
+    }
+
+    // UNORM format with the same layout as an sRGB format, other formats are returned unchanged
+    Format GetLinearFormat(Format format);
+
+    // IEEE 754 binary16, rounds to nearest even
+    uint16_t FloatToHalf(float value);
+    float HalfToFloat(uint16_t value);
+    int16_t FloatToSnorm16(float value);
+    float Snorm16ToFloat(int16_t value);
+    // B10G11R11_UFLOAT_PACK32 with red in the low bits, rounds to nearest even. Negative values and NaN become 0,
+    // values above the largest finite one are clamped to it
+    uint32_t FloatToR11G11B10(float red, float green, float blue);
+    void R11G11B10ToFloat(uint32_t value, float& red, float& green, float& blue);
+
+    // bulk conversions for image data, the SIMD kernels are selected at runtime and match the scalar conversions above bit for bit
+    // apart from NaN payloads. AVX2 level CPUs convert halfs with F16C
+    void ConvertFloatToHalf(const float* source, uint16_t* target, size_t count, bool useSIMD = true);
+    // RGBA source texels, alpha is dropped
+    void ConvertFloatToR11G11B10(const float* source, uint32_t* target, size_t texelCount, bool useSIMD = true);
+    // appends an opaque alpha to RGB texels with 1 (UNORM / SRGB), 2 (half float) or 4 (float) bytes per channel
+    void ExpandRGBToRGBA(const uint8_t* source, uint8_t* target, size_t texelCount, uint32_t channelByteSize, bool useSIMD = true);
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "FormatSupport.h"
+#include "BlockCompression.h"
+#include "ThreadPool.h"
+#include "Utilities.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace VALX
+{
+    // rows of texels or texel blocks converted by one thread pool task
+    constexpr uint32_t CONVERSION_ROWS_PER_TASK = 64;
+
+    FormatFeatures GetRequiredFormatFeatures(TextureFlags flags)
+    {
+        FormatFeatures result = FormatFeatures::NONE;
+        if (static_cast<bool>(flags & TextureFlags::COPY_SRC))
+            result |= FormatFeatures::COPY_SRC;
+        if (static_cast<bool>(flags & TextureFlags::COPY_DST))
+            result |= FormatFeatures::COPY_DST;
+        if (static_cast<bool>(flags & TextureFlags::SAMPLED))
+            result |= FormatFeatures::SAMPLED;
+        if (static_cast<bool>(flags & TextureFlags::STORAGE))
+            result |= FormatFeatures::STORAGE;
+        if (static_cast<bool>(flags & TextureFlags::COLOR_ATTACHMENT))
+            result |= FormatFeatures::COLOR_ATTACHMENT;
+        if (static_cast<bool>(flags & TextureFlags::DEPTH_STENCIL_ATTACHMENT))
+            result |= FormatFeatures::DEPTH_STENCIL_ATTACHMENT;
+        // blits or the compute downsampler fill the mips, storage usage is only added when the downsampler can write the format
+        if (static_cast<bool>(flags & TextureFlags::GENERATE_MIPS))
+            result |= FormatFeatures::COPY_SRC | FormatFeatures::COPY_DST | FormatFeatures::SAMPLED;
+        return result;
+    }
+
+    Format GetFallbackFormat(Format format)
+    {
+        switch (format)
+        {
+        case Format::R8G8B8_UNORM:
+            return Format::R8G8B8A8_UNORM;
+        case Format::R8G8B8_SRGB:
+            return Format::R8G8B8A8_SRGB;
+        case Format::B8G8R8_UNORM:
+            return Format::B8G8R8A8_UNORM;
+        case Format::B8G8R8_SRGB:
+            return Format::B8G8R8A8_SRGB;
+        case Format::R16G16B16_SFLOAT:
+            return Format::R16G16B16A16_SFLOAT;
+        case Format::R32G32B32_SFLOAT:
+            return Format::R32G32B32A32_SFLOAT;
+        default:
+            if (IsBlockDecodeSupported(format))
+                return IsSRGBFormat(format) ? Format::R8G8B8A8_SRGB : Format::R8G8B8A8_UNORM;
+            return Format::UNKNOWN;
+        }
+    }
+
+    // a run of rows inside one subresource, rows are texel block rows of every depth slice one after another
+    struct ConversionTask
+    {
+        size_t Subresource = 0;
+        uint32_t FirstRow = 0;
+        uint32_t RowCount = 0;
+    };
+
+    static void ExpandRows(const ConversionTask& task, const TextureSubresource& source, const TextureSubresource& target, uint32_t channelByteSize,
+        const uint8_t* sourceBytes, uint8_t* targetBytes)
+    {
+        const size_t firstTexel = size_t(task.FirstRow) * source.Width;
+        ExpandRGBToRGBA(sourceBytes + source.Offset + firstTexel * 3 * channelByteSize, targetBytes + target.Offset + firstTexel * 4 * channelByteSize,
+            size_t(task.RowCount) * source.Width, channelByteSize);
+    }
+
+    static void DecodeBlockRows(const ConversionTask& task, Format sourceFormat, const TextureSubresource& source, const TextureSubresource& target,
+        const uint8_t* sourceBytes, uint8_t* targetBytes)
+    {
+        const uint32_t blockCountX = (source.Width + 3) / 4;
+        const uint32_t blockCountY = (source.Height + 3) / 4;
+        const size_t blockByteSize = GetPixelByteSize(sourceFormat);
+        const size_t targetRowPitch = size_t(target.Width) * 4;
+
+        uint8_t pixels[16 * 4];
+        for (uint32_t row = task.FirstRow; row < task.FirstRow + task.RowCount; row++)
+        {
+            const uint32_t slice = row / blockCountY;
+            const uint32_t blockY = row % blockCountY;
+            const uint8_t* block = sourceBytes + source.Offset + size_t(row) * blockCountX * blockByteSize;
+            uint8_t* targetSlice = targetBytes + target.Offset + size_t(slice) * target.Height * targetRowPitch;
+
+            // blocks of mips smaller than 4 texels are cut to the mip size
+            const uint32_t pixelRows = std::min(4u, source.Height - 4 * blockY);
+            for (uint32_t blockX = 0; blockX < blockCountX; blockX++, block += blockByteSize)
+            {
+                DecodeBlock(block, sourceFormat, pixels);
+                const uint32_t pixelColumns = std::min(4u, source.Width - 4 * blockX);
+                for (uint32_t y = 0; y < pixelRows; y++)
+                    std::memcpy(targetSlice + (4 * blockY + y) * targetRowPitch + 4 * blockX * 4, pixels + 16 * y, 4 * pixelColumns);
+            }
+        }
+    }
+
+    void ConvertTextureSubresources(Format sourceFormat, const uint8_t* sourceBytes, const std::vector<TextureSubresource>& sourceSubresources,
+        Format targetFormat, uint8_t* targetBytes, const std::vector<TextureSubresource>& targetSubresources)
+    {
+        VALX_ASSERT(GetFallbackFormat(sourceFormat) == targetFormat && "formats can only be converted to their fallback");
+        VALX_ASSERT(sourceSubresources.size() == targetSubresources.size());
+
+        std::vector<ConversionTask> tasks;
+        for (size_t i = 0; i < sourceSubresources.size(); i++)
+        {
+            const TextureSubresource& source = sourceSubresources[i];
+            uint32_t rowCount = GetImageRowCount(sourceFormat, source.Height) * std::max(source.Depth, 1u);
+            for (uint32_t row = 0; row < rowCount; row += CONVERSION_ROWS_PER_TASK)
+                tasks.push_back(ConversionTask{ i, row, std::min(CONVERSION_ROWS_PER_TASK, rowCount - row) });
+        }
+
+        const bool isBlockCompressed = IsBlockCompressedFormat(sourceFormat);
+        const uint32_t channelByteSize = isBlockCompressed ? 0 : GetPixelByteSize(sourceFormat) / 3;
+        GetThreadPool()->ParallelFor(tasks.size(), [&](size_t index)
+        {
+            const ConversionTask& task = tasks[index];
+            const TextureSubresource& source = sourceSubresources[task.Subresource];
+            const TextureSubresource& target = targetSubresources[task.Subresource];
+            VALX_ASSERT(source.Width == target.Width && source.Height == target.Height && source.Depth == target.Depth);
+            if (isBlockCompressed)
+                DecodeBlockRows(task, sourceFormat, source, target, sourceBytes, targetBytes);
+            else
+                ExpandRows(task, source, target, channelByteSize, sourceBytes, targetBytes);
+        });
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Format.h"
+#include "Texture.h"
+
+#include <vector>
+
+namespace VALX
+{
+    enum class FormatFeatures
+    {
+        NONE = 0,
+        SAMPLED = 1 << 0,
+        SAMPLED_LINEAR_FILTER = 1 << 1,
+        STORAGE = 1 << 2,
+        COLOR_ATTACHMENT = 1 << 3,
+        COLOR_ATTACHMENT_BLEND = 1 << 4,
+        DEPTH_STENCIL_ATTACHMENT = 1 << 5,
+        BLIT_SRC = 1 << 6,
+        BLIT_DST = 1 << 7,
+        COPY_SRC = 1 << 8,
+        COPY_DST = 1 << 9,
+    };
+    VALX_GENERATE_ENUM_OPS(FormatFeatures)
+
+    // what the device supports for images of a format, per tiling
+    struct FormatCapabilities
+    {
+        FormatFeatures OptimalTiling = FormatFeatures::NONE;
+        FormatFeatures LinearTiling = FormatFeatures::NONE;
+
+        bool Supports(FormatFeatures features) const { return (this->OptimalTiling & features) == features; }
+    };
+
+    // features an optimally tiled texture with these flags needs from its format
+    FormatFeatures GetRequiredFormatFeatures(TextureFlags flags);
+
+    // format the CPU converts texture data to when the device does not support its own, UNKNOWN if there is none.
+    // RGB formats gain an opaque alpha, BC1 to BC5 are decoded to RGBA8 in the same color space
+    Format GetFallbackFormat(Format format);
+
+    // converts every subresource to the fallback format on the thread pool. Source subresources are read at their offsets from
+    // sourceBytes, target ones are written at the offsets of the target table, which has to describe the same layers and mips
+    void ConvertTextureSubresources(Format sourceFormat, const uint8_t* sourceBytes, const std::vector<TextureSubresource>& sourceSubresources,
+        Format targetFormat, uint8_t* targetBytes, const std::vector<TextureSubresource>& targetSubresources);
+}
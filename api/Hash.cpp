@@ -0,0 +1,107 @@
+#include "Hash.h"
+
+#include <cstring>
+
+namespace VALX
+{
+    static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t RotateLeft(uint64_t value, uint32_t count)
+    {
+        return (value << count) | (value >> (64 - count));
+    }
+
+    // memcpy keeps unaligned reads defined, the hash is specified on little endian input
+    static uint64_t Read64(const uint8_t* data)
+    {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static uint32_t Read32(const uint8_t* data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME64_2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * PRIME64_1;
+    }
+
+    static uint64_t MergeRound(uint64_t accumulator, uint64_t value)
+    {
+        accumulator ^= Round(0, value);
+        return accumulator * PRIME64_1 + PRIME64_4;
+    }
+
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+    {
+        const uint8_t* current = static_cast<const uint8_t*>(data);
+        const uint8_t* end = current + size;
+        uint64_t hash = 0;
+
+        if (size >= 32)
+        {
+            // four independent lanes over 32 byte stripes
+            uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+            uint64_t v2 = seed + PRIME64_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME64_1;
+            const uint8_t* limit = end - 32;
+            do
+            {
+                v1 = Round(v1, Read64(current + 0));
+                v2 = Round(v2, Read64(current + 8));
+                v3 = Round(v3, Read64(current + 16));
+                v4 = Round(v4, Read64(current + 24));
+                current += 32;
+            } while (current <= limit);
+
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        }
+        else
+        {
+            hash = seed + PRIME64_5;
+        }
+
+        hash += static_cast<uint64_t>(size);
+
+        for (; current + 8 <= end; current += 8)
+        {
+            hash ^= Round(0, Read64(current));
+            hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+        }
+        if (current + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(Read32(current)) * PRIME64_1;
+            hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+            current += 4;
+        }
+        for (; current < end; current++)
+        {
+            hash ^= (*current) * PRIME64_5;
+            hash = RotateLeft(hash, 11) * PRIME64_1;
+        }
+
+        // final avalanche
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
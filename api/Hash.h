@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 
 namespace VALX
 {
@@ -10,4 +11,7 @@ namespace VALX
     {
         seed ^= std::hash<T>{}(other)+0x9e3779b9 + (seed << 6) + (seed >> 2);
     }
-}
\ No newline at end of file
+
+    // 64 bit XXH64 compatible hash, stable across platforms and runs, so it can key data stored on disk
+    uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+}
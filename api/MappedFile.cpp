@@ -0,0 +1,173 @@
+#include "MappedFile.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include <fmt/format.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace VALX
+{
+    MappedFile::MappedFile(const std::string& filepath)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return;
+        }
+
+        this->fileHandle = file;
+        this->mappingHandle = mapping;
+        this->data = static_cast<const uint8_t*>(view);
+        this->size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int file = open(filepath.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat fileStat = {};
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            close(file);
+            return;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED)
+            return;
+
+        this->data = static_cast<const uint8_t*>(view);
+        this->size = static_cast<size_t>(fileStat.st_size);
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        this->Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->Close();
+            std::swap(this->data, other.data);
+            std::swap(this->size, other.size);
+#if defined(_WIN32)
+            std::swap(this->fileHandle, other.fileHandle);
+            std::swap(this->mappingHandle, other.mappingHandle);
+#endif
+        }
+        return *this;
+    }
+
+    void MappedFile::Close()
+    {
+        if (this->data == nullptr)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(this->data);
+        CloseHandle(this->mappingHandle);
+        CloseHandle(this->fileHandle);
+        this->mappingHandle = nullptr;
+        this->fileHandle = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(this->data), this->size);
+#endif
+        this->data = nullptr;
+        this->size = 0;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return this->data != nullptr;
+    }
+
+    const uint8_t* MappedFile::GetData() const
+    {
+        return this->data;
+    }
+
+    size_t MappedFile::GetSize() const
+    {
+        return this->size;
+    }
+
+    static std::string GetTemporaryFilePath(const std::string& filepath)
+    {
+        static const uint64_t processToken = (uint64_t(std::random_device{}()) << 32) ^
+            uint64_t(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        return filepath + fmt::format(".{:016x}.{:x}.tmp", processToken, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    }
+
+    bool WriteFileAtomically(const std::string& filepath, const std::vector<FileWriteRange>& ranges)
+    {
+        std::string temporaryPath = GetTemporaryFilePath(filepath);
+        bool written = false;
+        {
+            std::ofstream file(temporaryPath, std::ofstream::binary | std::ofstream::trunc);
+            for (const FileWriteRange& range : ranges)
+            {
+                if (!file.good())
+                    break;
+                file.write(static_cast<const char*>(range.Data), range.Size);
+            }
+            file.flush();
+            written = file.good();
+        }
+
+        std::error_code error;
+        if (written)
+            std::filesystem::rename(temporaryPath, filepath, error);
+        if (!written || error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Utilities.h"
+
+namespace VALX
+{
+    // read-only view of a whole file mapped into the address space, pages are loaded on first access
+    class MappedFile
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+        void Close();
+
+    public:
+        MappedFile() = default;
+        MappedFile(const std::string& filepath);
+        ~MappedFile();
+        VALX_NO_COPY(MappedFile);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool IsOpen() const;
+        const uint8_t* GetData() const;
+        size_t GetSize() const;
+    };
+
+    struct FileWriteRange
+    {
+        const void* Data = nullptr;
+        size_t Size = 0;
+    };
+
+    // writes the ranges one after another under a temporary name unique per process and thread and renames the result to filepath,
+    // so concurrent readers, also of other processes, never see a partial file. Nothing is left behind if a step fails
+    bool WriteFileAtomically(const std::string& filepath, const std::vector<FileWriteRange>& ranges);
+}
@@ -0,0 +1,1032 @@
+#include "MeshLoader.h"
+#include "Utilities.h"
+#include "Hash.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <map>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+#include <tiny_gltf.h>
+
+namespace VALX
+{
+    static bool IsOBJMesh(const std::string& filepath)
+    {
+        return std::filesystem::path(filepath).extension() == ".obj";
+    }
+
+    static bool IsGLTFMesh(const std::string& filepath)
+    {
+        return std::filesystem::path(filepath).extension() == ".gltf";
+    }
+
+    static bool IsGLBMesh(const std::string& filepath)
+    {
+        return std::filesystem::path(filepath).extension() == ".glb";
+    }
+
+    static void ComputeBounds(const MeshData& mesh, SubMeshData& subMesh)
+    {
+        if (subMesh.VertexCount == 0)
+            return;
+
+        subMesh.BoundsMin = mesh.Vertices[subMesh.VertexOffset].Position;
+        subMesh.BoundsMax = mesh.Vertices[subMesh.VertexOffset].Position;
+        for (uint32_t i = 0; i < subMesh.VertexCount; i++)
+        {
+            const glm::vec3& position = mesh.Vertices[subMesh.VertexOffset + i].Position;
+            subMesh.BoundsMin = glm::min(subMesh.BoundsMin, position);
+            subMesh.BoundsMax = glm::max(subMesh.BoundsMax, position);
+        }
+    }
+
+    struct OBJIndex
+    {
+        int Position = -1;
+        int Normal = -1;
+        int TexCoord = -1;
+    };
+
+    struct OBJIndexHash
+    {
+        size_t operator()(const OBJIndex& index) const
+        {
+            size_t hash = 0;
+            HashCombine(hash, index.Position);
+            HashCombine(hash, index.Normal);
+            HashCombine(hash, index.TexCoord);
+            return hash;
+        }
+    };
+
+    struct OBJIndexEqual
+    {
+        bool operator()(const OBJIndex& i1, const OBJIndex& i2) const
+        {
+            return i1.Position == i2.Position && i1.Normal == i2.Normal && i1.TexCoord == i2.TexCoord;
+        }
+    };
+
+    struct OBJShapeData
+    {
+        std::vector<Vertex> Vertices;
+        std::vector<uint32_t> Indices;
+    };
+
+    // the file is cut into chunks at line ends, chunks are counted and parsed in parallel
+    static constexpr size_t OBJ_CHUNK_SIZE = 1 << 20;
+
+    struct OBJAttributes
+    {
+        std::vector<float> Positions;
+        std::vector<float> Normals;
+        std::vector<float> TexCoords;
+    };
+
+    enum class OBJEventType
+    {
+        SHAPE,
+        MATERIAL,
+    };
+
+    // `o`, `g` and `usemtl` lines, applied in order to the corners which follow them
+    struct OBJEvent
+    {
+        OBJEventType Type = OBJEventType::SHAPE;
+        std::string Name;
+        size_t CornerOffset = 0;
+    };
+
+    struct OBJChunk
+    {
+        const char* Begin = nullptr;
+        const char* End = nullptr;
+        uint32_t PositionOffset = 0;
+        uint32_t NormalOffset = 0;
+        uint32_t TexCoordOffset = 0;
+        uint32_t PositionCount = 0;
+        uint32_t NormalCount = 0;
+        uint32_t TexCoordCount = 0;
+        // triangulated faces, indices are already resolved to zero based global ones
+        std::vector<OBJIndex> Corners;
+        std::vector<OBJEvent> Events;
+        std::vector<std::string> MaterialLibraries;
+        std::string Error;
+    };
+
+    // corners of a shape stay in the chunks they were parsed into, so a shape is a list of corner ranges
+    struct OBJShape
+    {
+        std::string Name;
+        int MaterialId = -1;
+        size_t CornerCount = 0;
+        std::vector<std::pair<const OBJIndex*, size_t>> Spans;
+    };
+
+    static const char* SkipOBJSpaces(const char* begin, const char* end)
+    {
+        while (begin < end && (*begin == ' ' || *begin == '\t'))
+            begin++;
+        return begin;
+    }
+
+    static const char* GetOBJLineEnd(const char* begin, const char* end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        return lineEnd != nullptr ? lineEnd : end;
+    }
+
+    static bool IsOBJKeyword(const char* begin, const char* end, const char* keyword)
+    {
+        size_t length = std::strlen(keyword);
+        if (size_t(end - begin) < length || std::memcmp(begin, keyword, length) != 0)
+            return false;
+        return begin + length == end || begin[length] == ' ' || begin[length] == '\t';
+    }
+
+    static std::string GetOBJLineArgument(const char* begin, const char* end)
+    {
+        begin = SkipOBJSpaces(begin, end);
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+            end--;
+        return std::string(begin, end);
+    }
+
+    static const char* ParseOBJFloats(const char* begin, const char* end, float* values, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            begin = SkipOBJSpaces(begin, end);
+            if (begin < end && *begin == '+')
+                begin++;
+            std::from_chars_result result = std::from_chars(begin, end, values[i]);
+            if (result.ec != std::errc())
+                return begin;
+            begin = result.ptr;
+        }
+        return begin;
+    }
+
+    // one based indices count from the start of the file, negative ones back from the current element
+    static bool ResolveOBJIndex(int index, uint32_t countSoFar, uint32_t totalCount, int& result)
+    {
+        int64_t resolved = index > 0 ? int64_t(index) - 1 : int64_t(countSoFar) + index;
+        if (index == 0 || resolved < 0 || resolved >= int64_t(totalCount))
+            return false;
+        result = static_cast<int>(resolved);
+        return true;
+    }
+
+    static void CountOBJChunk(OBJChunk& chunk)
+    {
+        for (const char* line = chunk.Begin; line < chunk.End;)
+        {
+            const char* lineEnd = GetOBJLineEnd(line, chunk.End);
+            const char* token = SkipOBJSpaces(line, lineEnd);
+            if (IsOBJKeyword(token, lineEnd, "v"))
+                chunk.PositionCount++;
+            else if (IsOBJKeyword(token, lineEnd, "vn"))
+                chunk.NormalCount++;
+            else if (IsOBJKeyword(token, lineEnd, "vt"))
+                chunk.TexCoordCount++;
+            line = lineEnd + 1;
+        }
+    }
+
+    static void ParseOBJChunk(OBJChunk& chunk, OBJAttributes& attrib, uint32_t positionTotal, uint32_t normalTotal, uint32_t texCoordTotal)
+    {
+        uint32_t positionCount = chunk.PositionOffset;
+        uint32_t normalCount = chunk.NormalOffset;
+        uint32_t texCoordCount = chunk.TexCoordOffset;
+        std::vector<OBJIndex> face;
+        for (const char* line = chunk.Begin; line < chunk.End && chunk.Error.empty();)
+        {
+            const char* lineEnd = GetOBJLineEnd(line, chunk.End);
+            const char* token = SkipOBJSpaces(line, lineEnd);
+            line = lineEnd + 1;
+
+            if (IsOBJKeyword(token, lineEnd, "v"))
+            {
+                // optional w and vertex colors are ignored
+                ParseOBJFloats(token + 1, lineEnd, &attrib.Positions[3 * size_t(positionCount++)], 3);
+            }
+            else if (IsOBJKeyword(token, lineEnd, "vn"))
+            {
+                ParseOBJFloats(token + 2, lineEnd, &attrib.Normals[3 * size_t(normalCount++)], 3);
+            }
+            else if (IsOBJKeyword(token, lineEnd, "vt"))
+            {
+                ParseOBJFloats(token + 2, lineEnd, &attrib.TexCoords[2 * size_t(texCoordCount++)], 2);
+            }
+            else if (IsOBJKeyword(token, lineEnd, "f"))
+            {
+                face.clear();
+                for (const char* corner = SkipOBJSpaces(token + 1, lineEnd); corner < lineEnd && *corner != '\r'; corner = SkipOBJSpaces(corner, lineEnd))
+                {
+                    // v, v/t, v//n or v/t/n
+                    int values[3] = { 0, 0, 0 };
+                    for (int component = 0; component < 3; component++)
+                    {
+                        std::from_chars_result result = std::from_chars(corner, lineEnd, values[component]);
+                        if (result.ec == std::errc())
+                            corner = result.ptr;
+                        if (corner == lineEnd || *corner != '/')
+                            break;
+                        corner++;
+                    }
+
+                    OBJIndex index;
+                    bool isValid = ResolveOBJIndex(values[0], positionCount, positionTotal, index.Position);
+                    if (values[1] != 0)
+                        isValid &= ResolveOBJIndex(values[1], texCoordCount, texCoordTotal, index.TexCoord);
+                    if (values[2] != 0)
+                        isValid &= ResolveOBJIndex(values[2], normalCount, normalTotal, index.Normal);
+                    if (!isValid)
+                    {
+                        chunk.Error = fmt::format("face `{}` references an element which does not exist", GetOBJLineArgument(token + 1, lineEnd));
+                        break;
+                    }
+                    face.push_back(index);
+
+                    while (corner < lineEnd && *corner != ' ' && *corner != '\t' && *corner != '\r')
+                        corner++;
+                }
+
+                // polygons are triangulated as a fan, lines and points are skipped
+                for (size_t i = 1; i + 1 < face.size(); i++)
+                {
+                    chunk.Corners.push_back(face[0]);
+                    chunk.Corners.push_back(face[i]);
+                    chunk.Corners.push_back(face[i + 1]);
+                }
+            }
+            else if (IsOBJKeyword(token, lineEnd, "o") || IsOBJKeyword(token, lineEnd, "g"))
+            {
+                chunk.Events.push_back(OBJEvent{ OBJEventType::SHAPE, GetOBJLineArgument(token + 1, lineEnd), chunk.Corners.size() });
+            }
+            else if (IsOBJKeyword(token, lineEnd, "usemtl"))
+            {
+                chunk.Events.push_back(OBJEvent{ OBJEventType::MATERIAL, GetOBJLineArgument(token + 6, lineEnd), chunk.Corners.size() });
+            }
+            else if (IsOBJKeyword(token, lineEnd, "mtllib"))
+            {
+                chunk.MaterialLibraries.push_back(GetOBJLineArgument(token + 6, lineEnd));
+            }
+        }
+    }
+
+    static std::vector<OBJChunk> SplitOBJFile(const char* data, size_t size)
+    {
+        std::vector<OBJChunk> chunks;
+        const char* end = data + size;
+        for (const char* begin = data; begin < end;)
+        {
+            const char* chunkEnd = begin + std::min(OBJ_CHUNK_SIZE, size_t(end - begin));
+            chunkEnd = chunkEnd < end ? GetOBJLineEnd(chunkEnd, end) : end;
+
+            OBJChunk& chunk = chunks.emplace_back();
+            chunk.Begin = begin;
+            chunk.End = chunkEnd;
+            begin = chunkEnd < end ? chunkEnd + 1 : end;
+        }
+        return chunks;
+    }
+
+    static void LoadOBJMaterialLibraries(const std::string& filepath, const std::vector<OBJChunk>& chunks, std::map<std::string, int>& materialIds)
+    {
+        std::vector<tinyobj::material_t> materials;
+        std::filesystem::path searchPath = std::filesystem::path(filepath).parent_path();
+        for (const OBJChunk& chunk : chunks)
+        {
+            for (const std::string& library : chunk.MaterialLibraries)
+            {
+                std::ifstream file(searchPath / library);
+                if (!file.good())
+                {
+                    GetCurrentLogger()->LogWarning("MeshLoader", fmt::format("material library `{}` of `{}` not found", library, filepath));
+                    continue;
+                }
+
+                std::string warning;
+                std::string error;
+                tinyobj::LoadMtl(&materialIds, &materials, &file, &warning, &error);
+                if (!warning.empty())
+                    GetCurrentLogger()->LogWarning("MeshLoader", warning);
+                if (!error.empty())
+                    GetCurrentLogger()->LogWarning("MeshLoader", error);
+            }
+        }
+    }
+
+    static std::vector<OBJShape> CollectOBJShapes(const std::vector<OBJChunk>& chunks, const std::map<std::string, int>& materialIds)
+    {
+        std::vector<OBJShape> shapes(1);
+        int materialId = -1;
+        auto addSpan = [&shapes, &materialId](const OBJIndex* corners, size_t count)
+        {
+            if (count == 0)
+                return;
+            OBJShape& shape = shapes.back();
+            if (shape.CornerCount == 0)
+                shape.MaterialId = materialId;
+            shape.Spans.emplace_back(corners, count);
+            shape.CornerCount += count;
+        };
+
+        for (const OBJChunk& chunk : chunks)
+        {
+            size_t cornerOffset = 0;
+            for (const OBJEvent& event : chunk.Events)
+            {
+                addSpan(chunk.Corners.data() + cornerOffset, event.CornerOffset - cornerOffset);
+                cornerOffset = event.CornerOffset;
+
+                if (event.Type == OBJEventType::SHAPE)
+                {
+                    if (shapes.back().CornerCount > 0)
+                        shapes.emplace_back();
+                    shapes.back().Name = event.Name;
+                }
+                else
+                {
+                    // a submesh has one material, so a switch after the first faces splits the shape under the same name
+                    auto it = materialIds.find(event.Name);
+                    materialId = it != materialIds.end() ? it->second : -1;
+                    if (shapes.back().CornerCount > 0 && shapes.back().MaterialId != materialId)
+                    {
+                        std::string name = shapes.back().Name;
+                        shapes.emplace_back().Name = std::move(name);
+                    }
+                }
+            }
+            addSpan(chunk.Corners.data() + cornerOffset, chunk.Corners.size() - cornerOffset);
+        }
+
+        if (shapes.back().CornerCount == 0)
+            shapes.pop_back();
+        return shapes;
+    }
+
+    static OBJShapeData DeduplicateOBJShape(const OBJAttributes& attrib, const OBJShape& shape)
+    {
+        OBJShapeData result;
+        result.Indices.reserve(shape.CornerCount);
+
+        // vertices are deduplicated by their index triplet, so no floating point comparison is required
+        std::unordered_map<OBJIndex, uint32_t, OBJIndexHash, OBJIndexEqual> uniqueVertices;
+        uniqueVertices.reserve(shape.CornerCount);
+
+        std::vector<bool> hasNormal;
+        bool hasMissingNormals = false;
+        for (const auto& [corners, cornerCount] : shape.Spans)
+        {
+            for (size_t i = 0; i < cornerCount; i++)
+            {
+                const OBJIndex& index = corners[i];
+                auto it = uniqueVertices.find(index);
+                if (it != uniqueVertices.end())
+                {
+                    result.Indices.push_back(it->second);
+                    continue;
+                }
+
+                Vertex vertex;
+                vertex.Position = glm::vec3(
+                    attrib.Positions[3 * size_t(index.Position) + 0],
+                    attrib.Positions[3 * size_t(index.Position) + 1],
+                    attrib.Positions[3 * size_t(index.Position) + 2]
+                );
+                if (index.Normal >= 0)
+                {
+                    vertex.Normal = glm::vec3(
+                        attrib.Normals[3 * size_t(index.Normal) + 0],
+                        attrib.Normals[3 * size_t(index.Normal) + 1],
+                        attrib.Normals[3 * size_t(index.Normal) + 2]
+                    );
+                }
+                else
+                {
+                    hasMissingNormals = true;
+                }
+                if (index.TexCoord >= 0)
+                {
+                    vertex.TexCoord = glm::vec2(
+                        attrib.TexCoords[2 * size_t(index.TexCoord) + 0],
+                        attrib.TexCoords[2 * size_t(index.TexCoord) + 1]
+                    );
+                }
+
+                uint32_t vertexIndex = static_cast<uint32_t>(result.Vertices.size());
+                result.Vertices.push_back(vertex);
+                hasNormal.push_back(index.Normal >= 0);
+                uniqueVertices.emplace(index, vertexIndex);
+                result.Indices.push_back(vertexIndex);
+            }
+        }
+
+        if (hasMissingNormals)
+        {
+            // only corners without a normal get a generated one, the normals of the file are kept
+            std::vector<glm::vec3> normals(result.Vertices.size());
+            for (size_t i = 0; i < result.Vertices.size(); i++)
+                normals[i] = result.Vertices[i].Normal;
+
+            GenerateNormals(result.Vertices.data(), result.Vertices.size(), result.Indices.data(), result.Indices.size());
+            for (size_t i = 0; i < result.Vertices.size(); i++)
+            {
+                if (hasNormal[i])
+                    result.Vertices[i].Normal = normals[i];
+            }
+        }
+        // OBJ format has no tangent space, so it is always generated
+        GenerateTangents(result.Vertices.data(), result.Vertices.size(), result.Indices.data(), result.Indices.size());
+
+        return result;
+    }
+
+    static MeshData LoadMeshUsingOBJLoader(const std::string& filepath)
+    {
+        MappedFile file(filepath);
+        if (!file.IsOpen())
+        {
+            GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: file cannot be opened", filepath));
+            return MeshData{};
+        }
+
+        // element counts of the preceding chunks are needed to resolve indices, so lines are counted before they are parsed
+        std::vector<OBJChunk> chunks = SplitOBJFile(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+        GetThreadPool()->ParallelFor(chunks.size(), [&chunks](size_t chunkIndex)
+        {
+            CountOBJChunk(chunks[chunkIndex]);
+        });
+
+        uint64_t positionTotal = 0;
+        uint64_t normalTotal = 0;
+        uint64_t texCoordTotal = 0;
+        for (OBJChunk& chunk : chunks)
+        {
+            chunk.PositionOffset = static_cast<uint32_t>(positionTotal);
+            chunk.NormalOffset = static_cast<uint32_t>(normalTotal);
+            chunk.TexCoordOffset = static_cast<uint32_t>(texCoordTotal);
+            positionTotal += chunk.PositionCount;
+            normalTotal += chunk.NormalCount;
+            texCoordTotal += chunk.TexCoordCount;
+        }
+        if (std::max({ positionTotal, normalTotal, texCoordTotal }) > uint64_t(std::numeric_limits<int>::max()))
+        {
+            GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: too many vertex elements", filepath));
+            return MeshData{};
+        }
+
+        OBJAttributes attrib;
+        attrib.Positions.resize(3 * positionTotal);
+        attrib.Normals.resize(3 * normalTotal);
+        attrib.TexCoords.resize(2 * texCoordTotal);
+        GetThreadPool()->ParallelFor(chunks.size(), [&chunks, &attrib, positionTotal, normalTotal, texCoordTotal](size_t chunkIndex)
+        {
+            ParseOBJChunk(chunks[chunkIndex], attrib, uint32_t(positionTotal), uint32_t(normalTotal), uint32_t(texCoordTotal));
+        });
+
+        for (const OBJChunk& chunk : chunks)
+        {
+            if (!chunk.Error.empty())
+            {
+                GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: {}", filepath, chunk.Error));
+                return MeshData{};
+            }
+        }
+
+        std::map<std::string, int> materialIds;
+        LoadOBJMaterialLibraries(filepath, chunks, materialIds);
+        std::vector<OBJShape> shapes = CollectOBJShapes(chunks, materialIds);
+
+        // shapes do not share vertices, so each of them is processed independently
+        std::vector<OBJShapeData> shapeData(shapes.size());
+        GetThreadPool()->ParallelFor(shapes.size(), [&attrib, &shapes, &shapeData](size_t shapeIndex)
+        {
+            shapeData[shapeIndex] = DeduplicateOBJShape(attrib, shapes[shapeIndex]);
+        });
+
+        MeshData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.SubMeshes.resize(shapes.size());
+
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        for (size_t i = 0; i < shapes.size(); i++)
+        {
+            SubMeshData& subMesh = result.SubMeshes[i];
+            subMesh.Name = shapes[i].Name;
+            subMesh.VertexOffset = vertexCount;
+            subMesh.VertexCount = static_cast<uint32_t>(shapeData[i].Vertices.size());
+            subMesh.IndexOffset = indexCount;
+            subMesh.IndexCount = static_cast<uint32_t>(shapeData[i].Indices.size());
+            if (shapes[i].MaterialId >= 0)
+                subMesh.MaterialIndex = static_cast<uint32_t>(shapes[i].MaterialId);
+
+            vertexCount += subMesh.VertexCount;
+            indexCount += subMesh.IndexCount;
+        }
+
+        result.Vertices.resize(vertexCount);
+        result.Indices.resize(indexCount);
+        GetThreadPool()->ParallelFor(shapes.size(), [&result, &shapeData](size_t shapeIndex)
+        {
+            SubMeshData& subMesh = result.SubMeshes[shapeIndex];
+            const OBJShapeData& shape = shapeData[shapeIndex];
+            std::copy(shape.Vertices.begin(), shape.Vertices.end(), result.Vertices.begin() + subMesh.VertexOffset);
+            std::copy(shape.Indices.begin(), shape.Indices.end(), result.Indices.begin() + subMesh.IndexOffset);
+            ComputeBounds(result, subMesh);
+        });
+
+        return result;
+    }
+
+    struct GLTFAccessorView
+    {
+        const unsigned char* Data = nullptr;
+        size_t Stride = 0;
+        size_t Count = 0;
+        int ComponentType = 0;
+        int ComponentCount = 0;
+        bool Normalized = false;
+    };
+
+    // returns an empty view for accessors whose elements do not fit into their buffer
+    static GLTFAccessorView GetAccessorView(const tinygltf::Model& model, int accessorIndex)
+    {
+        GLTFAccessorView view;
+        if (accessorIndex < 0 || size_t(accessorIndex) >= model.accessors.size())
+            return view;
+
+        const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+        if (accessor.bufferView < 0 || size_t(accessor.bufferView) >= model.bufferViews.size())
+            return view;
+
+        const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+        if (bufferView.buffer < 0 || size_t(bufferView.buffer) >= model.buffers.size())
+            return view;
+
+        const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
+        int stride = accessor.ByteStride(bufferView);
+        int componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+        int componentCount = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+        if (stride <= 0 || componentSize <= 0 || componentCount <= 0)
+            return view;
+
+        size_t elementSize = size_t(componentSize) * size_t(componentCount);
+        size_t offset = bufferView.byteOffset + accessor.byteOffset;
+        if (accessor.count > 0)
+        {
+            size_t lastElementEnd = offset + (accessor.count - 1) * size_t(stride) + elementSize;
+            if (lastElementEnd > bufferView.byteOffset + bufferView.byteLength || lastElementEnd > buffer.data.size())
+                return view;
+        }
+
+        view.Data = buffer.data.data() + offset;
+        view.Stride = static_cast<size_t>(stride);
+        view.Count = accessor.count;
+        view.ComponentType = accessor.componentType;
+        view.ComponentCount = componentCount;
+        view.Normalized = accessor.normalized;
+        return view;
+    }
+
+    static float ReadAccessorComponent(const unsigned char* data, int componentType, bool normalized)
+    {
+        switch (componentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+        {
+            float value = 0.0f;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        {
+            uint8_t value = *data;
+            return normalized ? value / 255.0f : static_cast<float>(value);
+        }
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+        {
+            int8_t value = static_cast<int8_t>(*data);
+            return normalized ? std::max(value / 127.0f, -1.0f) : static_cast<float>(value);
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+        {
+            uint16_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return normalized ? value / 65535.0f : static_cast<float>(value);
+        }
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+        {
+            int16_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return normalized ? std::max(value / 32767.0f, -1.0f) : static_cast<float>(value);
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<float>(value);
+        }
+        default:
+            VALX_ASSERT(false && "invalid accessor component type");
+            return 0.0f;
+        }
+    }
+
+    static glm::vec4 ReadAccessorElement(const GLTFAccessorView& view, size_t index)
+    {
+        glm::vec4 result(0.0f);
+        const unsigned char* element = view.Data + index * view.Stride;
+        const size_t componentSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(view.ComponentType)));
+        for (int i = 0; i < std::min(view.ComponentCount, 4); i++)
+        {
+            result[i] = ReadAccessorComponent(element + i * componentSize, view.ComponentType, view.Normalized);
+        }
+        return result;
+    }
+
+    static uint32_t ReadAccessorIndex(const GLTFAccessorView& view, size_t index)
+    {
+        const unsigned char* element = view.Data + index * view.Stride;
+        switch (view.ComponentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            return *element;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+        {
+            uint16_t value = 0;
+            std::memcpy(&value, element, sizeof(value));
+            return value;
+        }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, element, sizeof(value));
+            return value;
+        }
+        default:
+            VALX_ASSERT(false && "invalid index component type");
+            return 0;
+        }
+    }
+
+    static int FindAttribute(const tinygltf::Primitive& primitive, const char* name)
+    {
+        auto it = primitive.attributes.find(name);
+        return it != primitive.attributes.end() ? it->second : -1;
+    }
+
+    static bool SkipGLTFImageData(tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*)
+    {
+        // images are loaded through TextureLoader, only geometry is needed here
+        return true;
+    }
+
+    static bool IsGLTFIndexType(int componentType)
+    {
+        return componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+            componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT ||
+            componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+    }
+
+    // checks everything the decoder later uses as an offset or index, returns the reason a primitive is rejected
+    static std::string ValidateGLTFPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive)
+    {
+        GLTFAccessorView positions = GetAccessorView(model, FindAttribute(primitive, "POSITION"));
+        if (positions.Data == nullptr || positions.Count == 0)
+            return "it has no positions";
+        if (positions.Count > std::numeric_limits<uint32_t>::max())
+            return "it has too many vertices";
+
+        for (const char* attribute : { "NORMAL", "TEXCOORD_0", "TANGENT" })
+        {
+            int accessorIndex = FindAttribute(primitive, attribute);
+            if (accessorIndex < 0)
+                continue;
+            GLTFAccessorView view = GetAccessorView(model, accessorIndex);
+            if (view.Data == nullptr || view.Count != positions.Count)
+                return fmt::format("its {} accessor does not match the {} positions", attribute, positions.Count);
+        }
+
+        if (primitive.indices < 0)
+            return {};
+
+        GLTFAccessorView indices = GetAccessorView(model, primitive.indices);
+        if (indices.Data == nullptr || !IsGLTFIndexType(indices.ComponentType) || indices.ComponentCount != 1)
+            return "its index accessor is invalid";
+        if (indices.Count > std::numeric_limits<uint32_t>::max())
+            return "it has too many indices";
+        for (size_t i = 0; i < indices.Count; i++)
+        {
+            if (ReadAccessorIndex(indices, i) >= positions.Count)
+                return fmt::format("index #{} references a vertex outside of the {} positions", i, positions.Count);
+        }
+        return {};
+    }
+
+    static void DecodeGLTFPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive, MeshData& mesh, SubMeshData& subMesh)
+    {
+        Vertex* vertices = mesh.Vertices.data() + subMesh.VertexOffset;
+        uint32_t* indices = mesh.Indices.data() + subMesh.IndexOffset;
+
+        GLTFAccessorView positions = GetAccessorView(model, FindAttribute(primitive, "POSITION"));
+        GLTFAccessorView normals = GetAccessorView(model, FindAttribute(primitive, "NORMAL"));
+        GLTFAccessorView texCoords = GetAccessorView(model, FindAttribute(primitive, "TEXCOORD_0"));
+        GLTFAccessorView tangents = GetAccessorView(model, FindAttribute(primitive, "TANGENT"));
+        GLTFAccessorView indexView = GetAccessorView(model, primitive.indices);
+
+        for (uint32_t i = 0; i < subMesh.VertexCount; i++)
+        {
+            Vertex& vertex = vertices[i];
+            glm::vec4 position = ReadAccessorElement(positions, i);
+            vertex.Position = glm::vec3(position.x, position.y, position.z);
+            if (normals.Data != nullptr)
+            {
+                glm::vec4 normal = ReadAccessorElement(normals, i);
+                vertex.Normal = glm::vec3(normal.x, normal.y, normal.z);
+            }
+            if (texCoords.Data != nullptr)
+            {
+                // glTF texture coordinates start at the top of an image, while TextureLoader stores images bottom-up
+                glm::vec4 texCoord = ReadAccessorElement(texCoords, i);
+                vertex.TexCoord = glm::vec2(texCoord.x, 1.0f - texCoord.y);
+            }
+        }
+
+        if (indexView.Data != nullptr)
+        {
+            for (uint32_t i = 0; i < subMesh.IndexCount; i++)
+                indices[i] = ReadAccessorIndex(indexView, i);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < subMesh.IndexCount; i++)
+                indices[i] = i;
+        }
+
+        if (normals.Data == nullptr)
+            GenerateNormals(vertices, subMesh.VertexCount, indices, subMesh.IndexCount);
+
+        if (tangents.Data != nullptr && normals.Data != nullptr)
+        {
+            for (uint32_t i = 0; i < subMesh.VertexCount; i++)
+            {
+                Vertex& vertex = vertices[i];
+                glm::vec4 tangent = ReadAccessorElement(tangents, i);
+                vertex.Tangent = glm::vec3(tangent.x, tangent.y, tangent.z);
+                // flipped V coordinate mirrors the tangent frame, so handedness is inverted as well
+                vertex.Bitangent = glm::cross(vertex.Normal, vertex.Tangent) * -tangent.w;
+            }
+        }
+        else
+        {
+            GenerateTangents(vertices, subMesh.VertexCount, indices, subMesh.IndexCount);
+        }
+
+        ComputeBounds(mesh, subMesh);
+    }
+
+    static MeshData LoadMeshUsingGLTFLoader(const std::string& filepath, bool isBinary)
+    {
+        tinygltf::Model model;
+        tinygltf::TinyGLTF loader;
+        loader.SetImageLoader(SkipGLTFImageData, nullptr);
+
+        std::string error;
+        std::string warning;
+        bool isLoaded = isBinary ?
+            loader.LoadBinaryFromFile(&model, &error, &warning, filepath) :
+            loader.LoadASCIIFromFile(&model, &error, &warning, filepath);
+
+        if (!warning.empty())
+            GetCurrentLogger()->LogWarning("MeshLoader", warning);
+        if (!isLoaded)
+        {
+            GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: {}", filepath, error));
+            return MeshData{};
+        }
+
+        MeshData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+
+        std::vector<std::pair<const tinygltf::Mesh*, size_t>> candidates;
+        for (const tinygltf::Mesh& mesh : model.meshes)
+        {
+            for (size_t i = 0; i < mesh.primitives.size(); i++)
+            {
+                if (mesh.primitives[i].mode != TINYGLTF_MODE_TRIANGLES && mesh.primitives[i].mode != -1)
+                {
+                    GetCurrentLogger()->LogWarning("MeshLoader", fmt::format("skipping primitive #{} of `{}`, only triangles are supported", i, mesh.name));
+                    continue;
+                }
+                candidates.emplace_back(&mesh, i);
+            }
+        }
+
+        // every index is read once before decoding, so a malformed file cannot make the decoder write out of bounds
+        std::vector<std::string> rejections(candidates.size());
+        GetThreadPool()->ParallelFor(candidates.size(), [&model, &candidates, &rejections](size_t candidateIndex)
+        {
+            const auto& [mesh, primitiveIndex] = candidates[candidateIndex];
+            rejections[candidateIndex] = ValidateGLTFPrimitive(model, mesh->primitives[primitiveIndex]);
+        });
+
+        // first pass only computes ranges, so all primitives can be decoded in parallel into one allocation
+        std::vector<const tinygltf::Primitive*> primitives;
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        for (size_t candidateIndex = 0; candidateIndex < candidates.size(); candidateIndex++)
+        {
+            const auto& [mesh, i] = candidates[candidateIndex];
+            const tinygltf::Primitive& primitive = mesh->primitives[i];
+            if (!rejections[candidateIndex].empty())
+            {
+                GetCurrentLogger()->LogWarning("MeshLoader", fmt::format("skipping primitive #{} of `{}`, {}", i, mesh->name, rejections[candidateIndex]));
+                continue;
+            }
+
+            SubMeshData subMesh;
+            subMesh.Name = mesh->primitives.size() > 1 ? fmt::format("{}#{}", mesh->name, i) : mesh->name;
+            subMesh.MaterialIndex = primitive.material >= 0 ? static_cast<uint32_t>(primitive.material) : 0;
+            subMesh.VertexOffset = static_cast<uint32_t>(vertexCount);
+            subMesh.VertexCount = static_cast<uint32_t>(model.accessors[FindAttribute(primitive, "POSITION")].count);
+            subMesh.IndexOffset = static_cast<uint32_t>(indexCount);
+            subMesh.IndexCount = primitive.indices >= 0 ?
+                static_cast<uint32_t>(model.accessors[primitive.indices].count) : subMesh.VertexCount;
+
+            vertexCount += subMesh.VertexCount;
+            indexCount += subMesh.IndexCount;
+            result.SubMeshes.push_back(std::move(subMesh));
+            primitives.push_back(&primitive);
+        }
+
+        if (std::max(vertexCount, indexCount) > std::numeric_limits<uint32_t>::max())
+        {
+            GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: more than 2^32 vertices or indices", filepath));
+            return MeshData{};
+        }
+
+        result.Vertices.resize(vertexCount);
+        result.Indices.resize(indexCount);
+        GetThreadPool()->ParallelFor(primitives.size(), [&model, &primitives, &result](size_t primitiveIndex)
+        {
+            DecodeGLTFPrimitive(model, *primitives[primitiveIndex], result, result.SubMeshes[primitiveIndex]);
+        });
+
+        return result;
+    }
+
+    MeshData MeshLoader::LoadMeshFromFile(const std::string& filepath)
+    {
+        MeshData result;
+        if (IsOBJMesh(filepath))
+            result = LoadMeshUsingOBJLoader(filepath);
+        else if (IsGLTFMesh(filepath))
+            result = LoadMeshUsingGLTFLoader(filepath, false);
+        else if (IsGLBMesh(filepath))
+            result = LoadMeshUsingGLTFLoader(filepath, true);
+        else
+            GetCurrentLogger()->LogError("MeshLoader", fmt::format("cannot load `{}`: unsupported mesh format", filepath));
+
+        if (!result.SubMeshes.empty())
+        {
+            GetCurrentLogger()->LogInfo("MeshLoader", fmt::format("mesh `{}` loaded: {} vertices, {} indices, {} submeshes",
+                filepath, result.Vertices.size(), result.Indices.size(), result.SubMeshes.size()));
+        }
+        return result;
+    }
+
+    void GenerateNormals(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+    {
+        for (size_t i = 0; i < vertexCount; i++)
+            vertices[i].Normal = glm::vec3(0.0f);
+
+        // cross product is not normalized, so each face contributes proportionally to its area
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            Vertex& v0 = vertices[indices[i + 0]];
+            Vertex& v1 = vertices[indices[i + 1]];
+            Vertex& v2 = vertices[indices[i + 2]];
+            glm::vec3 normal = glm::cross(v1.Position - v0.Position, v2.Position - v0.Position);
+            v0.Normal += normal;
+            v1.Normal += normal;
+            v2.Normal += normal;
+        }
+
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            float length = glm::length(vertices[i].Normal);
+            vertices[i].Normal = length > 0.0f ? vertices[i].Normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    void GenerateTangents(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+    {
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            vertices[i].Tangent = glm::vec3(0.0f);
+            vertices[i].Bitangent = glm::vec3(0.0f);
+        }
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            Vertex& v0 = vertices[indices[i + 0]];
+            Vertex& v1 = vertices[indices[i + 1]];
+            Vertex& v2 = vertices[indices[i + 2]];
+
+            glm::vec3 edge1 = v1.Position - v0.Position;
+            glm::vec3 edge2 = v2.Position - v0.Position;
+            glm::vec2 deltaUV1 = v1.TexCoord - v0.TexCoord;
+            glm::vec2 deltaUV2 = v2.TexCoord - v0.TexCoord;
+
+            float determinant = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+            if (std::abs(determinant) < 1e-12f)
+                continue; // degenerate texture mapping, the vertex falls back to a basis built from its normal
+
+            float inverseDeterminant = 1.0f / determinant;
+            glm::vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * inverseDeterminant;
+            glm::vec3 bitangent = (edge2 * deltaUV1.x - edge1 * deltaUV2.x) * inverseDeterminant;
+
+            v0.Tangent += tangent;
+            v1.Tangent += tangent;
+            v2.Tangent += tangent;
+            v0.Bitangent += bitangent;
+            v1.Bitangent += bitangent;
+            v2.Bitangent += bitangent;
+        }
+
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            Vertex& vertex = vertices[i];
+            const glm::vec3& normal = vertex.Normal;
+
+            // Gram-Schmidt orthogonalization of the accumulated tangent against the normal
+            glm::vec3 tangent = vertex.Tangent - normal * glm::dot(normal, vertex.Tangent);
+            float tangentLength = glm::length(tangent);
+            if (tangentLength < 1e-6f)
+            {
+                glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                tangent = glm::normalize(glm::cross(axis, normal));
+                vertex.Tangent = tangent;
+                vertex.Bitangent = glm::cross(normal, tangent);
+                continue;
+            }
+            tangent = tangent / tangentLength;
+
+            float handedness = glm::dot(glm::cross(normal, tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+            vertex.Tangent = tangent;
+            vertex.Bitangent = glm::cross(normal, tangent) * handedness;
+        }
+    }
+
+    void QuantizeMesh(MeshData& mesh)
+    {
+        if (mesh.Vertices.empty())
+            return;
+
+        glm::vec3 boundsMin = mesh.Vertices.front().Position;
+        glm::vec3 boundsMax = mesh.Vertices.front().Position;
+        for (const Vertex& vertex : mesh.Vertices)
+        {
+            boundsMin = glm::min(boundsMin, vertex.Position);
+            boundsMax = glm::max(boundsMax, vertex.Position);
+        }
+
+        mesh.Quantization.PositionOffset = (boundsMin + boundsMax) * 0.5f;
+        mesh.Quantization.PositionScale = (boundsMax - boundsMin) * 0.5f;
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            if (mesh.Quantization.PositionScale[axis] <= 0.0f)
+                mesh.Quantization.PositionScale[axis] = 1.0f;
+        }
+
+        mesh.QuantizedVertices.resize(mesh.Vertices.size());
+        constexpr size_t VerticesPerTask = 16384;
+        const size_t taskCount = (mesh.Vertices.size() + VerticesPerTask - 1) / VerticesPerTask;
+        GetThreadPool()->ParallelFor(taskCount, [&mesh](size_t task)
+        {
+            const size_t end = std::min(mesh.Vertices.size(), (task + 1) * VerticesPerTask);
+            for (size_t i = task * VerticesPerTask; i < end; i++)
+                mesh.QuantizedVertices[i] = QuantizeVertex(mesh.Vertices[i], mesh.Quantization);
+        });
+    }
+}
\ No newline at end of file
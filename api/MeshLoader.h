@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#include "VertexLayout.h"
+
+namespace VALX
+{
+    struct SubMeshLod
+    {
+        uint32_t IndexOffset = 0;
+        uint32_t IndexCount = 0;
+        // object space simplification error, zero for the source geometry
+        float Error = 0.0f;
+    };
+
+    struct SubMeshData
+    {
+        std::string Name;
+        // indices of a submesh are relative to its VertexOffset, which is passed as vertexOffset of an indexed draw
+        uint32_t VertexOffset = 0;
+        uint32_t VertexCount = 0;
+        uint32_t IndexOffset = 0;
+        uint32_t IndexCount = 0;
+        uint32_t MaterialIndex = 0;
+        glm::vec3 BoundsMin = glm::vec3(0.0f);
+        glm::vec3 BoundsMax = glm::vec3(0.0f);
+        // filled by GenerateMeshLods, Lods[0] is the source geometry, all levels share vertices of the submesh
+        std::vector<SubMeshLod> Lods;
+    };
+
+    // all submeshes share one vertex and one index array, so a mesh is uploaded as a single vertex and a single index buffer
+    struct MeshData
+    {
+        std::string FilePath;
+        std::vector<Vertex> Vertices;
+        std::vector<uint32_t> Indices;
+        std::vector<SubMeshData> SubMeshes;
+        // filled by QuantizeMesh, matches Vertices one to one
+        std::vector<QuantizedVertex> QuantizedVertices;
+        VertexQuantization Quantization;
+    };
+
+    class MeshLoader
+    {
+    public:
+        MeshData LoadMeshFromFile(const std::string& filepath);
+    };
+
+    void GenerateNormals(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+    void GenerateTangents(Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+    // should run after all passes which modify vertices, the per-mesh dequantization transform is stored in MeshData::Quantization
+    void QuantizeMesh(MeshData& mesh);
+}
\ No newline at end of file
@@ -0,0 +1,736 @@
+#include "MeshOptimizer.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <cmath>
+#include <unordered_map>
+
+namespace VALX
+{
+    constexpr uint32_t INVALID_VERTEX = UINT32_MAX;
+
+    // FIFO cache simulation: a vertex stays in the cache until cacheSize other vertices were transformed after it
+    class VertexCacheSimulator
+    {
+        std::vector<uint32_t> timestamps;
+        uint32_t cacheSize = 0;
+        uint32_t time = 0;
+
+    public:
+        VertexCacheSimulator(size_t vertexCount, uint32_t cacheSize)
+            : timestamps(vertexCount, 0), cacheSize(cacheSize), time(cacheSize + 1)
+        {
+        }
+
+        bool Access(uint32_t vertex)
+        {
+            if (this->time - this->timestamps[vertex] <= this->cacheSize)
+                return false;
+
+            this->timestamps[vertex] = this->time++;
+            return true;
+        }
+
+        void Flush()
+        {
+            this->time += this->cacheSize + 1;
+        }
+    };
+
+    VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+    {
+        VertexCacheStats stats;
+        if (indexCount < 3 || vertexCount == 0)
+            return stats;
+
+        VertexCacheSimulator cache(vertexCount, cacheSize);
+        std::vector<bool> isReferenced(vertexCount, false);
+        size_t missCount = 0;
+        size_t referencedCount = 0;
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            if (cache.Access(indices[i]))
+                missCount++;
+            if (!isReferenced[indices[i]])
+            {
+                isReferenced[indices[i]] = true;
+                referencedCount++;
+            }
+        }
+
+        stats.ACMR = static_cast<float>(missCount) / static_cast<float>(indexCount / 3);
+        stats.ATVR = static_cast<float>(missCount) / static_cast<float>(referencedCount);
+        return stats;
+    }
+
+    struct TriangleAdjacency
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+        std::vector<uint32_t> LiveCounts;
+    };
+
+    static TriangleAdjacency BuildTriangleAdjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+    {
+        TriangleAdjacency adjacency;
+        adjacency.LiveCounts.assign(vertexCount, 0);
+        for (size_t i = 0; i < indexCount; i++)
+            adjacency.LiveCounts[indices[i]]++;
+
+        adjacency.Offsets.assign(vertexCount + 1, 0);
+        for (size_t i = 0; i < vertexCount; i++)
+            adjacency.Offsets[i + 1] = adjacency.Offsets[i] + adjacency.LiveCounts[i];
+
+        std::vector<uint32_t> cursors(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+        adjacency.Triangles.resize(indexCount);
+        for (size_t i = 0; i < indexCount; i++)
+            adjacency.Triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+        return adjacency;
+    }
+
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>* clusters)
+    {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0)
+            return;
+
+        TriangleAdjacency adjacency = BuildTriangleAdjacency(indices, indexCount, vertexCount);
+        std::vector<uint32_t>& liveTriangles = adjacency.LiveCounts;
+        std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+        std::vector<bool> isEmitted(triangleCount, false);
+        std::vector<uint32_t> deadEndStack;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+        deadEndStack.reserve(indexCount);
+        result.reserve(indexCount);
+
+        uint32_t timestamp = cacheSize + 1;
+        uint32_t scanCursor = 0;
+        bool isClusterStart = true;
+
+        auto skipDeadEnd = [&]() -> uint32_t
+        {
+            while (!deadEndStack.empty())
+            {
+                uint32_t vertex = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveTriangles[vertex] > 0)
+                    return vertex;
+            }
+            for (; scanCursor < vertexCount; scanCursor++)
+            {
+                if (liveTriangles[scanCursor] > 0)
+                    return scanCursor;
+            }
+            return INVALID_VERTEX;
+        };
+
+        uint32_t fanningVertex = skipDeadEnd();
+        while (fanningVertex != INVALID_VERTEX)
+        {
+            candidates.clear();
+            for (uint32_t i = adjacency.Offsets[fanningVertex]; i < adjacency.Offsets[fanningVertex + 1]; i++)
+            {
+                uint32_t triangle = adjacency.Triangles[i];
+                if (isEmitted[triangle])
+                    continue;
+
+                if (isClusterStart && clusters != nullptr)
+                    clusters->push_back(static_cast<uint32_t>(result.size() / 3));
+                isClusterStart = false;
+
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    uint32_t vertex = indices[3 * triangle + j];
+                    result.push_back(vertex);
+                    deadEndStack.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveTriangles[vertex]--;
+                    if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                        cacheTimestamps[vertex] = timestamp++;
+                }
+                isEmitted[triangle] = true;
+            }
+
+            // prefer the candidate which will still be in cache after all of its remaining triangles are emitted
+            uint32_t nextVertex = INVALID_VERTEX;
+            int64_t bestPriority = -1;
+            for (uint32_t vertex : candidates)
+            {
+                if (liveTriangles[vertex] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                int64_t age = static_cast<int64_t>(timestamp) - static_cast<int64_t>(cacheTimestamps[vertex]);
+                if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= static_cast<int64_t>(cacheSize))
+                    priority = age;
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    nextVertex = vertex;
+                }
+            }
+
+            if (nextVertex == INVALID_VERTEX)
+            {
+                nextVertex = skipDeadEnd();
+                isClusterStart = true;
+            }
+            fanningVertex = nextVertex;
+        }
+
+        VALX_ASSERT(result.size() == triangleCount * 3);
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    static std::vector<uint32_t> InsertSoftBoundaries(const uint32_t* indices, size_t indexCount, size_t vertexCount, const std::vector<uint32_t>& clusters, uint32_t cacheSize, float threshold)
+    {
+        const float meshACMR = AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize).ACMR;
+        const uint32_t triangleCount = static_cast<uint32_t>(indexCount / 3);
+
+        std::vector<uint32_t> result;
+        VertexCacheSimulator cache(vertexCount, cacheSize);
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            const uint32_t clusterBegin = clusters[i];
+            const uint32_t clusterEnd = (i + 1 < clusters.size()) ? clusters[i + 1] : triangleCount;
+
+            result.push_back(clusterBegin);
+            cache.Flush();
+            uint32_t missCount = 0;
+            uint32_t clusterTriangles = 0;
+            for (uint32_t triangle = clusterBegin; triangle < clusterEnd; triangle++)
+            {
+                for (uint32_t j = 0; j < 3; j++)
+                    missCount += cache.Access(indices[3 * triangle + j]) ? 1 : 0;
+                clusterTriangles++;
+
+                // splitting here costs little vertex cache efficiency, but gives the overdraw sort more freedom
+                bool isLast = triangle + 1 == clusterEnd;
+                if (!isLast && static_cast<float>(missCount) <= threshold * meshACMR * static_cast<float>(clusterTriangles))
+                {
+                    result.push_back(triangle + 1);
+                    cache.Flush();
+                    missCount = 0;
+                    clusterTriangles = 0;
+                }
+            }
+        }
+        return result;
+    }
+
+    void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount, const std::vector<uint32_t>& clusters, uint32_t cacheSize, float threshold)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indexCount / 3);
+        if (triangleCount == 0 || clusters.empty())
+            return;
+
+        std::vector<uint32_t> boundaries = InsertSoftBoundaries(indices, indexCount, vertexCount, clusters, cacheSize, threshold);
+
+        struct ClusterInfo
+        {
+            uint32_t Begin = 0;
+            uint32_t End = 0;
+            glm::vec3 Centroid = glm::vec3(0.0f);
+            glm::vec3 Normal = glm::vec3(0.0f);
+            float Area = 0.0f;
+            float SortKey = 0.0f;
+        };
+
+        std::vector<ClusterInfo> clusterInfos(boundaries.size());
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t i = 0; i < boundaries.size(); i++)
+        {
+            ClusterInfo& cluster = clusterInfos[i];
+            cluster.Begin = boundaries[i];
+            cluster.End = (i + 1 < boundaries.size()) ? boundaries[i + 1] : triangleCount;
+
+            for (uint32_t triangle = cluster.Begin; triangle < cluster.End; triangle++)
+            {
+                const glm::vec3& p0 = vertices[indices[3 * triangle + 0]].Position;
+                const glm::vec3& p1 = vertices[indices[3 * triangle + 1]].Position;
+                const glm::vec3& p2 = vertices[indices[3 * triangle + 2]].Position;
+
+                glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                float area = glm::length(normal);
+                cluster.Normal += normal;
+                cluster.Centroid += (p0 + p1 + p2) * (area / 3.0f);
+                cluster.Area += area;
+            }
+
+            meshCentroid += cluster.Centroid;
+            meshArea += cluster.Area;
+            if (cluster.Area > 0.0f)
+                cluster.Centroid = cluster.Centroid / cluster.Area;
+        }
+        if (meshArea > 0.0f)
+            meshCentroid = meshCentroid / meshArea;
+
+        // clusters which face away from the center are likely to occlude the rest of the mesh, so they go first
+        for (ClusterInfo& cluster : clusterInfos)
+        {
+            float normalLength = glm::length(cluster.Normal);
+            cluster.SortKey = normalLength > 0.0f ? glm::dot(cluster.Centroid - meshCentroid, cluster.Normal / normalLength) : 0.0f;
+        }
+        std::stable_sort(clusterInfos.begin(), clusterInfos.end(), [](const ClusterInfo& c1, const ClusterInfo& c2)
+        {
+            return c1.SortKey > c2.SortKey;
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indexCount);
+        for (const ClusterInfo& cluster : clusterInfos)
+        {
+            result.insert(result.end(), indices + 3 * cluster.Begin, indices + 3 * cluster.End);
+        }
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    void OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, uint32_t* indices, size_t indexCount)
+    {
+        std::vector<uint32_t> remap(vertexCount, INVALID_VERTEX);
+        uint32_t nextVertex = 0;
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            uint32_t& index = indices[i];
+            if (remap[index] == INVALID_VERTEX)
+                remap[index] = nextVertex++;
+            index = remap[index];
+        }
+        for (uint32_t& index : remap)
+        {
+            if (index == INVALID_VERTEX)
+                index = nextVertex++;
+        }
+
+        std::vector<Vertex> reordered(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            reordered[remap[i]] = vertices[i];
+        std::copy(reordered.begin(), reordered.end(), vertices);
+    }
+
+    std::vector<MeshOptimizationReport> OptimizeMesh(MeshData& mesh, const MeshOptimizationInfo& info)
+    {
+        std::vector<MeshOptimizationReport> reports(mesh.SubMeshes.size());
+        GetThreadPool()->ParallelFor(mesh.SubMeshes.size(), [&mesh, &info, &reports](size_t subMeshIndex)
+        {
+            const SubMeshData& subMesh = mesh.SubMeshes[subMeshIndex];
+            Vertex* vertices = mesh.Vertices.data() + subMesh.VertexOffset;
+            uint32_t* indices = mesh.Indices.data() + subMesh.IndexOffset;
+
+            MeshOptimizationReport& report = reports[subMeshIndex];
+            report.SubMeshName = subMesh.Name;
+            report.Before = AnalyzeVertexCache(indices, subMesh.IndexCount, subMesh.VertexCount, info.CacheSize);
+
+            if (info.OptimizeVertexCache)
+            {
+                std::vector<uint32_t> clusters;
+                OptimizeVertexCache(indices, subMesh.IndexCount, subMesh.VertexCount, info.CacheSize, &clusters);
+                if (info.OptimizeOverdraw)
+                    OptimizeOverdraw(indices, subMesh.IndexCount, vertices, subMesh.VertexCount, clusters, info.CacheSize, info.OverdrawThreshold);
+            }
+            if (info.OptimizeVertexFetch)
+                OptimizeVertexFetch(vertices, subMesh.VertexCount, indices, subMesh.IndexCount);
+
+            report.After = AnalyzeVertexCache(indices, subMesh.IndexCount, subMesh.VertexCount, info.CacheSize);
+        });
+
+        for (const MeshOptimizationReport& report : reports)
+        {
+            GetCurrentLogger()->LogInfo("MeshOptimizer", fmt::format("submesh `{}`: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+                report.SubMeshName, report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR));
+        }
+        return reports;
+    }
+
+    // symmetric 4x4 matrix of summed squared plane distances, divided by the summed weight on evaluation
+    struct Quadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A03 = 0.0;
+        double A11 = 0.0, A12 = 0.0, A13 = 0.0;
+        double A22 = 0.0, A23 = 0.0;
+        double A33 = 0.0;
+        double Weight = 0.0;
+
+        void AddPlane(const glm::vec3& normal, float distance, float weight)
+        {
+            double a = normal.x, b = normal.y, c = normal.z, d = distance;
+            this->A00 += weight * a * a; this->A01 += weight * a * b; this->A02 += weight * a * c; this->A03 += weight * a * d;
+            this->A11 += weight * b * b; this->A12 += weight * b * c; this->A13 += weight * b * d;
+            this->A22 += weight * c * c; this->A23 += weight * c * d;
+            this->A33 += weight * d * d;
+            this->Weight += weight;
+        }
+
+        void Add(const Quadric& other)
+        {
+            this->A00 += other.A00; this->A01 += other.A01; this->A02 += other.A02; this->A03 += other.A03;
+            this->A11 += other.A11; this->A12 += other.A12; this->A13 += other.A13;
+            this->A22 += other.A22; this->A23 += other.A23;
+            this->A33 += other.A33;
+            this->Weight += other.Weight;
+        }
+
+        double Evaluate(const glm::vec3& position) const
+        {
+            double x = position.x, y = position.y, z = position.z;
+            double error = this->A00 * x * x + this->A11 * y * y + this->A22 * z * z + this->A33 +
+                2.0 * (this->A01 * x * y + this->A02 * x * z + this->A12 * y * z + this->A03 * x + this->A13 * y + this->A23 * z);
+            return this->Weight > 0.0 ? std::max(error, 0.0) / this->Weight : 0.0;
+        }
+    };
+
+    struct CollapseCandidate
+    {
+        // squared object space distance
+        float Error = 0.0f;
+        uint32_t From = 0;
+        uint32_t To = 0;
+        uint32_t FromVersion = 0;
+        uint32_t ToVersion = 0;
+    };
+
+    struct CollapseCandidateCompare
+    {
+        bool operator()(const CollapseCandidate& c1, const CollapseCandidate& c2) const
+        {
+            return c1.Error > c2.Error;
+        }
+    };
+
+    struct PositionHash
+    {
+        size_t operator()(const glm::vec3& position) const
+        {
+            size_t hash = 0;
+            HashCombine(hash, position.x);
+            HashCombine(hash, position.y);
+            HashCombine(hash, position.z);
+            return hash;
+        }
+    };
+
+    static uint64_t GetEdgeKey(uint32_t v1, uint32_t v2)
+    {
+        return v1 < v2 ? (uint64_t(v1) << 32) | v2 : (uint64_t(v2) << 32) | v1;
+    }
+
+    std::vector<uint32_t> SimplifyMesh(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float maxError, float* resultError)
+    {
+        // triangle corners keep the source vertices, so the matching attribute copy can be selected on collapse
+        std::vector<uint32_t> corners(indices, indices + indexCount);
+        if (resultError != nullptr)
+            *resultError = 0.0f;
+        if (indexCount <= targetIndexCount || indexCount < 3)
+            return corners;
+
+        // vertices split on uv or normal seams are welded by position, simplification works on the welded topology
+        std::vector<uint32_t> weld(vertexCount);
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> uniquePositions;
+        uniquePositions.reserve(vertexCount);
+        for (uint32_t vertex = 0; vertex < (uint32_t)vertexCount; vertex++)
+            weld[vertex] = uniquePositions.emplace(vertices[vertex].Position, vertex).first->second;
+
+        std::vector<uint32_t> copyCount(vertexCount, 0);
+        std::vector<bool> isReferenced(vertexCount, false);
+        for (uint32_t index : corners)
+        {
+            if (!isReferenced[index])
+            {
+                isReferenced[index] = true;
+                copyCount[weld[index]]++;
+            }
+        }
+
+        size_t triangleCount = indexCount / 3;
+        size_t liveTriangleCount = 0;
+        std::vector<bool> isTriangleRemoved(triangleCount, false);
+        std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+        std::vector<Quadric> quadrics(vertexCount);
+        std::unordered_map<uint64_t, uint32_t> edgeUseCount;
+        for (uint32_t triangle = 0; triangle < (uint32_t)triangleCount; triangle++)
+        {
+            uint32_t v0 = weld[corners[3 * triangle + 0]];
+            uint32_t v1 = weld[corners[3 * triangle + 1]];
+            uint32_t v2 = weld[corners[3 * triangle + 2]];
+            if (v0 == v1 || v1 == v2 || v0 == v2)
+            {
+                isTriangleRemoved[triangle] = true;
+                continue;
+            }
+
+            glm::vec3 normal = glm::cross(vertices[v1].Position - vertices[v0].Position, vertices[v2].Position - vertices[v0].Position);
+            float doubleArea = glm::length(normal);
+            if (doubleArea > 0.0f)
+            {
+                normal = normal / doubleArea;
+                float distance = -glm::dot(normal, vertices[v0].Position);
+                for (uint32_t vertex : { v0, v1, v2 })
+                    quadrics[vertex].AddPlane(normal, distance, 0.5f * doubleArea);
+            }
+            for (uint32_t vertex : { v0, v1, v2 })
+                vertexTriangles[vertex].push_back(triangle);
+
+            edgeUseCount[GetEdgeKey(v0, v1)]++;
+            edgeUseCount[GetEdgeKey(v1, v2)]++;
+            edgeUseCount[GetEdgeKey(v2, v0)]++;
+            liveTriangleCount++;
+        }
+
+        // moving a seam vertex would tear the other attribute copies apart, moving a border or non-manifold vertex would shrink the outline
+        std::vector<bool> isLocked(vertexCount, false);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            isLocked[vertex] = copyCount[vertex] > 1;
+        for (const auto& [edge, useCount] : edgeUseCount)
+        {
+            if (useCount != 2)
+            {
+                isLocked[uint32_t(edge >> 32)] = true;
+                isLocked[uint32_t(edge & UINT32_MAX)] = true;
+            }
+        }
+
+        std::vector<uint32_t> versions(vertexCount, 0);
+        std::vector<bool> isCollapsed(vertexCount, false);
+        std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, CollapseCandidateCompare> candidates;
+        auto PushCandidate = [&](uint32_t from, uint32_t to)
+        {
+            if (isLocked[from])
+                return;
+
+            Quadric quadric = quadrics[from];
+            quadric.Add(quadrics[to]);
+            candidates.push(CollapseCandidate{ (float)quadric.Evaluate(vertices[to].Position), from, to, versions[from], versions[to] });
+        };
+        for (uint32_t triangle = 0; triangle < (uint32_t)triangleCount; triangle++)
+        {
+            if (isTriangleRemoved[triangle])
+                continue;
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                uint32_t v1 = weld[corners[3 * triangle + i]];
+                uint32_t v2 = weld[corners[3 * triangle + (i + 1) % 3]];
+                PushCandidate(v1, v2);
+                PushCandidate(v2, v1);
+            }
+        }
+
+        size_t targetTriangleCount = targetIndexCount / 3;
+        float maxErrorSquared = maxError * maxError;
+        float error = 0.0f;
+        std::vector<uint32_t> fromNeighbours;
+        std::vector<uint32_t> toNeighbours;
+        while (liveTriangleCount > targetTriangleCount && !candidates.empty())
+        {
+            CollapseCandidate candidate = candidates.top();
+            candidates.pop();
+            if (isCollapsed[candidate.From] || isCollapsed[candidate.To] ||
+                versions[candidate.From] != candidate.FromVersion || versions[candidate.To] != candidate.ToVersion)
+                continue;
+            if (candidate.Error > maxErrorSquared)
+                break;
+
+            // reject collapses which flip or fold a triangle and the ones violating the link condition, as they create non-manifold geometry
+            uint32_t toCorner = INVALID_VERTEX;
+            uint32_t sharedTriangleCount = 0;
+            bool isFlipped = false;
+            fromNeighbours.clear();
+            for (uint32_t triangle : vertexTriangles[candidate.From])
+            {
+                if (isTriangleRemoved[triangle])
+                    continue;
+
+                glm::vec3 positions[3];
+                glm::vec3 collapsedPositions[3];
+                bool hasTo = false;
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    uint32_t corner = corners[3 * triangle + i];
+                    uint32_t vertex = weld[corner];
+                    if (vertex == candidate.To)
+                    {
+                        hasTo = true;
+                        toCorner = corner;
+                    }
+                    if (vertex != candidate.From)
+                        fromNeighbours.push_back(vertex);
+                    positions[i] = vertices[vertex].Position;
+                    collapsedPositions[i] = vertex == candidate.From ? vertices[candidate.To].Position : positions[i];
+                }
+                if (hasTo)
+                {
+                    sharedTriangleCount++;
+                    continue;
+                }
+
+                glm::vec3 normal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+                glm::vec3 collapsedNormal = glm::cross(collapsedPositions[1] - collapsedPositions[0], collapsedPositions[2] - collapsedPositions[0]);
+                if (glm::dot(normal, collapsedNormal) <= 0.25f * glm::length(normal) * glm::length(collapsedNormal))
+                {
+                    isFlipped = true;
+                    break;
+                }
+            }
+            if (toCorner == INVALID_VERTEX || isFlipped)
+                continue;
+
+            toNeighbours.clear();
+            for (uint32_t triangle : vertexTriangles[candidate.To])
+            {
+                if (isTriangleRemoved[triangle])
+                    continue;
+                for (uint32_t i = 0; i < 3; i++)
+                    toNeighbours.push_back(weld[corners[3 * triangle + i]]);
+            }
+            std::sort(fromNeighbours.begin(), fromNeighbours.end());
+            fromNeighbours.erase(std::unique(fromNeighbours.begin(), fromNeighbours.end()), fromNeighbours.end());
+            std::sort(toNeighbours.begin(), toNeighbours.end());
+            toNeighbours.erase(std::unique(toNeighbours.begin(), toNeighbours.end()), toNeighbours.end());
+            size_t commonNeighbourCount = 0;
+            for (uint32_t vertex : fromNeighbours)
+            {
+                if (vertex != candidate.To && std::binary_search(toNeighbours.begin(), toNeighbours.end(), vertex))
+                    commonNeighbourCount++;
+            }
+            if (commonNeighbourCount != sharedTriangleCount)
+                continue;
+
+            for (uint32_t triangle : vertexTriangles[candidate.From])
+            {
+                if (isTriangleRemoved[triangle])
+                    continue;
+
+                bool hasTo = false;
+                for (uint32_t i = 0; i < 3; i++)
+                    hasTo |= weld[corners[3 * triangle + i]] == candidate.To;
+                if (hasTo)
+                {
+                    isTriangleRemoved[triangle] = true;
+                    liveTriangleCount--;
+                    continue;
+                }
+
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    if (weld[corners[3 * triangle + i]] == candidate.From)
+                        corners[3 * triangle + i] = toCorner;
+                }
+                vertexTriangles[candidate.To].push_back(triangle);
+            }
+            vertexTriangles[candidate.From].clear();
+            quadrics[candidate.To].Add(quadrics[candidate.From]);
+            isCollapsed[candidate.From] = true;
+            versions[candidate.To]++;
+            error = std::max(error, candidate.Error);
+
+            std::vector<uint32_t>& toTriangles = vertexTriangles[candidate.To];
+            toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(), [&isTriangleRemoved](uint32_t triangle)
+            {
+                return isTriangleRemoved[triangle];
+            }), toTriangles.end());
+            for (uint32_t triangle : toTriangles)
+            {
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    uint32_t vertex = weld[corners[3 * triangle + i]];
+                    if (vertex == candidate.To)
+                        continue;
+                    PushCandidate(vertex, candidate.To);
+                    PushCandidate(candidate.To, vertex);
+                }
+            }
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(3 * liveTriangleCount);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            if (!isTriangleRemoved[triangle])
+                result.insert(result.end(), corners.begin() + 3 * triangle, corners.begin() + 3 * triangle + 3);
+        }
+        if (resultError != nullptr)
+            *resultError = std::sqrt(error);
+        return result;
+    }
+
+    struct SubMeshLodData
+    {
+        std::vector<uint32_t> Indices;
+        float Error = 0.0f;
+    };
+
+    void GenerateMeshLods(MeshData& mesh, const MeshLodInfo& info)
+    {
+        std::vector<std::vector<SubMeshLodData>> subMeshLods(mesh.SubMeshes.size());
+        GetThreadPool()->ParallelFor(mesh.SubMeshes.size(), [&mesh, &info, &subMeshLods](size_t subMeshIndex)
+        {
+            const SubMeshData& subMesh = mesh.SubMeshes[subMeshIndex];
+            const Vertex* vertices = mesh.Vertices.data() + subMesh.VertexOffset;
+            const uint32_t* indices = mesh.Indices.data() + subMesh.IndexOffset;
+            float maxError = info.MaxError * glm::length(subMesh.BoundsMax - subMesh.BoundsMin);
+
+            // every level is simplified from the previous one, so its error is bounded by the sum of the errors along the chain
+            std::vector<uint32_t> previous(indices, indices + subMesh.IndexCount);
+            float previousError = 0.0f;
+            for (uint32_t lod = 1; lod < info.MaxLodCount; lod++)
+            {
+                size_t targetIndexCount = 3 * size_t(previous.size() / 3 * info.ReductionRatio);
+                float error = 0.0f;
+                std::vector<uint32_t> simplified = SimplifyMesh(vertices, subMesh.VertexCount, previous.data(), previous.size(), targetIndexCount, maxError - previousError, &error);
+                // stop when locked vertices or the error bound leave too little to gain from another level
+                if (simplified.empty() || simplified.size() * 10 > previous.size() * 9)
+                    break;
+
+                OptimizeVertexCache(simplified.data(), simplified.size(), subMesh.VertexCount, info.CacheSize);
+                previousError += error;
+                subMeshLods[subMeshIndex].push_back(SubMeshLodData{ simplified, previousError });
+                previous = std::move(simplified);
+            }
+        });
+
+        for (size_t subMeshIndex = 0; subMeshIndex < mesh.SubMeshes.size(); subMeshIndex++)
+        {
+            SubMeshData& subMesh = mesh.SubMeshes[subMeshIndex];
+            subMesh.Lods.clear();
+            subMesh.Lods.push_back(SubMeshLod{ subMesh.IndexOffset, subMesh.IndexCount, 0.0f });
+
+            std::string triangleCounts = std::to_string(subMesh.IndexCount / 3);
+            for (const SubMeshLodData& lod : subMeshLods[subMeshIndex])
+            {
+                subMesh.Lods.push_back(SubMeshLod{ (uint32_t)mesh.Indices.size(), (uint32_t)lod.Indices.size(), lod.Error });
+                mesh.Indices.insert(mesh.Indices.end(), lod.Indices.begin(), lod.Indices.end());
+                triangleCounts += fmt::format(" -> {}", lod.Indices.size() / 3);
+            }
+            GetCurrentLogger()->LogInfo("MeshOptimizer", fmt::format("submesh `{}`: {} LODs, triangles {}",
+                subMesh.Name, subMesh.Lods.size(), triangleCounts));
+        }
+    }
+
+    uint32_t SelectMeshLod(const SubMeshData& subMesh, const glm::vec3& worldCenter, float worldScale, const LodSelectionInfo& info)
+    {
+        if (subMesh.Lods.size() < 2)
+            return 0;
+
+        float radius = 0.5f * glm::length(subMesh.BoundsMax - subMesh.BoundsMin) * worldScale;
+        float distance = glm::length(worldCenter - info.CameraPosition) - radius;
+        if (distance <= 0.0f)
+            return 0;
+
+        // projected size of the error at the closest point of the bounding sphere
+        float pixelsPerUnit = info.ProjectionScale * 0.5f * info.ViewportHeight / distance;
+        for (uint32_t lod = (uint32_t)subMesh.Lods.size() - 1; lod > 0; lod--)
+        {
+            if (subMesh.Lods[lod].Error * worldScale * pixelsPerUnit <= info.MaxScreenError)
+                return lod;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#include "MeshLoader.h"
+
+namespace VALX
+{
+    struct VertexCacheStats
+    {
+        // average cache miss ratio, transformed vertices per triangle (0.5 is the best case for regular grids, 3.0 is the worst)
+        float ACMR = 0.0f;
+        // average transformed vertex ratio, transformed vertices per referenced vertex (1.0 is optimal)
+        float ATVR = 0.0f;
+    };
+
+    struct MeshOptimizationInfo
+    {
+        uint32_t CacheSize = 16;
+        // soft cluster boundaries for overdraw sorting are inserted once a cluster ACMR drops below threshold * mesh ACMR
+        float OverdrawThreshold = 1.05f;
+        bool OptimizeVertexCache = true;
+        bool OptimizeOverdraw = true;
+        bool OptimizeVertexFetch = true;
+    };
+
+    struct MeshLodInfo
+    {
+        // including the source geometry
+        uint32_t MaxLodCount = 5;
+        // every level targets this fraction of the triangle count of the previous level
+        float ReductionRatio = 0.5f;
+        // maximum simplification error relative to the submesh bounds diagonal
+        float MaxError = 0.02f;
+        uint32_t CacheSize = 16;
+    };
+
+    struct LodSelectionInfo
+    {
+        glm::vec3 CameraPosition = glm::vec3(0.0f);
+        // 1 / tan(fovY / 2), which is projection[1][1] of a perspective matrix
+        float ProjectionScale = 1.0f;
+        float ViewportHeight = 1.0f;
+        // the coarsest level with a projected error below this number of pixels is selected
+        float MaxScreenError = 1.0f;
+    };
+
+    struct MeshOptimizationReport
+    {
+        std::string SubMeshName;
+        VertexCacheStats Before;
+        VertexCacheStats After;
+    };
+
+    VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize);
+
+    // Tipsify (Sander et al. 2007), returns the first triangle of every cluster separated by a dead-end, if clusters is not null
+    void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>* clusters = nullptr);
+    // reorders clusters produced by OptimizeVertexCache, so that triangles facing outwards from the mesh center are drawn first
+    void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount, const std::vector<uint32_t>& clusters, uint32_t cacheSize, float threshold);
+    // reorders vertices in the order of their first use, vertices which are not referenced are moved to the end
+    void OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, uint32_t* indices, size_t indexCount);
+
+    std::vector<MeshOptimizationReport> OptimizeMesh(MeshData& mesh, const MeshOptimizationInfo& info = MeshOptimizationInfo{});
+
+    // quadric error metric edge collapse (Garland and Heckbert 1997). Vertices are collapsed onto their neighbours, so the result
+    // references the input vertices only. Open borders and attribute seams are locked. maxError is an object space distance
+    std::vector<uint32_t> SimplifyMesh(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount, size_t targetIndexCount, float maxError, float* resultError = nullptr);
+    // appends index ranges of the simplified levels to MeshData::Indices and fills SubMeshData::Lods.
+    // should run after OptimizeMesh, as reordering vertices afterwards would only remap the indices of the source geometry
+    void GenerateMeshLods(MeshData& mesh, const MeshLodInfo& info = MeshLodInfo{});
+    // returns an index into SubMeshData::Lods, worldCenter and worldScale are the bounds center and the uniform scale of an instance
+    uint32_t SelectMeshLod(const SubMeshData& subMesh, const glm::vec3& worldCenter, float worldScale, const LodSelectionInfo& info);
+}
\ No newline at end of file
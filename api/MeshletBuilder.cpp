@@ -0,0 +1,162 @@
+#include "MeshletBuilder.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VALX
+{
+    constexpr uint32_t INVALID_MESHLET_SLOT = UINT32_MAX;
+
+    static void ComputeMeshletBounds(Meshlet& meshlet, const Vertex* vertices, const uint32_t* meshletVertices, const uint8_t* meshletTriangles)
+    {
+        glm::vec3 boundsMin = vertices[meshletVertices[0]].Position;
+        glm::vec3 boundsMax = boundsMin;
+        for (uint32_t i = 1; i < meshlet.VertexCount; i++)
+        {
+            boundsMin = glm::min(boundsMin, vertices[meshletVertices[i]].Position);
+            boundsMax = glm::max(boundsMax, vertices[meshletVertices[i]].Position);
+        }
+        meshlet.Center = (boundsMin + boundsMax) * 0.5f;
+        meshlet.Radius = 0.0f;
+        for (uint32_t i = 0; i < meshlet.VertexCount; i++)
+            meshlet.Radius = std::max(meshlet.Radius, glm::length(vertices[meshletVertices[i]].Position - meshlet.Center));
+
+        // the cone axis is the average triangle normal, the cone spread is given by the normal deviating the most from it
+        glm::vec3 normals[MAX_MESHLET_TRIANGLES];
+        glm::vec3 corners[MAX_MESHLET_TRIANGLES];
+        uint32_t normalCount = 0;
+        glm::vec3 normalSum = glm::vec3(0.0f);
+        for (uint32_t triangle = 0; triangle < meshlet.TriangleCount && normalCount < MAX_MESHLET_TRIANGLES; triangle++)
+        {
+            const glm::vec3& p0 = vertices[meshletVertices[meshletTriangles[3 * triangle + 0]]].Position;
+            const glm::vec3& p1 = vertices[meshletVertices[meshletTriangles[3 * triangle + 1]]].Position;
+            const glm::vec3& p2 = vertices[meshletVertices[meshletTriangles[3 * triangle + 2]]].Position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(normal);
+            if (length == 0.0f)
+                continue;
+
+            normals[normalCount] = normal / length;
+            corners[normalCount] = p0;
+            normalSum += normals[normalCount];
+            normalCount++;
+        }
+
+        meshlet.ConeApex = meshlet.Center;
+        meshlet.ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.ConeCutoff = 1.0f;
+        float normalSumLength = glm::length(normalSum);
+        if (normalCount == 0 || normalSumLength == 0.0f)
+            return;
+
+        glm::vec3 axis = normalSum / normalSumLength;
+        float minDot = 1.0f;
+        for (uint32_t i = 0; i < normalCount; i++)
+            minDot = std::min(minDot, glm::dot(normals[i], axis));
+
+        // cone wider than ~84 degrees, the test would never pass
+        if (minDot <= 0.1f)
+            return;
+
+        // the apex is moved back along the axis until it lies behind every triangle plane
+        float maxOffset = 0.0f;
+        for (uint32_t i = 0; i < normalCount; i++)
+        {
+            float offset = glm::dot(meshlet.Center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+            maxOffset = std::max(maxOffset, offset);
+        }
+
+        meshlet.ConeApex = meshlet.Center - axis * maxOffset;
+        meshlet.ConeAxis = axis;
+        meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+    static MeshletData BuildSubMeshMeshlets(const MeshData& mesh, uint32_t subMeshIndex, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        const SubMeshData& subMesh = mesh.SubMeshes[subMeshIndex];
+        const Vertex* vertices = mesh.Vertices.data() + subMesh.VertexOffset;
+        const uint32_t* indices = mesh.Indices.data() + subMesh.IndexOffset;
+
+        MeshletData result;
+        std::vector<uint32_t> meshletSlots(subMesh.VertexCount, INVALID_MESHLET_SLOT);
+        Meshlet meshlet;
+        meshlet.SubMeshIndex = subMeshIndex;
+
+        auto FlushMeshlet = [&]()
+        {
+            if (meshlet.TriangleCount == 0)
+                return;
+
+            ComputeMeshletBounds(meshlet, vertices, result.Vertices.data() + meshlet.VertexOffset, result.Triangles.data() + 3 * meshlet.TriangleOffset);
+            for (uint32_t i = 0; i < meshlet.VertexCount; i++)
+                meshletSlots[result.Vertices[meshlet.VertexOffset + i]] = INVALID_MESHLET_SLOT;
+            result.Meshlets.push_back(meshlet);
+
+            meshlet = Meshlet{ };
+            meshlet.SubMeshIndex = subMeshIndex;
+            meshlet.VertexOffset = static_cast<uint32_t>(result.Vertices.size());
+            meshlet.TriangleOffset = static_cast<uint32_t>(result.Triangles.size() / 3);
+        };
+
+        for (size_t i = 0; i + 2 < subMesh.IndexCount; i += 3)
+        {
+            const uint32_t triangle[3] = { indices[i + 0], indices[i + 1], indices[i + 2] };
+            uint32_t newVertexCount = 0;
+            for (uint32_t vertex : triangle)
+                newVertexCount += meshletSlots[vertex] == INVALID_MESHLET_SLOT ? 1 : 0;
+
+            if (meshlet.VertexCount + newVertexCount > maxVertices || meshlet.TriangleCount + 1 > maxTriangles)
+                FlushMeshlet();
+
+            for (uint32_t vertex : triangle)
+            {
+                if (meshletSlots[vertex] == INVALID_MESHLET_SLOT)
+                {
+                    meshletSlots[vertex] = meshlet.VertexCount++;
+                    result.Vertices.push_back(vertex);
+                }
+                result.Triangles.push_back(static_cast<uint8_t>(meshletSlots[vertex]));
+            }
+            meshlet.TriangleCount++;
+        }
+        FlushMeshlet();
+        return result;
+    }
+
+    MeshletData BuildMeshlets(const MeshData& mesh, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        VALX_ASSERT(maxVertices >= 3 && maxVertices <= 256);
+        VALX_ASSERT(maxTriangles >= 1 && maxTriangles <= MAX_MESHLET_TRIANGLES);
+
+        std::vector<MeshletData> subMeshMeshlets(mesh.SubMeshes.size());
+        GetThreadPool()->ParallelFor(mesh.SubMeshes.size(), [&mesh, &subMeshMeshlets, maxVertices, maxTriangles](size_t subMeshIndex)
+        {
+            subMeshMeshlets[subMeshIndex] = BuildSubMeshMeshlets(mesh, static_cast<uint32_t>(subMeshIndex), maxVertices, maxTriangles);
+        });
+
+        MeshletData result;
+        for (const MeshletData& meshlets : subMeshMeshlets)
+        {
+            uint32_t vertexOffset = static_cast<uint32_t>(result.Vertices.size());
+            uint32_t triangleOffset = static_cast<uint32_t>(result.Triangles.size() / 3);
+            for (Meshlet meshlet : meshlets.Meshlets)
+            {
+                meshlet.VertexOffset += vertexOffset;
+                meshlet.TriangleOffset += triangleOffset;
+                result.Meshlets.push_back(meshlet);
+            }
+            result.Vertices.insert(result.Vertices.end(), meshlets.Vertices.begin(), meshlets.Vertices.end());
+            result.Triangles.insert(result.Triangles.end(), meshlets.Triangles.begin(), meshlets.Triangles.end());
+        }
+
+        size_t triangleCount = result.Triangles.size() / 3;
+        GetCurrentLogger()->LogInfo("MeshletBuilder", fmt::format("mesh `{}`: {} meshlets, {:.1f} triangles and {:.1f} vertices per meshlet",
+            mesh.FilePath, result.Meshlets.size(),
+            result.Meshlets.empty() ? 0.0 : double(triangleCount) / result.Meshlets.size(),
+            result.Meshlets.empty() ? 0.0 : double(result.Vertices.size()) / result.Meshlets.size()));
+        return result;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MeshLoader.h"
+
+namespace VALX
+{
+    constexpr uint32_t MAX_MESHLET_VERTICES = 64;
+    // 124 instead of 128 keeps the packed triangle list of a full meshlet within 372 bytes, as recommended for mesh shading hardware
+    constexpr uint32_t MAX_MESHLET_TRIANGLES = 124;
+
+    struct Meshlet
+    {
+        uint32_t SubMeshIndex = 0;
+        // offset into MeshletData::Vertices
+        uint32_t VertexOffset = 0;
+        uint32_t VertexCount = 0;
+        // offset into MeshletData::Triangles in triangles, not bytes
+        uint32_t TriangleOffset = 0;
+        uint32_t TriangleCount = 0;
+        // bounding sphere in mesh space
+        glm::vec3 Center = glm::vec3(0.0f);
+        float Radius = 0.0f;
+        // all triangles are backfacing if dot(normalize(ConeApex - cameraPosition), ConeAxis) >= ConeCutoff
+        glm::vec3 ConeApex = glm::vec3(0.0f);
+        glm::vec3 ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        // 1.0 if the normals are spread too far to ever cull the meshlet
+        float ConeCutoff = 1.0f;
+    };
+
+    struct MeshletData
+    {
+        std::vector<Meshlet> Meshlets;
+        // vertex indices relative to the VertexOffset of the meshlet submesh
+        std::vector<uint32_t> Vertices;
+        // three indices into the meshlet vertex list per triangle
+        std::vector<uint8_t> Triangles;
+    };
+
+    // splits the source geometry (Lods[0]) of every submesh into meshlets in index order, so the index buffer should be
+    // optimized for vertex cache first (see OptimizeMesh) to keep meshlets spatially coherent
+    MeshletData BuildMeshlets(const MeshData& mesh, uint32_t maxVertices = MAX_MESHLET_VERTICES, uint32_t maxTriangles = MAX_MESHLET_TRIANGLES);
+}
@@ -0,0 +1,638 @@
+#include "MipBuilder.h"
+#include "TextureLoader.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "SIMD.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace VALX
+{
+    constexpr uint32_t MIP_ROW_BLOCK_SIZE = 16;
+    constexpr double KAISER_ALPHA = 4.0;
+    constexpr double WINDOWED_SINC_RADIUS = 3.0;
+
+    enum class TexelStorage
+    {
+        UNORM8,
+        FLOAT16,
+        FLOAT32,
+        // three channels packed into 32 bits, converted a texel at a time
+        UFLOAT_R11G11B10,
+    };
+
+    struct MipTexelLayout
+    {
+        uint32_t ChannelCount = 0;
+        TexelStorage Storage = TexelStorage::UNORM8;
+        bool IsSRGB = false;
+    };
+
+    static bool GetMipTexelLayout(Format format, MipTexelLayout& layout)
+    {
+        layout.IsSRGB = IsSRGBFormat(format);
+        switch (GetLinearFormat(format))
+        {
+        case Format::R8_UNORM:
+            layout.ChannelCount = 1;
+            layout.Storage = TexelStorage::UNORM8;
+            return true;
+        case Format::R8G8_UNORM:
+            layout.ChannelCount = 2;
+            layout.Storage = TexelStorage::UNORM8;
+            return true;
+        case Format::R8G8B8_UNORM:
+        case Format::B8G8R8_UNORM:
+            layout.ChannelCount = 3;
+            layout.Storage = TexelStorage::UNORM8;
+            return true;
+        case Format::R8G8B8A8_UNORM:
+        case Format::B8G8R8A8_UNORM:
+            layout.ChannelCount = 4;
+            layout.Storage = TexelStorage::UNORM8;
+            return true;
+        case Format::R16G16B16A16_SFLOAT:
+            layout.ChannelCount = 4;
+            layout.Storage = TexelStorage::FLOAT16;
+            return true;
+        case Format::R32G32B32A32_SFLOAT:
+            layout.ChannelCount = 4;
+            layout.Storage = TexelStorage::FLOAT32;
+            return true;
+        case Format::B10G11R11_UFLOAT_PACK32:
+            layout.ChannelCount = 3;
+            layout.Storage = TexelStorage::UFLOAT_R11G11B10;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool IsMipBuildSupported(Format format)
+    {
+        MipTexelLayout layout;
+        return GetMipTexelLayout(format, layout);
+    }
+
+    // RGBA, 32 bit float per channel, color channels in linear space
+    struct FloatImage
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<float> Texels;
+
+        FloatImage() = default;
+        FloatImage(uint32_t width, uint32_t height)
+            : Width(width), Height(height), Texels(4 * size_t(width) * height) { }
+
+        float* GetRow(uint32_t y) { return this->Texels.data() + 4 * size_t(this->Width) * y; }
+        const float* GetRow(uint32_t y) const { return this->Texels.data() + 4 * size_t(this->Width) * y; }
+    };
+
+    static void ForEachRowBlock(uint32_t rowCount, bool multithreaded, const std::function<void(uint32_t, uint32_t)>& function)
+    {
+        size_t blockCount = (rowCount + MIP_ROW_BLOCK_SIZE - 1) / MIP_ROW_BLOCK_SIZE;
+        auto processBlock = [rowCount, &function](size_t block)
+        {
+            uint32_t begin = static_cast<uint32_t>(block) * MIP_ROW_BLOCK_SIZE;
+            function(begin, std::min(begin + MIP_ROW_BLOCK_SIZE, rowCount));
+        };
+
+        if (multithreaded)
+        {
+            GetThreadPool()->ParallelFor(blockCount, processBlock);
+        }
+        else
+        {
+            for (size_t block = 0; block < blockCount; block++)
+                processBlock(block);
+        }
+    }
+
+    static const std::array<float, 256>& GetSRGBToLinearTable()
+    {
+        static const std::array<float, 256> table = []()
+        {
+            std::array<float, 256> result = { };
+            for (size_t i = 0; i < result.size(); i++)
+            {
+                float value = float(i) / 255.0f;
+                result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    // linear values halfway between consecutive sRGB codes, encoding is a search instead of a pow per channel
+    static const std::array<float, 255>& GetLinearToSRGBThresholds()
+    {
+        static const std::array<float, 255> thresholds = []()
+        {
+            std::array<float, 255> result = { };
+            for (size_t i = 0; i < result.size(); i++)
+            {
+                double value = (i + 0.5) / 255.0;
+                result[i] = static_cast<float>(value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4));
+            }
+            return result;
+        }();
+        return thresholds;
+    }
+
+    static FloatImage DecodeMip(const uint8_t* bytes, uint32_t width, uint32_t height, const MipTexelLayout& layout, bool multithreaded)
+    {
+        FloatImage image(width, height);
+        const std::array<float, 256>& srgbTable = GetSRGBToLinearTable();
+
+        ForEachRowBlock(height, multithreaded, [&](uint32_t rowBegin, uint32_t rowEnd)
+        {
+            for (uint32_t y = rowBegin; y < rowEnd; y++)
+            {
+                float* row = image.GetRow(y);
+                for (uint32_t x = 0; x < width; x++)
+                {
+                    size_t texelIndex = size_t(y) * width + x;
+                    float texel[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                    if (layout.Storage == TexelStorage::UFLOAT_R11G11B10)
+                    {
+                        uint32_t packed = 0;
+                        std::memcpy(&packed, bytes + 4 * texelIndex, sizeof(packed));
+                        R11G11B10ToFloat(packed, texel[0], texel[1], texel[2]);
+                        std::memcpy(row + 4 * size_t(x), texel, sizeof(texel));
+                        continue;
+                    }
+                    for (uint32_t channel = 0; channel < layout.ChannelCount; channel++)
+                    {
+                        size_t index = texelIndex * layout.ChannelCount + channel;
+                        switch (layout.Storage)
+                        {
+                        case TexelStorage::UNORM8:
+                        {
+                            uint8_t value = bytes[index];
+                            texel[channel] = layout.IsSRGB && channel < 3 ? srgbTable[value] : float(value) / 255.0f;
+                            break;
+                        }
+                        case TexelStorage::FLOAT16:
+                        {
+                            uint16_t value = 0;
+                            std::memcpy(&value, bytes + 2 * index, sizeof(value));
+                            texel[channel] = HalfToFloat(value);
+                            break;
+                        }
+                        case TexelStorage::FLOAT32:
+                            std::memcpy(&texel[channel], bytes + 4 * index, sizeof(float));
+                            break;
+                        case TexelStorage::UFLOAT_R11G11B10:
+                            break;
+                        }
+                    }
+                    std::memcpy(row + 4 * size_t(x), texel, sizeof(texel));
+                }
+            }
+        });
+        return image;
+    }
+
+    static void EncodeMip(const FloatImage& image, const MipTexelLayout& layout, float alphaScale, bool multithreaded, uint8_t* bytes)
+    {
+        const std::array<float, 255>& srgbThresholds = GetLinearToSRGBThresholds();
+
+        ForEachRowBlock(image.Height, multithreaded, [&](uint32_t rowBegin, uint32_t rowEnd)
+        {
+            for (uint32_t y = rowBegin; y < rowEnd; y++)
+            {
+                const float* row = image.GetRow(y);
+                for (uint32_t x = 0; x < image.Width; x++)
+                {
+                    size_t texelIndex = size_t(y) * image.Width + x;
+                    if (layout.Storage == TexelStorage::UFLOAT_R11G11B10)
+                    {
+                        const float* texel = row + 4 * size_t(x);
+                        uint32_t packed = FloatToR11G11B10(texel[0], texel[1], texel[2]);
+                        std::memcpy(bytes + 4 * texelIndex, &packed, sizeof(packed));
+                        continue;
+                    }
+                    for (uint32_t channel = 0; channel < layout.ChannelCount; channel++)
+                    {
+                        size_t index = texelIndex * layout.ChannelCount + channel;
+                        float value = row[4 * size_t(x) + channel] * (channel == 3 ? alphaScale : 1.0f);
+                        switch (layout.Storage)
+                        {
+                        case TexelStorage::UNORM8:
+                            if (layout.IsSRGB && channel < 3)
+                            {
+                                auto code = std::upper_bound(srgbThresholds.begin(), srgbThresholds.end(), value) - srgbThresholds.begin();
+                                bytes[index] = static_cast<uint8_t>(code);
+                            }
+                            else
+                            {
+                                bytes[index] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+                            }
+                            break;
+                        case TexelStorage::FLOAT16:
+                        {
+                            uint16_t half = FloatToHalf(value);
+                            std::memcpy(bytes + 2 * index, &half, sizeof(half));
+                            break;
+                        }
+                        case TexelStorage::FLOAT32:
+                            std::memcpy(bytes + 4 * index, &value, sizeof(value));
+                            break;
+                        case TexelStorage::UFLOAT_R11G11B10:
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // filter kernels, one window of source texels per destination texel with normalized weights
+
+    struct FilterWindow
+    {
+        uint32_t First = 0;
+        uint32_t Count = 0;
+        uint32_t WeightOffset = 0;
+    };
+
+    struct FilterKernel
+    {
+        std::vector<FilterWindow> Windows;
+        std::vector<float> Weights;
+    };
+
+    static double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++)
+        {
+            double factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+        }
+        return sum;
+    }
+
+    static double Sinc(double x)
+    {
+        constexpr double PI = 3.14159265358979323846;
+        x *= PI;
+        return std::abs(x) < 1e-6 ? 1.0 : std::sin(x) / x;
+    }
+
+    // x is in destination texels
+    static double EvaluateFilter(MipFilter filter, double x)
+    {
+        x = std::abs(x);
+        if (x >= WINDOWED_SINC_RADIUS)
+            return 0.0;
+
+        switch (filter)
+        {
+        case MipFilter::KAISER:
+        {
+            double t = x / WINDOWED_SINC_RADIUS;
+            return Sinc(x) * BesselI0(KAISER_ALPHA * std::sqrt(1.0 - t * t)) / BesselI0(KAISER_ALPHA);
+        }
+        case MipFilter::LANCZOS3:
+            return Sinc(x) * Sinc(x / WINDOWED_SINC_RADIUS);
+        default:
+            VALX_ASSERT(false && "box filter weights are computed from texel coverage");
+            return 0.0;
+        }
+    }
+
+    static FilterKernel BuildFilterKernel(uint32_t sourceSize, uint32_t targetSize, MipFilter filter)
+    {
+        FilterKernel kernel;
+        kernel.Windows.resize(targetSize);
+
+        double scale = double(sourceSize) / double(targetSize);
+        double support = (filter == MipFilter::BOX ? 0.5 : WINDOWED_SINC_RADIUS) * scale;
+        std::vector<double> weights;
+        for (uint32_t target = 0; target < targetSize; target++)
+        {
+            double center = (target + 0.5) * scale;
+            int64_t first = static_cast<int64_t>(std::floor(center - support));
+            int64_t last = static_cast<int64_t>(std::ceil(center + support));
+            int64_t clampedFirst = std::max(first, int64_t(0));
+            int64_t clampedLast = std::min(last, int64_t(sourceSize));
+
+            // texels outside of the image are clamped to the edge, their weight goes to the border texel
+            weights.assign(static_cast<size_t>(clampedLast - clampedFirst), 0.0);
+            double total = 0.0;
+            for (int64_t source = first; source < last; source++)
+            {
+                double weight = 0.0;
+                if (filter == MipFilter::BOX)
+                    weight = std::max(0.0, std::min(source + 1.0, center + 0.5 * scale) - std::max(double(source), center - 0.5 * scale));
+                else
+                    weight = EvaluateFilter(filter, (source + 0.5 - center) / scale);
+
+                int64_t clamped = std::clamp(source, int64_t(0), int64_t(sourceSize) - 1);
+                weights[static_cast<size_t>(clamped - clampedFirst)] += weight;
+                total += weight;
+            }
+
+            FilterWindow& window = kernel.Windows[target];
+            window.First = static_cast<uint32_t>(clampedFirst);
+            window.Count = static_cast<uint32_t>(weights.size());
+            window.WeightOffset = static_cast<uint32_t>(kernel.Weights.size());
+            for (double weight : weights)
+                kernel.Weights.push_back(static_cast<float>(weight / total));
+        }
+        return kernel;
+    }
+
+    // scalar reference kernels
+
+    static void DownsampleBox2xRowScalar(const float* row0, const float* row1, float* target, uint32_t targetWidth)
+    {
+        for (uint32_t x = 0; x < targetWidth; x++)
+        {
+            for (uint32_t channel = 0; channel < 4; channel++)
+            {
+                size_t index = 8 * size_t(x) + channel;
+                target[4 * size_t(x) + channel] = (row0[index] + row0[index + 4] + row1[index] + row1[index + 4]) * 0.25f;
+            }
+        }
+    }
+
+    static void FilterRowScalar(const float* source, float* target, const FilterKernel& kernel)
+    {
+        for (size_t x = 0; x < kernel.Windows.size(); x++)
+        {
+            const FilterWindow& window = kernel.Windows[x];
+            const float* weights = kernel.Weights.data() + window.WeightOffset;
+            float sum[4] = { };
+            for (uint32_t k = 0; k < window.Count; k++)
+            {
+                const float* texel = source + 4 * size_t(window.First + k);
+                for (uint32_t channel = 0; channel < 4; channel++)
+                    sum[channel] += weights[k] * texel[channel];
+            }
+            std::memcpy(target + 4 * x, sum, sizeof(sum));
+        }
+    }
+
+    static void AccumulateRowScalar(float* target, const float* source, float weight, size_t floatCount)
+    {
+        for (size_t i = 0; i < floatCount; i++)
+            target[i] += weight * source[i];
+    }
+
+#if defined(VALX_SIMD_X86)
+    // SSE kernels, one RGBA texel per register
+
+    static void DownsampleBox2xRowSSE(const float* row0, const float* row1, float* target, uint32_t targetWidth)
+    {
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (uint32_t x = 0; x < targetWidth; x++)
+        {
+            size_t index = 8 * size_t(x);
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + index), _mm_loadu_ps(row0 + index + 4)),
+                _mm_add_ps(_mm_loadu_ps(row1 + index), _mm_loadu_ps(row1 + index + 4)));
+            _mm_storeu_ps(target + 4 * size_t(x), _mm_mul_ps(sum, quarter));
+        }
+    }
+
+    static void FilterRowSSE(const float* source, float* target, const FilterKernel& kernel)
+    {
+        for (size_t x = 0; x < kernel.Windows.size(); x++)
+        {
+            const FilterWindow& window = kernel.Windows[x];
+            const float* weights = kernel.Weights.data() + window.WeightOffset;
+            const float* texel = source + 4 * size_t(window.First);
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t k = 0; k < window.Count; k++)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(texel + 4 * size_t(k))));
+            _mm_storeu_ps(target + 4 * x, sum);
+        }
+    }
+
+    static void AccumulateRowSSE(float* target, const float* source, float weight, size_t floatCount)
+    {
+        const __m128 factor = _mm_set1_ps(weight);
+        for (size_t i = 0; i < floatCount; i += 4)
+            _mm_storeu_ps(target + i, _mm_add_ps(_mm_loadu_ps(target + i), _mm_mul_ps(factor, _mm_loadu_ps(source + i))));
+    }
+
+    // AVX2 kernels, two RGBA texels per register
+
+    VALX_TARGET_AVX2 static void DownsampleBox2xRowAVX2(const float* row0, const float* row1, float* target, uint32_t targetWidth)
+    {
+        const __m256 quarter = _mm256_set1_ps(0.25f);
+        uint32_t x = 0;
+        for (; x + 2 <= targetWidth; x += 2)
+        {
+            size_t index = 8 * size_t(x);
+            // texels 0 1 and 2 3 of both rows, vertical sums first, then pairs are regrouped to add horizontally
+            __m256 sum01 = _mm256_add_ps(_mm256_loadu_ps(row0 + index), _mm256_loadu_ps(row1 + index));
+            __m256 sum23 = _mm256_add_ps(_mm256_loadu_ps(row0 + index + 8), _mm256_loadu_ps(row1 + index + 8));
+            __m256 even = _mm256_permute2f128_ps(sum01, sum23, 0x20);
+            __m256 odd = _mm256_permute2f128_ps(sum01, sum23, 0x31);
+            _mm256_storeu_ps(target + 4 * size_t(x), _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+        }
+        if (x < targetWidth)
+            DownsampleBox2xRowSSE(row0 + 8 * size_t(x), row1 + 8 * size_t(x), target + 4 * size_t(x), targetWidth - x);
+    }
+
+    VALX_TARGET_AVX2 static void FilterRowAVX2(const float* source, float* target, const FilterKernel& kernel)
+    {
+        for (size_t x = 0; x < kernel.Windows.size(); x++)
+        {
+            const FilterWindow& window = kernel.Windows[x];
+            const float* weights = kernel.Weights.data() + window.WeightOffset;
+            const float* texel = source + 4 * size_t(window.First);
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t k = 0; k < window.Count; k++)
+                sum = _mm_fmadd_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(texel + 4 * size_t(k)), sum);
+            _mm_storeu_ps(target + 4 * x, sum);
+        }
+    }
+
+    VALX_TARGET_AVX2 static void AccumulateRowAVX2(float* target, const float* source, float weight, size_t floatCount)
+    {
+        const __m256 factor = _mm256_set1_ps(weight);
+        size_t i = 0;
+        for (; i + 8 <= floatCount; i += 8)
+            _mm256_storeu_ps(target + i, _mm256_fmadd_ps(factor, _mm256_loadu_ps(source + i), _mm256_loadu_ps(target + i)));
+        if (i < floatCount)
+            AccumulateRowSSE(target + i, source + i, weight, floatCount - i);
+    }
+#endif
+
+    static void DownsampleBox2xRow(SIMDLevel level, const float* row0, const float* row1, float* target, uint32_t targetWidth)
+    {
+#if defined(VALX_SIMD_X86)
+        if (level == SIMDLevel::AVX2)
+            return DownsampleBox2xRowAVX2(row0, row1, target, targetWidth);
+        if (level == SIMDLevel::SSE)
+            return DownsampleBox2xRowSSE(row0, row1, target, targetWidth);
+#endif
+        DownsampleBox2xRowScalar(row0, row1, target, targetWidth);
+    }
+
+    static void FilterRow(SIMDLevel level, const float* source, float* target, const FilterKernel& kernel)
+    {
+#if defined(VALX_SIMD_X86)
+        if (level == SIMDLevel::AVX2)
+            return FilterRowAVX2(source, target, kernel);
+        if (level == SIMDLevel::SSE)
+            return FilterRowSSE(source, target, kernel);
+#endif
+        FilterRowScalar(source, target, kernel);
+    }
+
+    static void AccumulateRow(SIMDLevel level, float* target, const float* source, float weight, size_t floatCount)
+    {
+#if defined(VALX_SIMD_X86)
+        if (level == SIMDLevel::AVX2)
+            return AccumulateRowAVX2(target, source, weight, floatCount);
+        if (level == SIMDLevel::SSE)
+            return AccumulateRowSSE(target, source, weight, floatCount);
+#endif
+        AccumulateRowScalar(target, source, weight, floatCount);
+    }
+
+    static void Downsample(const FloatImage& source, FloatImage& target, MipFilter filter, SIMDLevel level, bool multithreaded)
+    {
+        if (filter == MipFilter::BOX && source.Width == 2 * target.Width && source.Height == 2 * target.Height)
+        {
+            ForEachRowBlock(target.Height, multithreaded, [&](uint32_t rowBegin, uint32_t rowEnd)
+            {
+                for (uint32_t y = rowBegin; y < rowEnd; y++)
+                    DownsampleBox2xRow(level, source.GetRow(2 * y), source.GetRow(2 * y + 1), target.GetRow(y), target.Width);
+            });
+            return;
+        }
+
+        // separable filter, horizontal pass into an intermediate image, then weighted sums of its rows
+        FilterKernel horizontalKernel = BuildFilterKernel(source.Width, target.Width, filter);
+        FilterKernel verticalKernel = BuildFilterKernel(source.Height, target.Height, filter);
+        FloatImage horizontal(target.Width, source.Height);
+
+        ForEachRowBlock(source.Height, multithreaded, [&](uint32_t rowBegin, uint32_t rowEnd)
+        {
+            for (uint32_t y = rowBegin; y < rowEnd; y++)
+                FilterRow(level, source.GetRow(y), horizontal.GetRow(y), horizontalKernel);
+        });
+
+        ForEachRowBlock(target.Height, multithreaded, [&](uint32_t rowBegin, uint32_t rowEnd)
+        {
+            for (uint32_t y = rowBegin; y < rowEnd; y++)
+            {
+                float* row = target.GetRow(y);
+                std::fill(row, row + 4 * size_t(target.Width), 0.0f);
+                const FilterWindow& window = verticalKernel.Windows[y];
+                for (uint32_t k = 0; k < window.Count; k++)
+                    AccumulateRow(level, row, horizontal.GetRow(window.First + k), verticalKernel.Weights[window.WeightOffset + k], 4 * size_t(target.Width));
+            }
+        });
+    }
+
+    // alpha coverage preservation (Castaño, "Computing alpha mipmaps")
+
+    static float ComputeAlphaCoverage(const FloatImage& image, float threshold)
+    {
+        size_t texelCount = size_t(image.Width) * image.Height;
+        size_t coveredCount = 0;
+        for (size_t i = 0; i < texelCount; i++)
+            coveredCount += image.Texels[4 * i + 3] > threshold ? 1 : 0;
+        return float(coveredCount) / float(texelCount);
+    }
+
+    static float FindAlphaScale(const FloatImage& image, float threshold, float coverage)
+    {
+        size_t texelCount = size_t(image.Width) * image.Height;
+        size_t targetCount = static_cast<size_t>(std::lround(coverage * texelCount));
+
+        std::vector<float> alphas(texelCount);
+        for (size_t i = 0; i < texelCount; i++)
+            alphas[i] = image.Texels[4 * i + 3];
+
+        if (targetCount == 0)
+        {
+            float maxAlpha = *std::max_element(alphas.begin(), alphas.end());
+            return maxAlpha > threshold ? threshold / maxAlpha : 1.0f;
+        }
+
+        // the scale lifts the targetCount-th largest alpha just above the threshold
+        std::nth_element(alphas.begin(), alphas.begin() + (targetCount - 1), alphas.end(), std::greater<float>());
+        float alpha = alphas[targetCount - 1];
+        if (alpha <= 0.0f)
+            return 1.0f;
+        return threshold / alpha * 1.001f;
+    }
+
+    void BuildMips(TextureData& texture, const MipBuildInfo& info)
+    {
+        MipTexelLayout layout;
+        if (!GetMipTexelLayout(texture.TextureFormat, layout) || texture.Type == TextureType::TEXTURE_3D || texture.Depth > 1)
+        {
+            GetCurrentLogger()->LogWarning("MipBuilder", fmt::format("texture `{}`: mips can not be built for format {} and type {}",
+                texture.FilePath, (int)texture.TextureFormat, (int)texture.Type));
+            return;
+        }
+        VALX_ASSERT(texture.MipCount > 0 && texture.Subresources.size() >= size_t(texture.Layers) * texture.MipCount);
+
+        uint32_t fullMipCount = GetMipLevelCount(std::max(texture.Width, texture.Height));
+        uint32_t mipCount = info.MipCount == ALL_MIPS ? fullMipCount : std::min(info.MipCount, fullMipCount);
+        SIMDLevel level = info.UseSIMD ? GetSIMDLevel() : SIMDLevel::SCALAR;
+        bool preserveCoverage = info.AlphaCoverageThreshold > 0.0f && layout.ChannelCount == 4;
+        auto startTime = std::chrono::steady_clock::now();
+
+        // the chain gets a new layout, only the top mips are carried over
+        std::vector<uint8_t> sourceBytes = std::move(texture.Bytes);
+        std::vector<TextureSubresource> sourceSubresources = std::move(texture.Subresources);
+        uint32_t sourceMipCount = texture.MipCount;
+        texture.MipCount = mipCount;
+        texture.AllocateSubresources();
+        for (uint32_t layer = 0; layer < texture.Layers; layer++)
+        {
+            const TextureSubresource& source = sourceSubresources[size_t(layer) * sourceMipCount];
+            std::memcpy(texture.GetSubresourceData(layer, 0), sourceBytes.data() + source.Offset, source.Size);
+        }
+        sourceBytes = {};
+
+        auto buildLayer = [&](size_t layerIndex)
+        {
+            uint32_t layer = static_cast<uint32_t>(layerIndex);
+            FloatImage current = DecodeMip(texture.GetSubresourceData(layer, 0), texture.Width, texture.Height, layout, info.Multithreaded);
+            float coverage = preserveCoverage ? ComputeAlphaCoverage(current, info.AlphaCoverageThreshold) : 0.0f;
+            for (uint32_t mip = 1; mip < mipCount; mip++)
+            {
+                FloatImage next(std::max(texture.Width >> mip, 1u), std::max(texture.Height >> mip, 1u));
+                Downsample(current, next, info.Filter, level, info.Multithreaded);
+
+                // the scale only applies to the stored mip, the next one is filtered from unscaled alpha
+                float alphaScale = preserveCoverage ? FindAlphaScale(next, info.AlphaCoverageThreshold, coverage) : 1.0f;
+                EncodeMip(next, layout, alphaScale, info.Multithreaded, texture.GetSubresourceData(layer, mip));
+                current = std::move(next);
+            }
+        };
+
+        if (info.Multithreaded)
+        {
+            GetThreadPool()->ParallelFor(texture.Layers, buildLayer);
+        }
+        else
+        {
+            for (size_t layer = 0; layer < texture.Layers; layer++)
+                buildLayer(layer);
+        }
+
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+        GetCurrentLogger()->LogInfo("MipBuilder", fmt::format("texture `{}`: {} mips for {} layers built in {:.2f} ms ({}, {})",
+            texture.FilePath, mipCount, texture.Layers, elapsed.count(), GetSIMDLevelName(level), info.Multithreaded ? "multithreaded" : "single threaded"));
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Texture.h"
+
+namespace VALX
+{
+    struct TextureData;
+
+    enum class MipFilter
+    {
+        // exact area average, cheapest but soft and prone to aliasing on odd sizes
+        BOX,
+        // windowed sinc with a Kaiser window (alpha 4, 3 texel radius), sharp with little ringing
+        KAISER,
+        LANCZOS3,
+    };
+
+    struct MipBuildInfo
+    {
+        MipFilter Filter = MipFilter::KAISER;
+        // number of mips of the result including the top one, ALL_MIPS builds the full chain
+        uint32_t MipCount = ALL_MIPS;
+        // for alpha tested textures: the alpha of every mip is scaled so the share of texels above this threshold
+        // stays the same as in the top mip, 0 disables
+        float AlphaCoverageThreshold = 0.0f;
+        // false selects the scalar reference kernels
+        bool UseSIMD = true;
+        bool Multithreaded = true;
+    };
+
+    // 8 bit UNORM / SRGB formats with 1 to 4 channels, R16G16B16A16_SFLOAT, R32G32B32A32_SFLOAT and B10G11R11_UFLOAT_PACK32
+    bool IsMipBuildSupported(Format format);
+
+    // rebuilds every mip below the first one of every layer of a 2D, array or cube texture,
+    // the color channels of sRGB formats are filtered in linear space
+    void BuildMips(TextureData& texture, const MipBuildInfo& info = {});
+}
@@ -0,0 +1,53 @@
+#include "SIMD.h"
+
+#if defined(VALX_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace VALX
+{
+    static SIMDLevel DetectSIMDLevel()
+    {
+#if defined(VALX_SIMD_X86)
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int registers[4] = { };
+        __cpuid(registers, 0);
+        int maxLeaf = registers[0];
+        __cpuid(registers, 1);
+        bool hasOSAVX = (registers[2] & (1 << 27)) != 0 && (registers[2] & (1 << 28)) != 0 && (registers[2] & (1 << 12)) != 0 && (_xgetbv(0) & 6) == 6;
+        bool hasF16C = (registers[2] & (1 << 29)) != 0;
+        bool hasAVX2 = false;
+        if (hasOSAVX && hasF16C && maxLeaf >= 7)
+        {
+            __cpuidex(registers, 7, 0);
+            hasAVX2 = (registers[1] & (1 << 5)) != 0;
+        }
+        return hasAVX2 ? SIMDLevel::AVX2 : SIMDLevel::SSE;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c") ? SIMDLevel::AVX2 : SIMDLevel::SSE;
+    #endif
+#else
+        return SIMDLevel::SCALAR;
+#endif
+    }
+
+    SIMDLevel GetSIMDLevel()
+    {
+        static const SIMDLevel level = DetectSIMDLevel();
+        return level;
+    }
+
+    const char* GetSIMDLevelName(SIMDLevel level)
+    {
+        switch (level)
+        {
+        case SIMDLevel::SSE:
+            return "SSE";
+        case SIMDLevel::AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+        }
+    }
+}
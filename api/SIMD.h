@@ -0,0 +1,28 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define VALX_SIMD_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        // MSVC emits AVX2 instructions for intrinsics without per-function target attributes
+        #define VALX_TARGET_AVX2
+    #else
+        #define VALX_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+    #endif
+#endif
+
+namespace VALX
+{
+    // SSE2 is the x86 baseline, AVX2 kernels are compiled with VALX_TARGET_AVX2 and selected at runtime. The AVX2 level
+    // includes FMA and F16C, which every AVX2 CPU has
+    enum class SIMDLevel
+    {
+        SCALAR,
+        SSE,
+        AVX2,
+    };
+
+    // highest level supported by the CPU, detected once
+    SIMDLevel GetSIMDLevel();
+    const char* GetSIMDLevelName(SIMDLevel level);
+}
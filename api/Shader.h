@@ -2,15 +2,27 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "ShaderStage.h"
+#include "Sampler.h"
 
 namespace VALX
 {
+    // sampler baked into the descriptor set layout for a sampler or combined image sampler binding, descriptor
+    // writes to that binding only provide the image
+    struct ImmutableSamplerInfo
+    {
+        uint32_t Set = 0;
+        uint32_t Binding = 0;
+        SamplerInfo Sampler;
+    };
+
     struct ShaderInfo
     {
         std::string Name;
         std::vector<ShaderStageInfo> Stages;
+        std::vector<ImmutableSamplerInfo> ImmutableSamplers;
     };
 
     class Shader
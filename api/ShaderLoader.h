@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ShaderStage.h"
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace VALX
 {
@@ -11,12 +13,36 @@ namespace VALX
         HLSL,
     };
 
+    // prepended to the source as `#define Name Value`, an empty value defines the name only
+    struct ShaderDefine
+    {
+        std::string Name;
+        std::string Value;
+    };
+
+    struct ShaderCacheStatistics
+    {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        // spent compiling the sources that missed the cache
+        double CompileMilliseconds = 0.0;
+
+        double GetHitRate() const { return this->Hits + this->Misses > 0 ? double(this->Hits) / double(this->Hits + this->Misses) : 0.0; }
+    };
+
     class ShaderLoader
     {
     public:
-        virtual ShaderStageInfo LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language) = 0;
+        virtual ShaderStageInfo LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines = {}) = 0;
         virtual ShaderStageInfo LoadFromBinaryFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language) = 0;
-        virtual ShaderStageInfo LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language) = 0;
+        virtual ShaderStageInfo LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines = {}) = 0;
+
+        // compiled bytecode is stored in and read back from this directory, keyed by the hash of the source, stage, language,
+        // target environment and defines. An empty path disables the cache
+        virtual void SetCacheDirectory(const std::string& directory) = 0;
+        virtual const std::string& GetCacheDirectory() const = 0;
+        virtual ShaderCacheStatistics GetCacheStatistics() const = 0;
+        virtual void ResetCacheStatistics() = 0;
 
         virtual ~ShaderLoader() = default;
     };
@@ -5,6 +5,7 @@
 #include "TextureType.h"
 
 #include <string>
+#include <algorithm>
 
 namespace VALX
 {
@@ -28,10 +29,13 @@ namespace VALX
         STORAGE = 1 << 3,
         COLOR_ATTACHMENT = 1 << 4,
         DEPTH_STENCIL_ATTACHMENT = 1 << 5,
+        // adds the usage needed to generate mips on the GPU, see TextureUploadInfo::GenerateMips, not valid for block-compressed formats
+        GENERATE_MIPS = 1 << 6,
     };
     VALX_GENERATE_ENUM_OPS(TextureFlags)
 
     constexpr uint32_t ALL_MIPS = 0;
+    constexpr uint32_t ALL_LAYERS = 0;
 
     struct TextureInfo
     {
@@ -45,6 +49,87 @@ namespace VALX
         uint32_t Depth = 1;
         uint32_t Layers = 1;
         uint32_t Mips = 1;
+        // the first row of the uploaded data is the top of the image, such textures are sampled with a flipped v coordinate.
+        // Taken from TextureData::TopDown, it does not change how the texture is created
+        bool TopDown = false;
+    };
+
+    inline uint32_t GetTextureMipCount(const TextureInfo& info)
+    {
+        return info.Mips == ALL_MIPS ? GetMipLevelCount(std::max({ info.Width, info.Height, info.Depth })) : info.Mips;
+    }
+
+    // one mip of one layer inside a byte blob, converts one to one to a buffer to image copy region
+    struct TextureSubresource
+    {
+        size_t Offset = 0;
+        size_t Size = 0;
+        uint32_t Layer = 0;
+        uint32_t Mip = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Depth = 0;
+    };
+
+    enum class TextureViewType
+    {
+        // 2D, 2D array, 3D, cube or cube array after the texture type and the layers the view covers
+        DEFAULT,
+        TEXTURE_2D,
+        TEXTURE_2D_ARRAY,
+        TEXTURE_3D,
+        TEXTURE_CUBE,
+        TEXTURE_CUBE_ARRAY,
+    };
+
+    enum class TextureAspect
+    {
+        // every aspect of the format, depth stencil views for sampling have to pick one
+        DEFAULT,
+        COLOR,
+        DEPTH,
+        STENCIL,
+    };
+
+    enum class ComponentSwizzle
+    {
+        IDENTITY,
+        ZERO,
+        ONE,
+        R,
+        G,
+        B,
+        A,
+    };
+
+    struct TextureViewInfo
+    {
+        TextureViewType Type = TextureViewType::DEFAULT;
+        // UNKNOWN keeps the texture format, others need a texture created for views of other formats
+        Format ViewFormat = Format::UNKNOWN;
+        uint32_t BaseMip = 0;
+        // ALL_MIPS and ALL_LAYERS cover the rest of the texture from the base
+        uint32_t MipCount = ALL_MIPS;
+        uint32_t BaseLayer = 0;
+        uint32_t LayerCount = ALL_LAYERS;
+        TextureAspect Aspect = TextureAspect::DEFAULT;
+        ComponentSwizzle SwizzleR = ComponentSwizzle::IDENTITY;
+        ComponentSwizzle SwizzleG = ComponentSwizzle::IDENTITY;
+        ComponentSwizzle SwizzleB = ComponentSwizzle::IDENTITY;
+        ComponentSwizzle SwizzleA = ComponentSwizzle::IDENTITY;
+
+        bool operator==(const TextureViewInfo& other) const
+        {
+            return this->Type == other.Type && this->ViewFormat == other.ViewFormat && this->BaseMip == other.BaseMip && this->MipCount == other.MipCount &&
+                this->BaseLayer == other.BaseLayer && this->LayerCount == other.LayerCount && this->Aspect == other.Aspect &&
+                this->SwizzleR == other.SwizzleR && this->SwizzleG == other.SwizzleG && this->SwizzleB == other.SwizzleB && this->SwizzleA == other.SwizzleA;
+        }
+    };
+
+    struct TextureUploadInfo
+    {
+        // fills the mips missing from the uploaded data from its last mip, the texture needs TextureFlags::GENERATE_MIPS
+        bool GenerateMips = false;
     };
 
     class Texture
@@ -54,6 +139,9 @@ namespace VALX
 
         virtual const TextureInfo& GetInfo() const = 0;
         virtual Texture::Handle GetHandle() const = 0;
+        // view of a range of the texture, created on the first request and kept until the texture is destroyed. The default
+        // covers the whole texture
+        virtual Texture::Handle GetView(const TextureViewInfo& view = {}) const = 0;
         virtual ~Texture() = default;
     };
 }
\ No newline at end of file
@@ -1,13 +1,33 @@
 #include "TextureLoader.h"
 #include "Utilities.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "Hash.h"
+#include <glm/glm.hpp>
 #include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <climits>
+#include <numeric>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// only for stbi_zlib_compress, which deflates the chunks of WriteChunkedZLIB
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
 #define TINYDDSLOADER_IMPLEMENTATION
 #include <tinyddsloader.h>
 
+#if defined(VALX_WITH_ZSTD)
+#include <zstd.h>
+#endif
+#if defined(VALX_WITH_BASIS_UNIVERSAL)
+#include <basisu_transcoder.h>
+#include <mutex>
+#endif
+
 namespace VALX
 {
     static bool IsDDSImage(const std::string& filepath)
@@ -20,6 +40,52 @@ namespace VALX
         return std::filesystem::path(filepath).extension() == ".zlib";
     }
 
+    size_t GetTextureSubresourceAlignment(Format format)
+    {
+        return std::lcm(size_t(16), size_t(GetPixelByteSize(format)));
+    }
+
+    size_t ComputeTextureSubresources(Format format, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipCount, uint32_t layers,
+        std::vector<TextureSubresource>& subresources)
+    {
+        size_t alignment = GetTextureSubresourceAlignment(format);
+        size_t offset = 0;
+        subresources.resize(size_t(layers) * mipCount);
+        for (uint32_t layer = 0; layer < layers; layer++)
+        {
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+            {
+                TextureSubresource& subresource = subresources[size_t(layer) * mipCount + mip];
+                subresource.Layer = layer;
+                subresource.Mip = mip;
+                subresource.Width = std::max(width >> mip, 1u);
+                subresource.Height = std::max(height >> mip, 1u);
+                subresource.Depth = std::max(depth >> mip, 1u);
+                subresource.Size = GetImageByteSize(format, subresource.Width, subresource.Height, subresource.Depth);
+                subresource.Offset = (offset + alignment - 1) / alignment * alignment;
+                offset = subresource.Offset + subresource.Size;
+            }
+        }
+        return offset;
+    }
+
+    void TextureData::AllocateSubresources()
+    {
+        size_t byteSize = ComputeTextureSubresources(this->TextureFormat, this->Width, this->Height, std::max(this->Depth, 1u), this->MipCount, this->Layers, this->Subresources);
+        this->Bytes.assign(byteSize, 0);
+    }
+
+    static bool ReadFileBytes(const std::string& filepath, std::vector<uint8_t>& bytes)
+    {
+        std::ifstream file(filepath, std::ifstream::binary | std::ifstream::ate);
+        if (!file.good()) return false;
+
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+        return file.good();
+    }
+
     static TextureType ConvertTextureType(const tinyddsloader::DDSFile& dds)
     {
         if (dds.IsCubemap())
@@ -277,14 +343,15 @@ namespace VALX
         }
     }
 
-    static TextureData LoadImageUsingDDSLoader(const std::string& filepath)
+    // rows are kept in file order like in MapDDSFile, the flip is left to the v coordinate. Shuffling the rows of block
+    // compressed data would mean reordering every block as well
+    static TextureData LoadImageUsingDDSLoader(const std::string& filepath, std::vector<uint8_t>&& bytes)
     {
         tinyddsloader::DDSFile dds;
-        auto loadResult = dds.Load(filepath.c_str());
+        auto loadResult = dds.Load(std::move(bytes));
         if (loadResult != tinyddsloader::Result::Success)
             return TextureData{};
 
-        dds.Flip();
         auto imageData = dds.GetImageData();
 
         TextureData result;
@@ -297,60 +364,155 @@ namespace VALX
         result.TextureFormat = ConvertDDSFormat(dds.GetFormat());
         result.Depth = imageData->m_depth;
         result.Type = ConvertTextureType(dds);
+        result.TopDown = true;
 
-        result.Data.Layers.resize(dds.GetArraySize());
-        for (uint32_t layer = 0; layer < result.Data.Layers.size(); layer++)
+        result.AllocateSubresources();
+        for (uint32_t layer = 0; layer < result.Layers; layer++)
         {
-            TextureData::LayerData& layerData = result.Data.Layers[layer];
-            layerData.Mips.resize(dds.GetMipCount());
-            for (uint32_t mip = 0; mip < layerData.Mips.size(); mip++)
+            for (uint32_t mip = 0; mip < result.MipCount; mip++)
             {
-                TextureData::MipData& mipData = layerData.Mips[mip];
                 const tinyddsloader::DDSFile::ImageData* image = dds.GetImageData(mip, layer);
-                mipData.Bytes.assign(static_cast<char*>(image->m_mem), static_cast<char*>(image->m_mem) + image->m_memSlicePitch);
+                size_t imageSize = std::min(result.GetSubresource(layer, mip).Size, size_t(image->m_memSlicePitch) * image->m_depth);
+                std::memcpy(result.GetSubresourceData(layer, mip), image->m_mem, imageSize);
             }
         }
 
         return result;
     }
 
-    static std::string ConvertZLIBToDDS(const std::string& filepath)
+    // a .zlib texture is either one zlib stream of a whole .dds file, or a chunked container that starts with
+    // ChunkedZLIBHeader, followed by a ChunkedZLIBEntry per chunk and the chunks themselves. Every chunk is an
+    // independent zlib stream of a consecutive part of the .dds file, so they can be inflated in parallel
+    static constexpr uint32_t CHUNKED_ZLIB_MAGIC = 0x435a5856; // "VXZC"
+    static constexpr uint32_t CHUNKED_ZLIB_VERSION = 1;
+
+    struct ChunkedZLIBHeader
     {
-        std::ifstream file(filepath, std::ifstream::binary);
-        if (!file.good()) return filepath;
+        uint32_t Magic = CHUNKED_ZLIB_MAGIC;
+        uint32_t Version = CHUNKED_ZLIB_VERSION;
+        uint32_t ChunkCount = 0;
+        uint32_t Padding = 0;
+        uint64_t UncompressedSize = 0;
+    };
 
-        std::vector<char> compressedData{
-            std::istreambuf_iterator<char>(file),
-            std::istreambuf_iterator<char>()
-        };
+    struct ChunkedZLIBEntry
+    {
+        // from the start of the file
+        uint64_t CompressedOffset = 0;
+        uint32_t CompressedSize = 0;
+        uint32_t UncompressedSize = 0;
+    };
 
-        int decompressedSize = 0;
-        char* decompressedData = stbi_zlib_decode_malloc(compressedData.data(), (int)compressedData.size(), &decompressedSize);
+    static bool IsChunkedZLIB(const std::vector<uint8_t>& bytes)
+    {
+        uint32_t magic = 0;
+        if (bytes.size() >= sizeof(ChunkedZLIBHeader))
+            std::memcpy(&magic, bytes.data(), sizeof(magic));
+        return magic == CHUNKED_ZLIB_MAGIC;
+    }
 
-        std::filesystem::path path(filepath);
-        auto ddsFilepath = (path.parent_path() / path.stem()).string() + ".dds";
-        std::ofstream ddsFile(ddsFilepath, std::ofstream::binary);
-        ddsFile.write(decompressedData, decompressedSize);
-        free(decompressedData);
+    // every chunk inflates straight into its place in the output, the sizes come from the chunk table
+    static bool InflateChunkedZLIB(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& decompressed)
+    {
+        ChunkedZLIBHeader header;
+        std::memcpy(&header, compressed.data(), sizeof(header));
+        if (header.Version != CHUNKED_ZLIB_VERSION || compressed.size() < sizeof(header) + size_t(header.ChunkCount) * sizeof(ChunkedZLIBEntry))
+            return false;
 
-        return ddsFilepath;
+        std::vector<ChunkedZLIBEntry> entries(header.ChunkCount);
+        std::vector<size_t> outputOffsets(header.ChunkCount);
+        std::memcpy(entries.data(), compressed.data() + sizeof(header), entries.size() * sizeof(ChunkedZLIBEntry));
+
+        size_t outputOffset = 0;
+        for (uint32_t chunk = 0; chunk < header.ChunkCount; chunk++)
+        {
+            const ChunkedZLIBEntry& entry = entries[chunk];
+            if (entry.CompressedOffset > compressed.size() || entry.CompressedSize > compressed.size() - entry.CompressedOffset)
+                return false;
+            outputOffsets[chunk] = outputOffset;
+            outputOffset += entry.UncompressedSize;
+        }
+        if (outputOffset != header.UncompressedSize)
+            return false;
+
+        decompressed.resize(header.UncompressedSize);
+        std::atomic<bool> succeeded{ true };
+        GetThreadPool()->ParallelFor(entries.size(), [&](size_t chunk)
+        {
+            const ChunkedZLIBEntry& entry = entries[chunk];
+            int size = stbi_zlib_decode_buffer(reinterpret_cast<char*>(decompressed.data() + outputOffsets[chunk]), (int)entry.UncompressedSize,
+                reinterpret_cast<const char*>(compressed.data() + entry.CompressedOffset), (int)entry.CompressedSize);
+            if (size != (int)entry.UncompressedSize)
+                succeeded = false;
+        });
+        return succeeded;
     }
 
-    static TextureData LoadImageUsingZLIBLoader(const std::string& filepath)
+    // high dynamic range images are decoded to RGBA floats, which are converted in blocks of rows on the thread pool
+    static TextureData LoadHDRImageUsingSTBLoader(const std::string& filepath, const std::vector<uint8_t>& bytes, bool flipVertically, Format format)
     {
-        auto ddsFilepath = ConvertZLIBToDDS(filepath);
-        return LoadImageUsingDDSLoader(ddsFilepath);
+        if (format != Format::R16G16B16A16_SFLOAT && format != Format::B10G11R11_UFLOAT_PACK32 && format != Format::R32G32B32A32_SFLOAT)
+        {
+            GetCurrentLogger()->LogWarning("TextureLoader", fmt::format("`{}`: HDR format {} is not supported, using R16G16B16A16_SFLOAT", filepath, (uint32_t)format));
+            format = Format::R16G16B16A16_SFLOAT;
+        }
+
+        int width = 0, height = 0, channels = 0;
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
+        float* data = stbi_loadf_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &channels, STBI_rgb_alpha);
+        if (data == nullptr)
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot decode `{}`: {}", filepath, stbi_failure_reason()));
+            return TextureData{};
+        }
+
+        TextureData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.Width = static_cast<uint32_t>(width);
+        result.Height = static_cast<uint32_t>(height);
+        result.Depth = 1;
+        result.Layers = 1;
+        result.MipCount = 1;
+        result.Type = TextureType::TEXTURE_2D;
+        result.TextureFormat = format;
+        result.TopDown = !flipVertically;
+        result.AllocateSubresources();
+
+        constexpr size_t TEXELS_PER_BLOCK = 64 * 1024;
+        const size_t texelCount = size_t(width) * size_t(height);
+        const size_t blockCount = (texelCount + TEXELS_PER_BLOCK - 1) / TEXELS_PER_BLOCK;
+        uint8_t* target = result.GetSubresourceData(0, 0);
+        GetThreadPool()->ParallelFor(blockCount, [&](size_t block)
+        {
+            const size_t first = block * TEXELS_PER_BLOCK;
+            const size_t count = std::min(TEXELS_PER_BLOCK, texelCount - first);
+            const float* source = data + first * 4;
+            if (format == Format::R16G16B16A16_SFLOAT)
+                ConvertFloatToHalf(source, reinterpret_cast<uint16_t*>(target) + first * 4, count * 4);
+            else if (format == Format::B10G11R11_UFLOAT_PACK32)
+                ConvertFloatToR11G11B10(source, reinterpret_cast<uint32_t*>(target) + first, count);
+            else
+                std::memcpy(target + first * 4 * sizeof(float), source, count * 4 * sizeof(float));
+        });
+        stbi_image_free(data);
+        return result;
     }
 
-    static TextureData LoadImageUsingSTBLoader(const std::string& filepath)
+    static TextureData LoadImageUsingSTBLoader(const std::string& filepath, const std::vector<uint8_t>& bytes, bool flipVertically, Format hdrFormat)
     {
-        int width = 0, height = 0, channels = 0;
+        if (stbi_is_hdr_from_memory(bytes.data(), (int)bytes.size()))
+            return LoadHDRImageUsingSTBLoader(filepath, bytes, flipVertically, hdrFormat);
 
-        stbi_set_flip_vertically_on_load(true);
-        uint8_t* data = stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-        stbi_set_flip_vertically_on_load(false);
+        int width = 0, height = 0, channels = 0;
 
-        uint32_t dataSize = width * height * GetPixelByteSize(Format::R8G8B8A8_UNORM);
+        // the process wide flip setting would race with loads on other threads
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
+        uint8_t* data = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &channels, STBI_rgb_alpha);
+        if (data == nullptr)
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot decode `{}`: {}", filepath, stbi_failure_reason()));
+            return TextureData{};
+        }
 
         TextureData result;
         result.FilePath = std::filesystem::absolute(filepath).string();
@@ -361,79 +523,1206 @@ namespace VALX
         result.MipCount = 1;
         result.Type = TextureType::TEXTURE_2D;
         result.TextureFormat = Format::R8G8B8A8_UNORM;
-        result.Data.Layers.resize(1);
-        result.Data.Layers[0].Mips.resize(1);
-        result.Data.Layers[0].Mips[0].Bytes.assign(data, data + dataSize);
+        result.TopDown = !flipVertically;
+        result.AllocateSubresources();
+        std::memcpy(result.GetSubresourceData(0, 0), data, result.GetSubresource(0, 0).Size);
         stbi_image_free(data);
         return result;
     }
 
-    static std::vector<char> ExtractCubemapFace(const std::vector<char>& bytes, uint32_t faceWidth, uint32_t faceHeight, Format format, uint32_t sliceX, uint32_t sliceY)
+    // KTX2 as in the Khronos specification: the header is followed by the level index, mip 0 first, which locates every
+    // level in the file. A level holds the images of all layers and faces back to back, each with its depth slices
+    static constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    enum class KTX2Supercompression : uint32_t
+    {
+        NONE = 0,
+        BASISLZ = 1,
+        ZSTD = 2,
+        ZLIB = 3,
+    };
+
+    struct KTX2Header
+    {
+        uint8_t Identifier[12] = {};
+        // a VkFormat, 0 for BasisLZ and UASTC payloads, which are transcoded
+        uint32_t VkFormat = 0;
+        uint32_t TypeSize = 0;
+        uint32_t PixelWidth = 0;
+        uint32_t PixelHeight = 0;
+        uint32_t PixelDepth = 0;
+        uint32_t LayerCount = 0;
+        uint32_t FaceCount = 0;
+        uint32_t LevelCount = 0;
+        uint32_t SupercompressionScheme = 0;
+        uint32_t DFDByteOffset = 0;
+        uint32_t DFDByteLength = 0;
+        uint32_t KVDByteOffset = 0;
+        uint32_t KVDByteLength = 0;
+        uint64_t SGDByteOffset = 0;
+        uint64_t SGDByteLength = 0;
+    };
+    static_assert(sizeof(KTX2Header) == 80, "KTX2 header has to match the file layout");
+
+    struct KTX2LevelIndex
+    {
+        uint64_t ByteOffset = 0;
+        uint64_t ByteLength = 0;
+        uint64_t UncompressedByteLength = 0;
+    };
+
+    static bool IsKTX2Image(const std::string& filepath)
+    {
+        return std::filesystem::path(filepath).extension() == ".ktx2";
+    }
+
+    static void FlipTextureRows(TextureData& texture)
+    {
+        for (const TextureSubresource& subresource : texture.Subresources)
+        {
+            size_t rowSize = GetImageRowPitch(texture.TextureFormat, subresource.Width);
+            for (uint32_t z = 0; z < subresource.Depth; z++)
+            {
+                uint8_t* slice = texture.Bytes.data() + subresource.Offset + z * rowSize * subresource.Height;
+                for (uint32_t y = 0; y < subresource.Height / 2; y++)
+                    std::swap_ranges(slice + y * rowSize, slice + (y + 1) * rowSize, slice + (subresource.Height - 1 - y) * rowSize);
+            }
+        }
+    }
+
+#if defined(VALX_WITH_BASIS_UNIVERSAL)
+    // the best format the device samples for the content, R8G8B8A8 is always available as the fallback
+    static Format SelectTranscodeFormat(bool hasAlpha, bool isTwoChannel, bool isSRGB, const std::vector<Format>& transcodeFormats)
+    {
+        std::vector<Format> candidates;
+        if (isTwoChannel)
+            candidates = { Format::BC5_UNORM_BLOCK };
+        else if (hasAlpha)
+            candidates = { isSRGB ? Format::BC7_SRGB_BLOCK : Format::BC7_UNORM_BLOCK, isSRGB ? Format::BC3_SRGB_BLOCK : Format::BC3_UNORM_BLOCK };
+        else
+            candidates = { isSRGB ? Format::BC7_SRGB_BLOCK : Format::BC7_UNORM_BLOCK, isSRGB ? Format::BC1_RGB_SRGB_BLOCK : Format::BC1_RGB_UNORM_BLOCK };
+
+        for (Format candidate : candidates)
+        {
+            if (std::find(transcodeFormats.begin(), transcodeFormats.end(), candidate) != transcodeFormats.end())
+                return candidate;
+        }
+        return isSRGB && !isTwoChannel ? Format::R8G8B8A8_SRGB : Format::R8G8B8A8_UNORM;
+    }
+
+    static basist::transcoder_texture_format ConvertTranscodeFormat(Format format)
     {
-        std::vector<char> result(bytes.size() / 6);
-        const uint32_t pixelSize = GetPixelByteSize(format);
-        const uint32_t sourceWidth = faceWidth * 4;
-    
-        for (uint32_t i = 0; i < faceHeight; i++)
+        switch (GetLinearFormat(format))
+        {
+        case Format::BC7_UNORM_BLOCK:
+            return basist::transcoder_texture_format::cTFBC7_RGBA;
+        case Format::BC5_UNORM_BLOCK:
+            return basist::transcoder_texture_format::cTFBC5_RG;
+        case Format::BC3_UNORM_BLOCK:
+            return basist::transcoder_texture_format::cTFBC3_RGBA;
+        case Format::BC1_RGB_UNORM_BLOCK:
+            return basist::transcoder_texture_format::cTFBC1_RGB;
+        default:
+            return basist::transcoder_texture_format::cTFRGBA32;
+        }
+    }
+
+    // every layer, face and mip is transcoded as its own task, each with its own transcoder state
+    static TextureData TranscodeKTX2(const std::string& filepath, const std::vector<uint8_t>& bytes, const std::vector<Format>& transcodeFormats)
+    {
+        static std::once_flag transcoderInitialized;
+        std::call_once(transcoderInitialized, []() { basist::basisu_transcoder_init(); });
+
+        basist::ktx2_transcoder transcoder;
+        if (!transcoder.init(bytes.data(), static_cast<uint32_t>(bytes.size())) || !transcoder.start_transcoding())
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot start transcoding `{}`", filepath));
+            return TextureData{};
+        }
+
+        bool isTwoChannel = transcoder.is_uastc()
+            ? transcoder.get_dfd_channel_id0() == basist::KTX2_DF_CHANNEL_UASTC_RG
+            : transcoder.get_dfd_channel_id0() == basist::KTX2_DF_CHANNEL_ETC1S_RRR && transcoder.get_dfd_channel_id1() == basist::KTX2_DF_CHANNEL_ETC1S_GGG;
+        bool isSRGB = transcoder.get_dfd_transfer_func() == basist::KTX2_KHR_DF_TRANSFER_SRGB;
+        uint32_t faceCount = transcoder.get_faces();
+
+        TextureData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.Width = transcoder.get_width();
+        result.Height = transcoder.get_height();
+        result.Depth = 1;
+        result.MipCount = transcoder.get_levels();
+        result.Layers = std::max(transcoder.get_layers(), 1u) * faceCount;
+        result.Type = faceCount == 6 ? TextureType::TEXTURE_CUBE : TextureType::TEXTURE_2D;
+        result.TextureFormat = SelectTranscodeFormat(transcoder.get_has_alpha(), isTwoChannel, isSRGB, transcodeFormats);
+        result.TopDown = true;
+        result.AllocateSubresources();
+
+        basist::transcoder_texture_format target = ConvertTranscodeFormat(result.TextureFormat);
+        uint32_t blockByteSize = basist::basis_get_bytes_per_block_or_pixel(target);
+        std::atomic<bool> succeeded{ true };
+        GetThreadPool()->ParallelFor(result.Subresources.size(), [&](size_t index)
+        {
+            const TextureSubresource& subresource = result.Subresources[index];
+            basist::ktx2_transcoder_state state;
+            if (!transcoder.transcode_image_level(subresource.Mip, subresource.Layer / faceCount, subresource.Layer % faceCount,
+                result.GetSubresourceData(subresource.Layer, subresource.Mip), static_cast<uint32_t>(subresource.Size / blockByteSize), target, 0, 0, 0, -1, -1, &state))
+            {
+                succeeded = false;
+            }
+        });
+        if (!succeeded)
         {
-            uint32_t y = (faceHeight - i - 1) + sliceY * faceHeight;
-            uint32_t x = sliceX * faceWidth;
-            uint32_t bytesInRow = faceWidth * pixelSize;
-    
-            std::memcpy(result.data() + i * bytesInRow, bytes.data() + (y * sourceWidth + x) * pixelSize, bytesInRow);
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot transcode `{}`", filepath));
+            return TextureData{};
         }
         return result;
+    }
+#endif
+
+    // KTX2 images are stored top-down, only uncompressed formats are flipped when asked to
+    static TextureData LoadImageUsingKTX2Loader(const std::string& filepath, const std::vector<uint8_t>& bytes, bool flipVertically,
+        [[maybe_unused]] const std::vector<Format>& transcodeFormats)
+    {
+        KTX2Header header;
+        if (bytes.size() < sizeof(header) || std::memcmp(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot parse `{}`: not a KTX2 file", filepath));
+            return TextureData{};
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        KTX2Supercompression supercompression = static_cast<KTX2Supercompression>(header.SupercompressionScheme);
+        if (header.VkFormat == 0 || supercompression == KTX2Supercompression::BASISLZ)
+        {
+#if defined(VALX_WITH_BASIS_UNIVERSAL)
+            return TranscodeKTX2(filepath, bytes, transcodeFormats);
+#else
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot load `{}`: BasisLZ and UASTC need a build with VALX_WITH_BASIS_UNIVERSAL", filepath));
+            return TextureData{};
+#endif
+        }
+
+        // Format follows the VkFormat numbering up to the BC formats, later ones (ASTC, ETC2, ...) are not supported
+        Format format = header.VkFormat < FORMAT_COUNT ? static_cast<Format>(header.VkFormat) : Format::UNKNOWN;
+        if (GetPixelByteSize(format) == 0 || header.PixelWidth == 0 || (header.FaceCount != 1 && header.FaceCount != 6))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot load `{}`: unsupported format {} or layout", filepath, header.VkFormat));
+            return TextureData{};
+        }
+
+        TextureData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.Width = header.PixelWidth;
+        result.Height = std::max(header.PixelHeight, 1u);
+        result.Depth = std::max(header.PixelDepth, 1u);
+        result.MipCount = std::max(header.LevelCount, 1u);
+        result.Layers = std::max(header.LayerCount, 1u) * header.FaceCount;
+        result.Type = header.FaceCount == 6 ? TextureType::TEXTURE_CUBE : (header.PixelDepth > 0 ? TextureType::TEXTURE_3D : TextureType::TEXTURE_2D);
+        result.TextureFormat = format;
+        result.TopDown = true;
+
+        if (bytes.size() < sizeof(header) + result.MipCount * sizeof(KTX2LevelIndex))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot load `{}`: truncated level index", filepath));
+            return TextureData{};
+        }
+        std::vector<KTX2LevelIndex> levels(result.MipCount);
+        std::memcpy(levels.data(), bytes.data() + sizeof(header), levels.size() * sizeof(KTX2LevelIndex));
+        result.AllocateSubresources();
+
+        // levels are supercompressed independently, so they inflate in parallel
+        std::atomic<bool> succeeded{ true };
+        GetThreadPool()->ParallelFor(levels.size(), [&](size_t mip)
+        {
+            const KTX2LevelIndex& level = levels[mip];
+            size_t imageSize = result.GetSubresource(0, (uint32_t)mip).Size;
+            if (level.ByteOffset > bytes.size() || level.ByteLength > bytes.size() - level.ByteOffset)
+            {
+                succeeded = false;
+                return;
+            }
+
+            // the inflated size comes from the file, it has to be exactly the level before anything is allocated for it
+            const uint64_t expectedSize = uint64_t(imageSize) * result.Layers;
+            if (supercompression != KTX2Supercompression::NONE && level.UncompressedByteLength != expectedSize)
+            {
+                succeeded = false;
+                return;
+            }
+
+            const uint8_t* levelData = bytes.data() + level.ByteOffset;
+            size_t levelSize = level.ByteLength;
+            std::vector<uint8_t> inflated;
+            if (supercompression == KTX2Supercompression::ZLIB)
+            {
+                // stb takes the sizes as int
+                if (level.UncompressedByteLength > uint64_t(INT_MAX) || level.ByteLength > uint64_t(INT_MAX))
+                {
+                    succeeded = false;
+                    return;
+                }
+                inflated.resize(level.UncompressedByteLength);
+                int size = stbi_zlib_decode_buffer(reinterpret_cast<char*>(inflated.data()), (int)inflated.size(), reinterpret_cast<const char*>(levelData), (int)level.ByteLength);
+                levelData = inflated.data();
+                levelSize = size == (int)inflated.size() ? inflated.size() : 0;
+            }
+            else if (supercompression == KTX2Supercompression::ZSTD)
+            {
+#if defined(VALX_WITH_ZSTD)
+                inflated.resize(level.UncompressedByteLength);
+                size_t size = ZSTD_decompress(inflated.data(), inflated.size(), levelData, level.ByteLength);
+                levelData = inflated.data();
+                levelSize = !ZSTD_isError(size) && size == inflated.size() ? inflated.size() : 0;
+#else
+                levelSize = 0;
+#endif
+            }
+            else if (supercompression != KTX2Supercompression::NONE)
+            {
+                levelSize = 0;
+            }
+
+            if (levelSize < imageSize * result.Layers)
+            {
+                succeeded = false;
+                return;
+            }
+            for (uint32_t layer = 0; layer < result.Layers; layer++)
+                std::memcpy(result.GetSubresourceData(layer, (uint32_t)mip), levelData + layer * imageSize, imageSize);
+        });
+        if (!succeeded)
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot load `{}`: truncated or invalid level, or unsupported supercompression scheme {}",
+                filepath, header.SupercompressionScheme));
+            return TextureData{};
+        }
+
+        if (flipVertically && !IsBlockCompressedFormat(format))
+        {
+            FlipTextureRows(result);
+            result.TopDown = false;
+        }
+        return result;
+    }
+
+    // cells of the faces in the 4x3 cross in the order of the cube layers (+X, -X, +Y, -Y, +Z, -Z), counted from the top
+    static const uint32_t CubeMapCrossCells[6][2] = { { 2, 1 }, { 0, 1 }, { 1, 0 }, { 1, 2 }, { 1, 1 }, { 3, 1 } };
+
+    // direction through a face texel, u and v in [-1, 1] with v pointing down the face as the cube map face selection expects
+    static glm::vec3 GetCubeMapDirection(uint32_t face, float u, float v)
+    {
+        switch (face)
+        {
+        case 0:
+            return glm::vec3(1.0f, -v, -u);
+        case 1:
+            return glm::vec3(-1.0f, -v, u);
+        case 2:
+            return glm::vec3(u, 1.0f, v);
+        case 3:
+            return glm::vec3(u, -1.0f, -v);
+        case 4:
+            return glm::vec3(u, -v, 1.0f);
+        default:
+            return glm::vec3(-u, -v, -1.0f);
+        }
+    }
+
+    static bool IsCubeMapResampleSupported(Format format)
+    {
+        switch (GetLinearFormat(format))
+        {
+        case Format::R8G8B8A8_UNORM:
+        case Format::B8G8R8A8_UNORM:
+        case Format::R16G16B16A16_SFLOAT:
+        case Format::R32G32B32A32_SFLOAT:
+        case Format::B10G11R11_UFLOAT_PACK32:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // sRGB texels are filtered on their encoded values, the error is far below one code for neighbouring texels
+    static glm::vec4 LoadCubeMapTexel(const uint8_t* texel, Format format)
+    {
+        switch (GetLinearFormat(format))
+        {
+        case Format::R16G16B16A16_SFLOAT:
+        {
+            uint16_t values[4];
+            std::memcpy(values, texel, sizeof(values));
+            return glm::vec4(HalfToFloat(values[0]), HalfToFloat(values[1]), HalfToFloat(values[2]), HalfToFloat(values[3]));
+        }
+        case Format::R32G32B32A32_SFLOAT:
+        {
+            glm::vec4 value;
+            std::memcpy(&value, texel, sizeof(value));
+            return value;
+        }
+        case Format::B10G11R11_UFLOAT_PACK32:
+        {
+            uint32_t packed = 0;
+            std::memcpy(&packed, texel, sizeof(packed));
+            glm::vec4 value(1.0f);
+            R11G11B10ToFloat(packed, value.x, value.y, value.z);
+            return value;
+        }
+        default:
+            return glm::vec4(texel[0], texel[1], texel[2], texel[3]) * (1.0f / 255.0f);
+        }
+    }
+
+    static void StoreCubeMapTexel(uint8_t* texel, Format format, const glm::vec4& value)
+    {
+        switch (GetLinearFormat(format))
+        {
+        case Format::R16G16B16A16_SFLOAT:
+        {
+            uint16_t values[4] = { FloatToHalf(value.x), FloatToHalf(value.y), FloatToHalf(value.z), FloatToHalf(value.w) };
+            std::memcpy(texel, values, sizeof(values));
+            break;
+        }
+        case Format::R32G32B32A32_SFLOAT:
+            std::memcpy(texel, &value, sizeof(value));
+            break;
+        case Format::B10G11R11_UFLOAT_PACK32:
+        {
+            uint32_t packed = FloatToR11G11B10(value.x, value.y, value.z);
+            std::memcpy(texel, &packed, sizeof(packed));
+            break;
+        }
+        default:
+            for (int channel = 0; channel < 4; channel++)
+                texel[channel] = static_cast<uint8_t>(std::clamp(value[channel], 0.0f, 1.0f) * 255.0f + 0.5f);
+            break;
+        }
+    }
+
+    // area of the source a face samples from, in texels of the stored (not visual) image
+    struct CubeMapSourceRegion
+    {
+        uint32_t MinX = 0;
+        uint32_t MinY = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        // panoramas wrap around horizontally, everything else is clamped to the region
+        bool WrapX = false;
+    };
+
+    static glm::vec4 SampleCubeMapSource(const uint8_t* bytes, uint32_t rowWidth, Format format, uint32_t pixelSize, const CubeMapSourceRegion& region, float x, float y)
+    {
+        x -= 0.5f;
+        y -= 0.5f;
+        float baseX = std::floor(x);
+        float baseY = std::floor(y);
+        float fractionX = x - baseX;
+        float fractionY = y - baseY;
+
+        auto getColumn = [&region](int32_t column)
+        {
+            if (region.WrapX)
+                return region.MinX + uint32_t((column % int32_t(region.Width) + int32_t(region.Width)) % int32_t(region.Width));
+            return region.MinX + uint32_t(std::clamp(column - int32_t(region.MinX), 0, int32_t(region.Width) - 1));
+        };
+        auto getRow = [&region](int32_t row)
+        {
+            return region.MinY + uint32_t(std::clamp(row - int32_t(region.MinY), 0, int32_t(region.Height) - 1));
+        };
+
+        uint32_t x0 = getColumn(int32_t(baseX));
+        uint32_t x1 = getColumn(int32_t(baseX) + 1);
+        uint32_t y0 = getRow(int32_t(baseY));
+        uint32_t y1 = getRow(int32_t(baseY) + 1);
+        auto load = [&](uint32_t column, uint32_t row)
+        {
+            return LoadCubeMapTexel(bytes + (size_t(row) * rowWidth + column) * pixelSize, format);
+        };
+        glm::vec4 top = glm::mix(load(x0, y0), load(x1, y0), fractionX);
+        glm::vec4 bottom = glm::mix(load(x0, y1), load(x1, y1), fractionX);
+        return glm::mix(top, bottom, fractionY);
+    }
+
+    // the DDS header as laid out in the file, see the DDS_HEADER, DDS_PIXELFORMAT and DDS_HEADER_DXT10 documentation
+    struct DDSPixelFormat
+    {
+        uint32_t Size;
+        uint32_t Flags;
+        uint32_t FourCC;
+        uint32_t RGBBitCount;
+        uint32_t RBitMask;
+        uint32_t GBitMask;
+        uint32_t BBitMask;
+        uint32_t ABitMask;
     };
 
-    TextureData TextureLoader::LoadTextureFromFile(const std::string& filepath)
+    struct DDSHeader
     {
+        uint32_t Size;
+        uint32_t Flags;
+        uint32_t Height;
+        uint32_t Width;
+        uint32_t PitchOrLinearSize;
+        uint32_t Depth;
+        uint32_t MipMapCount;
+        uint32_t Reserved1[11];
+        DDSPixelFormat PixelFormat;
+        uint32_t Caps;
+        uint32_t Caps2;
+        uint32_t Caps3;
+        uint32_t Caps4;
+        uint32_t Reserved2;
+    };
+
+    struct DDSHeaderDX10
+    {
+        uint32_t DXGIFormat;
+        uint32_t ResourceDimension;
+        uint32_t MiscFlag;
+        uint32_t ArraySize;
+        uint32_t MiscFlags2;
+    };
+
+    static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+    {
+        return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+    }
+
+    static constexpr uint32_t DDS_MAGIC = MakeFourCC('D', 'D', 'S', ' ');
+    static constexpr uint32_t DDS_PIXEL_FORMAT_FOURCC = 0x4;
+    static constexpr uint32_t DDS_PIXEL_FORMAT_RGB = 0x40;
+    static constexpr uint32_t DDS_CAPS2_CUBEMAP = 0x200;
+    static constexpr uint32_t DDS_CAPS2_VOLUME = 0x200000;
+    static constexpr uint32_t DDS_DIMENSION_TEXTURE3D = 4;
+    static constexpr uint32_t DDS_MISC_TEXTURECUBE = 0x4;
+
+    // legacy headers without the DX10 extension, only the layouts in common use
+    static Format ConvertDDSPixelFormat(const DDSPixelFormat& pixelFormat)
+    {
+        if (pixelFormat.Flags & DDS_PIXEL_FORMAT_FOURCC)
+        {
+            switch (pixelFormat.FourCC)
+            {
+            case MakeFourCC('D', 'X', 'T', '1'):
+                return Format::BC1_RGBA_UNORM_BLOCK;
+            case MakeFourCC('D', 'X', 'T', '2'):
+            case MakeFourCC('D', 'X', 'T', '3'):
+                return Format::BC2_UNORM_BLOCK;
+            case MakeFourCC('D', 'X', 'T', '4'):
+            case MakeFourCC('D', 'X', 'T', '5'):
+                return Format::BC3_UNORM_BLOCK;
+            case MakeFourCC('A', 'T', 'I', '1'):
+            case MakeFourCC('B', 'C', '4', 'U'):
+                return Format::BC4_UNORM_BLOCK;
+            case MakeFourCC('B', 'C', '4', 'S'):
+                return Format::BC4_SNORM_BLOCK;
+            case MakeFourCC('A', 'T', 'I', '2'):
+            case MakeFourCC('B', 'C', '5', 'U'):
+                return Format::BC5_UNORM_BLOCK;
+            case MakeFourCC('B', 'C', '5', 'S'):
+                return Format::BC5_SNORM_BLOCK;
+            case 113: // D3DFMT_A16B16G16R16F
+                return Format::R16G16B16A16_SFLOAT;
+            case 116: // D3DFMT_A32B32G32R32F
+                return Format::R32G32B32A32_SFLOAT;
+            default:
+                return Format::UNKNOWN;
+            }
+        }
+
+        if ((pixelFormat.Flags & DDS_PIXEL_FORMAT_RGB) && pixelFormat.RGBBitCount == 32)
+        {
+            if (pixelFormat.RBitMask == 0x000000FF && pixelFormat.GBitMask == 0x0000FF00 && pixelFormat.BBitMask == 0x00FF0000)
+                return Format::R8G8B8A8_UNORM;
+            if (pixelFormat.RBitMask == 0x00FF0000 && pixelFormat.GBitMask == 0x0000FF00 && pixelFormat.BBitMask == 0x000000FF)
+                return Format::B8G8R8A8_UNORM;
+        }
+        return Format::UNKNOWN;
+    }
+
+    // fills everything but the file handle, subresource offsets are from the start of bytes
+    static bool ParseDDSHeader(const uint8_t* bytes, size_t size, MappedTextureData& result)
+    {
+        uint32_t magic = 0;
+        DDSHeader header = {};
+        if (size < sizeof(magic) + sizeof(header))
+            return false;
+        std::memcpy(&magic, bytes, sizeof(magic));
+        std::memcpy(&header, bytes + sizeof(magic), sizeof(header));
+        if (magic != DDS_MAGIC || header.Size != sizeof(DDSHeader))
+            return false;
+
+        size_t offset = sizeof(magic) + sizeof(header);
+        uint32_t arraySize = 1;
+        bool isCube = false;
+        bool isVolume = false;
+        if ((header.PixelFormat.Flags & DDS_PIXEL_FORMAT_FOURCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+        {
+            DDSHeaderDX10 headerDX10 = {};
+            if (size < offset + sizeof(headerDX10))
+                return false;
+            std::memcpy(&headerDX10, bytes + offset, sizeof(headerDX10));
+            offset += sizeof(headerDX10);
+
+            // tinyddsloader uses the DXGI values for its format enum
+            result.TextureFormat = ConvertDDSFormat(static_cast<tinyddsloader::DDSFile::DXGIFormat>(headerDX10.DXGIFormat));
+            arraySize = std::max(headerDX10.ArraySize, 1u);
+            isCube = (headerDX10.MiscFlag & DDS_MISC_TEXTURECUBE) != 0;
+            isVolume = headerDX10.ResourceDimension == DDS_DIMENSION_TEXTURE3D;
+        }
+        else
+        {
+            result.TextureFormat = ConvertDDSPixelFormat(header.PixelFormat);
+            isCube = (header.Caps2 & DDS_CAPS2_CUBEMAP) != 0;
+            isVolume = (header.Caps2 & DDS_CAPS2_VOLUME) != 0;
+        }
+        if (result.TextureFormat == Format::UNKNOWN)
+            return false;
+
+        result.Width = header.Width;
+        result.Height = header.Height;
+        result.Depth = isVolume ? std::max(header.Depth, 1u) : 1;
+        result.MipCount = std::max(header.MipMapCount, 1u);
+        result.Layers = isCube ? arraySize * 6 : arraySize;
+        result.Type = isCube ? TextureType::TEXTURE_CUBE : (isVolume ? TextureType::TEXTURE_3D : TextureType::TEXTURE_2D);
+
+        // every layer stores its whole mip chain before the next layer starts
+        result.Subresources.resize(size_t(result.Layers) * result.MipCount);
+        for (uint32_t layer = 0; layer < result.Layers; layer++)
+        {
+            for (uint32_t mip = 0; mip < result.MipCount; mip++)
+            {
+                TextureSubresource& subresource = result.Subresources[size_t(layer) * result.MipCount + mip];
+                subresource.Layer = layer;
+                subresource.Mip = mip;
+                subresource.Width = std::max(result.Width >> mip, 1u);
+                subresource.Height = std::max(result.Height >> mip, 1u);
+                subresource.Depth = std::max(result.Depth >> mip, 1u);
+                subresource.Size = GetImageByteSize(result.TextureFormat, subresource.Width, subresource.Height, subresource.Depth);
+                subresource.Offset = offset;
+                if (subresource.Size > size - offset)
+                    return false;
+                offset += subresource.Size;
+            }
+        }
+        return true;
+    }
+
+    // copies the subresources of a .dds file in memory into an aligned layout, the rows keep the order of the file
+    static TextureData LoadDDSFromMemory(const std::string& filepath, const uint8_t* bytes, size_t size)
+    {
+        MappedTextureData dds;
+        if (!ParseDDSHeader(bytes, size, dds))
+            return TextureData{};
+
+        TextureData result;
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.Width = dds.Width;
+        result.Height = dds.Height;
+        result.Depth = dds.Depth;
+        result.MipCount = dds.MipCount;
+        result.Layers = dds.Layers;
+        result.TextureFormat = dds.TextureFormat;
+        result.Type = dds.Type;
+        result.TopDown = true;
+
+        result.AllocateSubresources();
+        for (uint32_t layer = 0; layer < result.Layers; layer++)
+        {
+            for (uint32_t mip = 0; mip < result.MipCount; mip++)
+            {
+                const TextureSubresource& subresource = dds.GetSubresource(layer, mip);
+                std::memcpy(result.GetSubresourceData(layer, mip), bytes + subresource.Offset, subresource.Size);
+            }
+        }
+        return result;
+    }
+
+    // a plain stream does not store its inflated size, so the .dds file is read from the block stb allocates for it
+    static TextureData LoadImageUsingZLIBLoader(const std::string& filepath, const std::vector<uint8_t>& bytes)
+    {
+        if (IsChunkedZLIB(bytes))
+        {
+            std::vector<uint8_t> ddsBytes;
+            if (!InflateChunkedZLIB(bytes, ddsBytes))
+            {
+                GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot inflate `{}`", filepath));
+                return TextureData{};
+            }
+            return LoadDDSFromMemory(filepath, ddsBytes.data(), ddsBytes.size());
+        }
+
+        int ddsSize = 0;
+        char* ddsBytes = stbi_zlib_decode_malloc(reinterpret_cast<const char*>(bytes.data()), (int)bytes.size(), &ddsSize);
+        if (ddsBytes == nullptr)
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot inflate `{}`", filepath));
+            return TextureData{};
+        }
+        TextureData result = LoadDDSFromMemory(filepath, reinterpret_cast<const uint8_t*>(ddsBytes), (size_t)ddsSize);
+        free(ddsBytes);
+        return result;
+    }
+
+    // decodes the file contents in memory, the bytes may be consumed
+    static TextureData DecodeImage(const std::string& filepath, std::vector<uint8_t>& bytes, const TextureCookInfo& cookInfo, const std::vector<Format>& transcodeFormats)
+    {
+        const bool flipVertically = cookInfo.FlipVertically;
         if (IsDDSImage(filepath))
-            return LoadImageUsingDDSLoader(filepath);
+            return LoadImageUsingDDSLoader(filepath, std::move(bytes));
         else if (IsZLIBImage(filepath))
-            return LoadImageUsingZLIBLoader(filepath);
+            return LoadImageUsingZLIBLoader(filepath, bytes);
+        else if (IsKTX2Image(filepath))
+            return LoadImageUsingKTX2Loader(filepath, bytes, flipVertically, transcodeFormats);
         else
-            return LoadImageUsingSTBLoader(filepath);
+            return LoadImageUsingSTBLoader(filepath, bytes, flipVertically, cookInfo.HDRFormat);
+    }
+
+    // bumped whenever the cache layout or the output of a cook step changes, so stale entries are never hit
+    static constexpr uint32_t TEXTURE_CACHE_VERSION = 6;
+    static constexpr uint32_t TEXTURE_CACHE_MAGIC = 0x43545856; // "VXTC"
+
+    struct TextureCacheHeader
+    {
+        uint32_t Magic = TEXTURE_CACHE_MAGIC;
+        uint32_t Version = TEXTURE_CACHE_VERSION;
+        uint64_t Key = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Depth = 0;
+        uint32_t MipCount = 0;
+        uint32_t Layers = 0;
+        uint32_t Type = 0;
+        uint32_t TextureFormat = 0;
+        uint32_t TopDown = 0;
+        uint64_t ByteSize = 0;
+    };
+
+    // SIMD and threading switches are left out, they do not change what is cooked. The transcode formats only matter for KTX2 files,
+    // other files pass an empty list
+    static uint64_t ComputeTextureCacheKey(const std::vector<uint8_t>& sourceBytes, const TextureCookInfo& cookInfo, const std::vector<Format>& transcodeFormats)
+    {
+        uint32_t alphaCoverageThreshold = 0;
+        std::memcpy(&alphaCoverageThreshold, &cookInfo.Mips.AlphaCoverageThreshold, sizeof(alphaCoverageThreshold));
+
+        uint32_t settings[] = {
+            TEXTURE_CACHE_VERSION,
+            cookInfo.FlipVertically,
+            (uint32_t)cookInfo.HDRFormat,
+            cookInfo.BuildMips,
+            cookInfo.BuildMips ? (uint32_t)cookInfo.Mips.Filter : 0,
+            cookInfo.BuildMips ? cookInfo.Mips.MipCount : 0,
+            cookInfo.BuildMips ? alphaCoverageThreshold : 0,
+            cookInfo.Compress,
+            cookInfo.Compress ? (uint32_t)cookInfo.Compression.TargetFormat : 0,
+            cookInfo.Compress ? (uint32_t)cookInfo.Compression.Quality : 0,
+        };
+        uint64_t sourceHash = HashBytes(sourceBytes.data(), sourceBytes.size());
+        uint64_t settingsHash = HashBytes(settings, sizeof(settings), sourceHash);
+        return HashBytes(transcodeFormats.data(), transcodeFormats.size() * sizeof(Format), settingsHash);
+    }
+
+    static std::string GetTextureCachePath(const std::string& directory, uint64_t key)
+    {
+        return (std::filesystem::path(directory) / fmt::format("{:016x}.vxtex", key)).string();
+    }
+
+    // entries are rejected before anything is allocated for them, so a damaged file cannot request an arbitrary amount of memory
+    static constexpr uint32_t MAX_CACHED_TEXTURE_SIZE = 1u << 16;
+
+    // the header is followed by the TextureData byte blob, whose layout follows from the header
+    static bool ReadCachedTexture(const std::string& cachePath, uint64_t key, TextureData& texture)
+    {
+        std::ifstream file(cachePath, std::ifstream::binary | std::ifstream::ate);
+        if (!file.good())
+            return false;
+        uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        TextureCacheHeader header;
+        if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        if (header.Magic != TEXTURE_CACHE_MAGIC || header.Version != TEXTURE_CACHE_VERSION || header.Key != key)
+            return false;
+        if (header.ByteSize != fileSize - sizeof(header))
+            return false;
+
+        // loaders leave the depth of 2D textures at zero
+        uint32_t depth = std::max(header.Depth, 1u);
+        uint32_t maxSize = std::max({ header.Width, header.Height, depth });
+        bool isValid = header.Width > 0 && header.Height > 0 && maxSize <= MAX_CACHED_TEXTURE_SIZE &&
+            header.MipCount > 0 && header.MipCount <= GetMipLevelCount(maxSize) &&
+            header.Layers > 0 && uint64_t(header.Layers) * header.MipCount <= header.ByteSize &&
+            header.Type <= (uint32_t)TextureType::TEXTURE_CUBE &&
+            header.TextureFormat != (uint32_t)Format::UNKNOWN && header.TextureFormat < FORMAT_COUNT;
+        if (!isValid)
+            return false;
+
+        std::vector<TextureSubresource> subresources;
+        size_t byteSize = ComputeTextureSubresources((Format)header.TextureFormat, header.Width, header.Height, depth, header.MipCount, header.Layers, subresources);
+        if (byteSize != header.ByteSize)
+            return false;
+
+        texture.Width = header.Width;
+        texture.Height = header.Height;
+        texture.Depth = header.Depth;
+        texture.MipCount = header.MipCount;
+        texture.Layers = header.Layers;
+        texture.Type = (TextureType)header.Type;
+        texture.TextureFormat = (Format)header.TextureFormat;
+        texture.TopDown = header.TopDown != 0;
+        texture.Subresources = std::move(subresources);
+        texture.Bytes.resize(byteSize);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(texture.Bytes.data()), texture.Bytes.size()));
+    }
+
+    static bool WriteCachedTexture(const std::string& cachePath, uint64_t key, const TextureData& texture)
+    {
+        TextureCacheHeader header;
+        header.Key = key;
+        header.Width = texture.Width;
+        header.Height = texture.Height;
+        header.Depth = texture.Depth;
+        header.MipCount = texture.MipCount;
+        header.Layers = texture.Layers;
+        header.Type = (uint32_t)texture.Type;
+        header.TextureFormat = (uint32_t)texture.TextureFormat;
+        header.TopDown = texture.TopDown;
+        header.ByteSize = texture.Bytes.size();
+
+        // several loaders, also of other processes, may share one cache directory
+        return WriteFileAtomically(cachePath, { { &header, sizeof(header) }, { texture.Bytes.data(), texture.Bytes.size() } });
+    }
+
+    void TextureLoader::SetCacheDirectory(const std::string& directory)
+    {
+        this->cacheDirectory = directory;
+        if (!directory.empty())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            if (error)
+                GetCurrentLogger()->LogWarning("TextureLoader", fmt::format("cannot create texture cache directory `{}`: {}", directory, error.message()));
+        }
+    }
+
+    const std::string& TextureLoader::GetCacheDirectory() const
+    {
+        return this->cacheDirectory;
+    }
+
+    void TextureLoader::SetTranscodeFormats(const std::vector<Format>& formats)
+    {
+        this->transcodeFormats = formats;
+    }
+
+    const std::vector<Format>& TextureLoader::GetTranscodeFormats() const
+    {
+        return this->transcodeFormats;
+    }
+
+    TextureCacheStatistics TextureLoader::GetCacheStatistics() const
+    {
+        TextureCacheStatistics statistics;
+        statistics.Hits = this->cacheHits.load();
+        statistics.Misses = this->cacheMisses.load();
+        statistics.BytesSaved = this->cacheBytesSaved.load();
+        return statistics;
+    }
+
+    void TextureLoader::ResetCacheStatistics()
+    {
+        this->cacheHits = 0;
+        this->cacheMisses = 0;
+        this->cacheBytesSaved = 0;
+    }
+
+    TextureData TextureLoader::LoadTextureFromFile(const std::string& filepath, const TextureCookInfo& cookInfo)
+    {
+        // the file is read once, for both the cache key and the decoders
+        std::vector<uint8_t> sourceBytes;
+        if (!ReadFileBytes(filepath, sourceBytes))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot read `{}`", filepath));
+            return TextureData{};
+        }
+        if (this->cacheDirectory.empty())
+            return this->CookTexture(DecodeImage(filepath, sourceBytes, cookInfo, this->transcodeFormats), cookInfo);
+
+        uint64_t key = ComputeTextureCacheKey(sourceBytes, cookInfo, IsKTX2Image(filepath) ? this->transcodeFormats : std::vector<Format>{});
+        std::string cachePath = GetTextureCachePath(this->cacheDirectory, key);
+
+        TextureData result;
+        if (ReadCachedTexture(cachePath, key, result))
+        {
+            result.FilePath = std::filesystem::absolute(filepath).string();
+            this->cacheHits++;
+            this->cacheBytesSaved += result.Bytes.size();
+            return result;
+        }
+
+        this->cacheMisses++;
+        result = this->CookTexture(DecodeImage(filepath, sourceBytes, cookInfo, this->transcodeFormats), cookInfo);
+        if (result.IsEmpty())
+            return result;
+
+        if (!WriteCachedTexture(cachePath, key, result))
+            GetCurrentLogger()->LogWarning("TextureLoader", fmt::format("cannot write texture cache entry `{}` for `{}`", cachePath, filepath));
+        return result;
+    }
+
+    MappedTextureData TextureLoader::MapDDSFile(const std::string& filepath)
+    {
+        auto file = std::make_shared<MappedFile>(filepath);
+        if (!file->IsOpen())
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot map `{}`", filepath));
+            return MappedTextureData{};
+        }
+
+        MappedTextureData result;
+        if (!ParseDDSHeader(file->GetData(), file->GetSize(), result))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot parse `{}`: not a DDS file, truncated or of an unsupported format", filepath));
+            return MappedTextureData{};
+        }
+        result.FilePath = std::filesystem::absolute(filepath).string();
+        result.File = std::move(file);
+        return result;
+    }
+
+    bool TextureLoader::WriteChunkedZLIB(const std::string& ddsFilepath, const std::string& outputFilepath, uint32_t chunkSize)
+    {
+        VALX_ASSERT(chunkSize > 0);
+        MappedFile file(ddsFilepath);
+        MappedTextureData dds;
+        if (!file.IsOpen() || !ParseDDSHeader(file.GetData(), file.GetSize(), dds))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot compress `{}`: not a readable DDS file", ddsFilepath));
+            return false;
+        }
+
+        ChunkedZLIBHeader header;
+        header.ChunkCount = (uint32_t)((file.GetSize() + chunkSize - 1) / chunkSize);
+        header.UncompressedSize = file.GetSize();
+
+        using CompressedChunk = std::unique_ptr<unsigned char, decltype(&free)>;
+        std::vector<CompressedChunk> chunks;
+        chunks.reserve(header.ChunkCount);
+        for (uint32_t chunk = 0; chunk < header.ChunkCount; chunk++)
+            chunks.emplace_back(nullptr, &free);
+        std::vector<ChunkedZLIBEntry> entries(header.ChunkCount);
+        GetThreadPool()->ParallelFor(entries.size(), [&](size_t chunk)
+        {
+            size_t offset = chunk * chunkSize;
+            ChunkedZLIBEntry& entry = entries[chunk];
+            entry.UncompressedSize = (uint32_t)std::min<size_t>(chunkSize, file.GetSize() - offset);
+            int compressedSize = 0;
+            chunks[chunk].reset(stbi_zlib_compress(const_cast<unsigned char*>(file.GetData() + offset), (int)entry.UncompressedSize, &compressedSize, 8));
+            entry.CompressedSize = (uint32_t)compressedSize;
+        });
+
+        std::vector<FileWriteRange> ranges = { { &header, sizeof(header) }, { entries.data(), entries.size() * sizeof(ChunkedZLIBEntry) } };
+        uint64_t compressedOffset = sizeof(header) + entries.size() * sizeof(ChunkedZLIBEntry);
+        for (uint32_t chunk = 0; chunk < header.ChunkCount; chunk++)
+        {
+            if (chunks[chunk] == nullptr)
+                return false;
+            entries[chunk].CompressedOffset = compressedOffset;
+            compressedOffset += entries[chunk].CompressedSize;
+            ranges.push_back({ chunks[chunk].get(), entries[chunk].CompressedSize });
+        }
+
+        if (!WriteFileAtomically(outputFilepath, ranges))
+        {
+            GetCurrentLogger()->LogError("TextureLoader", fmt::format("cannot write `{}`", outputFilepath));
+            return false;
+        }
+        GetCurrentLogger()->LogInfo("TextureLoader", fmt::format("`{}` compressed to {} chunks, {} of {} bytes", ddsFilepath, header.ChunkCount, compressedOffset, file.GetSize()));
+        return true;
+    }
+
+    std::vector<std::future<TextureData>> TextureLoader::LoadTexturesAsync(const std::vector<std::string>& filepaths, const TextureCookInfo& cookInfo,
+        const TextureLoadedCallback& onLoaded)
+    {
+        // cooking steps spread their own work with ParallelFor, which is safe inside a pool task
+        std::vector<std::future<TextureData>> result;
+        result.reserve(filepaths.size());
+        for (size_t index = 0; index < filepaths.size(); index++)
+        {
+            result.push_back(GetThreadPool()->Submit([this, filepath = filepaths[index], cookInfo, onLoaded, index]()
+            {
+                TextureData texture = this->LoadTextureFromFile(filepath, cookInfo);
+                if (onLoaded != nullptr)
+                    onLoaded(index, texture);
+                return texture;
+            }));
+        }
+        return result;
+    }
+
+    void TextureLoader::ReadTextureRegion(const MappedTextureData& texture, uint32_t layer, uint32_t mip, int32_t x, int32_t y, uint32_t width, uint32_t height, uint8_t* output)
+    {
+        const TextureSubresource& subresource = texture.GetSubresource(layer, mip);
+        const uint8_t* source = texture.GetSubresourceData(layer, mip);
+        const FormatInfo& formatInfo = GetFormatInfo(texture.TextureFormat);
+        const int32_t blockSize = formatInfo.BlockWidth;
+        VALX_ASSERT(formatInfo.BlockWidth == formatInfo.BlockHeight);
+        VALX_ASSERT(x % blockSize == 0 && y % blockSize == 0 && width % blockSize == 0 && height % blockSize == 0);
+
+        const size_t blockBytes = formatInfo.BlockByteSize;
+        const int32_t blockCountX = int32_t(GetImageRowPitch(texture.TextureFormat, subresource.Width) / blockBytes);
+        const int32_t blockCountY = int32_t(GetImageRowCount(texture.TextureFormat, subresource.Height));
+        const int32_t firstBlockX = x / blockSize;
+        const int32_t firstBlockY = y / blockSize;
+        const int32_t outputBlockCountX = int32_t(width) / blockSize;
+        const int32_t outputBlockCountY = int32_t(height) / blockSize;
+
+        for (int32_t blockY = 0; blockY < outputBlockCountY; blockY++)
+        {
+            const uint8_t* sourceRow = source + size_t(std::clamp(firstBlockY + blockY, 0, blockCountY - 1)) * blockCountX * blockBytes;
+            uint8_t* outputRow = output + size_t(blockY) * outputBlockCountX * blockBytes;
+
+            // the part inside the mip goes over in one copy, blocks past its edges one by one
+            int32_t blockX = 0;
+            while (blockX < outputBlockCountX)
+            {
+                int32_t sourceBlockX = firstBlockX + blockX;
+                int32_t runLength = 1;
+                if (sourceBlockX >= 0 && sourceBlockX < blockCountX)
+                    runLength = std::min(outputBlockCountX - blockX, blockCountX - sourceBlockX);
+                sourceBlockX = std::clamp(sourceBlockX, 0, blockCountX - 1);
+
+                std::memcpy(outputRow + size_t(blockX) * blockBytes, sourceRow + size_t(sourceBlockX) * blockBytes, size_t(runLength) * blockBytes);
+                blockX += runLength;
+            }
+        }
+    }
+
+    TextureData TextureLoader::CookTexture(TextureData texture, const TextureCookInfo& cookInfo)
+    {
+        if (texture.IsEmpty())
+            return texture;
+
+        if (cookInfo.BuildMips && IsMipBuildSupported(texture.TextureFormat))
+            BuildMips(texture, cookInfo.Mips);
+
+        if (cookInfo.Compress)
+        {
+            if (GetLinearFormat(texture.TextureFormat) == Format::R8G8B8A8_UNORM)
+                texture = this->CompressTexture(texture, cookInfo.Compression);
+            else
+                GetCurrentLogger()->LogWarning("TextureLoader", fmt::format("texture `{}` of format {} is not compressed, only R8G8B8A8 sources are supported",
+                    texture.FilePath, (int)texture.TextureFormat));
+        }
+        return texture;
     }
 
-    TextureData TextureLoader::Convert2DTextureToCubeMap(const TextureData& texture)
+    TextureData TextureLoader::Convert2DTextureToCubeMap(const TextureData& texture, const CubeMapConversionInfo& info)
     {
         VALX_ASSERT(texture.Type == TextureType::TEXTURE_2D);
+        VALX_ASSERT(!IsBlockCompressedFormat(texture.TextureFormat) && "block compressed textures can not be converted to cube maps");
+
+        uint32_t nativeFaceSize = texture.Width / 4;
+        uint32_t faceSize = info.FaceSize != 0 ? info.FaceSize : nativeFaceSize;
+        bool copyRows = info.Layout == CubeMapLayout::CROSS_4X3 && faceSize == nativeFaceSize;
+        VALX_ASSERT(info.Layout != CubeMapLayout::CROSS_4X3 || texture.Width * 3 == texture.Height * 4);
+        VALX_ASSERT(copyRows || IsCubeMapResampleSupported(texture.TextureFormat));
+
         TextureData result;
         result.FilePath = texture.FilePath;
-        result.Width = texture.Width / 4;
-        result.Height = texture.Height / 3;
-        result.Depth = texture.Depth;
+        result.Width = faceSize;
+        result.Height = faceSize;
+        result.Depth = 1;
         result.Layers = texture.Layers * 6;
-        result.MipCount = texture.MipCount;
+        // every mip of a cross still holds a cross, as long as its faces do not drop below one texel
+        result.MipCount = copyRows ? std::min(texture.MipCount, GetMipLevelCount(faceSize)) : 1;
         result.TextureFormat = texture.TextureFormat;
         result.Type = TextureType::TEXTURE_CUBE;
+        // faces are stored the way cube map sampling addresses them
+        result.TopDown = true;
+        result.AllocateSubresources();
+
+        const uint32_t pixelSize = GetPixelByteSize(texture.TextureFormat);
+        auto forEach = [&info](size_t count, const std::function<void(size_t)>& function)
+        {
+            if (info.Multithreaded)
+            {
+                GetThreadPool()->ParallelFor(count, function);
+            }
+            else
+            {
+                for (size_t index = 0; index < count; index++)
+                    function(index);
+            }
+        };
+
+        auto startTime = std::chrono::steady_clock::now();
+        if (copyRows)
+        {
+            // one job per face of every mip, each copies whole rows from the cross into the preallocated face
+            forEach(size_t(texture.Layers) * result.MipCount * 6, [&](size_t index)
+            {
+                uint32_t face = uint32_t(index % 6);
+                uint32_t mip = uint32_t(index / 6 % result.MipCount);
+                uint32_t layer = uint32_t(index / 6 / result.MipCount);
+
+                const TextureSubresource& sourceSubresource = texture.GetSubresource(layer, mip);
+                const uint8_t* source = texture.GetSubresourceData(layer, mip);
+                const TextureSubresource& faceSubresource = result.GetSubresource(6 * layer + face, mip);
+                uint8_t* target = result.GetSubresourceData(6 * layer + face, mip);
+                size_t bytesInRow = size_t(faceSubresource.Width) * pixelSize;
+
+                for (uint32_t row = 0; row < faceSubresource.Height; row++)
+                {
+                    uint32_t crossRow = CubeMapCrossCells[face][1] * faceSubresource.Height + row;
+                    uint32_t sourceRow = texture.TopDown ? crossRow : sourceSubresource.Height - 1 - crossRow;
+                    size_t sourceOffset = (size_t(sourceRow) * sourceSubresource.Width + CubeMapCrossCells[face][0] * faceSubresource.Width) * pixelSize;
+                    std::memcpy(target + row * bytesInRow, source + sourceOffset, bytesInRow);
+                }
+            });
+        }
+        else
+        {
+            // one job per row of every face, each resamples the top mip of the source
+            forEach(size_t(texture.Layers) * 6 * faceSize, [&](size_t index)
+            {
+                uint32_t row = uint32_t(index % faceSize);
+                uint32_t face = uint32_t(index / faceSize % 6);
+                uint32_t layer = uint32_t(index / faceSize / 6);
+
+                const uint8_t* source = texture.GetSubresourceData(layer, 0);
+                uint8_t* target = result.GetSubresourceData(6 * layer + face, 0) + size_t(row) * faceSize * pixelSize;
 
-        VALX_ASSERT(result.Width == result.Height);
+                CubeMapSourceRegion region;
+                region.Width = texture.Width;
+                region.Height = texture.Height;
+                region.WrapX = info.Layout == CubeMapLayout::EQUIRECTANGULAR;
+                if (info.Layout == CubeMapLayout::CROSS_4X3)
+                {
+                    uint32_t cellRow = texture.TopDown ? CubeMapCrossCells[face][1] : 2 - CubeMapCrossCells[face][1];
+                    region.MinX = CubeMapCrossCells[face][0] * nativeFaceSize;
+                    region.MinY = cellRow * nativeFaceSize;
+                    region.Width = nativeFaceSize;
+                    region.Height = nativeFaceSize;
+                }
 
-        result.Data.Layers.resize(result.Layers);
+                float v = 2.0f * (float(row) + 0.5f) / float(faceSize) - 1.0f;
+                for (uint32_t column = 0; column < faceSize; column++)
+                {
+                    float u = 2.0f * (float(column) + 0.5f) / float(faceSize) - 1.0f;
+                    // source positions in texels of the visual, top-down image
+                    float x = 0.0f;
+                    float y = 0.0f;
+                    if (info.Layout == CubeMapLayout::EQUIRECTANGULAR)
+                    {
+                        constexpr float PI = 3.14159265358979323846f;
+                        glm::vec3 direction = glm::normalize(GetCubeMapDirection(face, u, v));
+                        x = (std::atan2(direction.z, direction.x) / (2.0f * PI) + 0.5f) * float(texture.Width);
+                        y = (0.5f - std::asin(std::clamp(direction.y, -1.0f, 1.0f)) / PI) * float(texture.Height);
+                    }
+                    else
+                    {
+                        x = (float(CubeMapCrossCells[face][0]) + 0.5f * (u + 1.0f)) * float(nativeFaceSize);
+                        y = (float(CubeMapCrossCells[face][1]) + 0.5f * (v + 1.0f)) * float(nativeFaceSize);
+                    }
+                    if (!texture.TopDown)
+                        y = float(texture.Height) - y;
+
+                    glm::vec4 value = SampleCubeMapSource(source, texture.Width, texture.TextureFormat, pixelSize, region, x, y);
+                    StoreCubeMapTexel(target + size_t(column) * pixelSize, texture.TextureFormat, value);
+                }
+            });
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        GetCurrentLogger()->LogInfo("TextureLoader", fmt::format("texture `{}` converted to a cube map with {}x{} faces and {} mips in {:.1f} ms",
+            texture.FilePath, faceSize, faceSize, result.MipCount, milliseconds));
+        return result;
+    }
+
+    TextureData TextureLoader::CompressTexture(const TextureData& texture, const TextureCompressionInfo& info)
+    {
+        VALX_ASSERT(IsBlockCompressionSupported(info.TargetFormat));
+        VALX_ASSERT(GetLinearFormat(texture.TextureFormat) == Format::R8G8B8A8_UNORM && "only R8G8B8A8 textures can be compressed");
+
+        TextureData result;
+        result.FilePath = texture.FilePath;
+        result.Width = texture.Width;
+        result.Height = texture.Height;
+        result.Depth = texture.Depth;
+        result.Layers = texture.Layers;
+        result.MipCount = texture.MipCount;
+        result.Type = texture.Type;
+        result.TextureFormat = IsSRGBFormat(texture.TextureFormat) ? GetSRGBBlockFormat(info.TargetFormat) : info.TargetFormat;
+        result.TopDown = texture.TopDown;
+        result.AllocateSubresources();
+
+        // one job per row of blocks of every subresource, so small mips do not serialize the large ones
+        struct BlockRow
+        {
+            uint32_t Layer = 0;
+            uint32_t Mip = 0;
+            uint32_t Row = 0;
+        };
+        std::vector<BlockRow> blockRows;
+        uint32_t blockSize = GetCompressedBlockByteSize(result.TextureFormat);
+        size_t pixelCount = 0;
         for (uint32_t layer = 0; layer < texture.Layers; layer++)
         {
-            for (uint32_t face = 0; face < 6; face++)
+            for (uint32_t mip = 0; mip < texture.MipCount; mip++)
             {
-                result.Data.Layers[6 * layer + face].Mips.resize(result.MipCount);
+                uint32_t width = std::max(texture.Width >> mip, 1u);
+                uint32_t height = std::max(texture.Height >> mip, 1u);
+                uint32_t blockCountY = (height + 3) / 4;
+                for (uint32_t row = 0; row < blockCountY; row++)
+                    blockRows.push_back(BlockRow{ layer, mip, row });
+                pixelCount += size_t(width) * height;
             }
+        }
 
-            const TextureData::LayerData& layerData = texture.Data.Layers[layer];
-            for (uint32_t mip = 0; mip < texture.MipCount; mip++)
+        auto encodeBlockRow = [&](size_t index)
+        {
+            const BlockRow& blockRow = blockRows[index];
+            uint32_t width = std::max(texture.Width >> blockRow.Mip, 1u);
+            uint32_t height = std::max(texture.Height >> blockRow.Mip, 1u);
+            uint32_t blockCountX = (width + 3) / 4;
+            const uint8_t* source = texture.GetSubresourceData(blockRow.Layer, blockRow.Mip);
+            uint8_t* target = result.GetSubresourceData(blockRow.Layer, blockRow.Mip) + size_t(blockRow.Row) * blockCountX * blockSize;
+
+            for (uint32_t blockX = 0; blockX < blockCountX; blockX++)
             {
-                const TextureData::MipData& mipData = layerData.Mips[mip];
-                uint32_t width = std::max(result.Width / (1 << mip), 1u);
-                uint32_t height = std::max(result.Height / (1 << mip), 1u);
-
-                result.Data.Layers[6 * layer + 0].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 2, 1);
-                result.Data.Layers[6 * layer + 1].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 0, 1);
-                result.Data.Layers[6 * layer + 2].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 1, 2);
-                result.Data.Layers[6 * layer + 3].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 1, 0);
-                result.Data.Layers[6 * layer + 4].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 1, 1);
-                result.Data.Layers[6 * layer + 5].Mips[mip].Bytes = ExtractCubemapFace(mipData.Bytes, width, height, result.TextureFormat, 3, 1);
+                // pixels past the edge of the image repeat the last row and column
+                uint8_t pixels[64];
+                for (uint32_t y = 0; y < 4; y++)
+                {
+                    for (uint32_t x = 0; x < 4; x++)
+                    {
+                        uint32_t sourceX = std::min(4 * blockX + x, width - 1);
+                        uint32_t sourceY = std::min(4 * blockRow.Row + y, height - 1);
+                        std::memcpy(pixels + 4 * (4 * y + x), source + 4 * (size_t(sourceY) * width + sourceX), 4);
+                    }
+                }
+                EncodeBlock(pixels, result.TextureFormat, info.Quality, info.UseSIMD, target + size_t(blockX) * blockSize);
             }
+        };
+
+        auto startTime = std::chrono::steady_clock::now();
+        if (info.Multithreaded)
+        {
+            GetThreadPool()->ParallelFor(blockRows.size(), encodeBlockRow);
+        }
+        else
+        {
+            for (size_t index = 0; index < blockRows.size(); index++)
+                encodeBlockRow(index);
         }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
 
+        double megapixels = double(pixelCount) / 1e6;
+        GetCurrentLogger()->LogInfo("TextureLoader", fmt::format("texture `{}` compressed to format {}: {:.2f} MP in {:.1f} ms, {:.1f} MP/s",
+            texture.FilePath, (int)result.TextureFormat, megapixels, seconds * 1000.0, seconds > 0.0 ? megapixels / seconds : 0.0));
         return result;
     }
-}
\ No newline at end of file
+}
@@ -3,29 +3,55 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <future>
 
 #include "Format.h"
 #include "TextureType.h"
+#include "BlockCompression.h"
+#include "MipBuilder.h"
+#include "MappedFile.h"
+#include "Texture.h"
 
 namespace VALX
 {
+    // subresource offsets are multiples of 16 and of the texel block size, which satisfies the buffer copy rules of every format
+    size_t GetTextureSubresourceAlignment(Format format);
+    // fills a layer-major subresource table at aligned offsets and returns the byte size of the whole blob
+    size_t ComputeTextureSubresources(Format format, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipCount, uint32_t layers,
+        std::vector<TextureSubresource>& subresources);
+
     struct TextureData
     {
-        struct MipData
-        {
-            std::vector<char> Bytes;
-        };
-
-        struct LayerData
-        {
-            std::vector<MipData> Mips;
-        };
+        std::string FilePath;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Depth = 0;
+        uint32_t MipCount = 0;
+        uint32_t Layers = 0;
+        TextureType Type = TextureType::TEXTURE_2D;
+        Format TextureFormat = Format::R8G8B8A8_UNORM;
+        // rows start at the top of the image as stored in the file instead of being flipped to bottom-up,
+        // such textures are sampled with a flipped v coordinate. Passed on to the texture as TextureInfo::TopDown
+        bool TopDown = false;
+        // every subresource in one allocation, so a texture is staged with a single copy
+        std::vector<uint8_t> Bytes;
+        // layer-major, MipCount entries per layer
+        std::vector<TextureSubresource> Subresources;
 
-        struct InternalData
-        {
-            std::vector<LayerData> Layers;
-        };
+        // lays out the subresources of the description above and sizes Bytes to hold them, the contents are zeroed
+        void AllocateSubresources();
+        const TextureSubresource& GetSubresource(uint32_t layer, uint32_t mip) const { return this->Subresources[size_t(layer) * this->MipCount + mip]; }
+        uint8_t* GetSubresourceData(uint32_t layer, uint32_t mip) { return this->Bytes.data() + this->GetSubresource(layer, mip).Offset; }
+        const uint8_t* GetSubresourceData(uint32_t layer, uint32_t mip) const { return this->Bytes.data() + this->GetSubresource(layer, mip).Offset; }
+        bool IsEmpty() const { return this->Subresources.empty(); }
+    };
 
+    // texture data referenced in place inside a memory mapped file, valid as long as the object lives
+    struct MappedTextureData
+    {
         std::string FilePath;
         uint32_t Width = 0;
         uint32_t Height = 0;
@@ -34,13 +60,111 @@ namespace VALX
         uint32_t Layers = 0;
         TextureType Type = TextureType::TEXTURE_2D;
         Format TextureFormat = Format::R8G8B8A8_UNORM;
-        InternalData Data;
+        // mapped rows are never flipped
+        bool TopDown = true;
+        // layer-major, MipCount entries per layer, offsets are from the start of the file
+        std::vector<TextureSubresource> Subresources;
+        std::shared_ptr<MappedFile> File;
+
+        const TextureSubresource& GetSubresource(uint32_t layer, uint32_t mip) const { return this->Subresources[size_t(layer) * this->MipCount + mip]; }
+        const uint8_t* GetSubresourceData(uint32_t layer, uint32_t mip) const { return this->File->GetData() + this->GetSubresource(layer, mip).Offset; }
+        bool IsEmpty() const { return this->Subresources.empty(); }
+    };
+
+    // processing applied to a texture after it is read from disk, part of the texture cache key
+    struct TextureCookInfo
+    {
+        // images are stored bottom-up by default. DDS and zlib wrapped DDS files always keep the rows of the file and
+        // report it with TopDown, their data is never shuffled
+        bool FlipVertically = true;
+        // format of Radiance .hdr images: R16G16B16A16_SFLOAT, B10G11R11_UFLOAT_PACK32 without alpha at half the size,
+        // or R32G32B32A32_SFLOAT as decoded
+        Format HDRFormat = Format::R16G16B16A16_SFLOAT;
+        // rebuilds the mip chain with the CPU mip builder if the format supports it
+        bool BuildMips = false;
+        MipBuildInfo Mips;
+        // encodes R8G8B8A8 textures to a block format
+        bool Compress = false;
+        TextureCompressionInfo Compression;
+    };
+
+    struct TextureCacheStatistics
+    {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        // bytes of cooked texture data read from the cache instead of being produced again
+        uint64_t BytesSaved = 0;
+
+        double GetHitRate() const { return this->Hits + this->Misses > 0 ? double(this->Hits) / double(this->Hits + this->Misses) : 0.0; }
+    };
+
+    enum class CubeMapLayout
+    {
+        // 4x3 cells, top-down: +Y above -X +Z +X -Z, -Y below
+        CROSS_4X3,
+        // longitude along the width with +X in the center, +Y at the top
+        EQUIRECTANGULAR,
     };
 
+    struct CubeMapConversionInfo
+    {
+        CubeMapLayout Layout = CubeMapLayout::CROSS_4X3;
+        // edge length of the faces, 0 takes a quarter of the source width
+        uint32_t FaceSize = 0;
+        bool Multithreaded = true;
+        // name, format and mip count of the texture created by Context::CreateCubeMap, the format has to support storage writes
+        std::string Name;
+        Format TextureFormat = Format::R16G16B16A16_SFLOAT;
+        uint32_t Mips = ALL_MIPS;
+    };
+
+    // called on the worker thread that loaded the texture, may move the texture out, e.g. into a GPU upload.
+    // Files that fail to load are passed as an empty texture
+    using TextureLoadedCallback = std::function<void(size_t index, TextureData& texture)>;
+
     class TextureLoader
     {
+        std::string cacheDirectory;
+        std::atomic<uint64_t> cacheHits{ 0 };
+        std::atomic<uint64_t> cacheMisses{ 0 };
+        std::atomic<uint64_t> cacheBytesSaved{ 0 };
+        std::vector<Format> transcodeFormats;
+
     public:
-        TextureData LoadTextureFromFile(const std::string& filepath);
-        TextureData Convert2DTextureToCubeMap(const TextureData& texture);
+        // cooked textures are stored in and loaded from this directory, keyed by a hash of the source file bytes
+        // and the cook settings. An empty path disables the cache
+        void SetCacheDirectory(const std::string& directory);
+        const std::string& GetCacheDirectory() const;
+        TextureCacheStatistics GetCacheStatistics() const;
+        void ResetCacheStatistics();
+
+        // block formats BasisLZ and UASTC textures in .ktx2 files may be transcoded to, set by the context from the formats the device
+        // samples. The best one for the content is picked, R8G8B8A8 is the fallback. Set before textures are loaded
+        void SetTranscodeFormats(const std::vector<Format>& formats);
+        const std::vector<Format>& GetTranscodeFormats() const;
+
+        // decodes .dds, .zlib and .ktx2 files (uncompressed, zlib, and with the optional libraries Zstandard, BasisLZ and UASTC
+        // supercompressed) and every image format stb reads
+        TextureData LoadTextureFromFile(const std::string& filepath, const TextureCookInfo& cookInfo = {});
+        // loads and cooks every file as a separate thread pool task, the futures are in the order of the paths.
+        // The loader has to outlive the returned futures
+        std::vector<std::future<TextureData>> LoadTexturesAsync(const std::vector<std::string>& filepaths, const TextureCookInfo& cookInfo = {},
+            const TextureLoadedCallback& onLoaded = nullptr);
+        // maps a .dds file and parses its header in place, the pixel data is neither copied nor flipped.
+        // Returns an empty result for files that can not be mapped or formats the header parser does not handle
+        MappedTextureData MapDDSFile(const std::string& filepath);
+        // deflates a .dds file into the chunked .zlib container, chunkSize bytes of the file per chunk. The chunks are compressed
+        // on the thread pool and inflated in parallel when the file is loaded
+        bool WriteChunkedZLIB(const std::string& ddsFilepath, const std::string& outputFilepath, uint32_t chunkSize = 1 << 20);
+        // copies a rectangle of one mip of a mapped texture into tightly packed rows, coordinates outside the mip repeat its edge.
+        // Block compressed formats are copied in whole blocks, so the rectangle has to be block aligned
+        void ReadTextureRegion(const MappedTextureData& texture, uint32_t layer, uint32_t mip, int32_t x, int32_t y, uint32_t width, uint32_t height, uint8_t* output);
+        // applies the mip and compression steps of the cook settings, flipping happens while the file is read
+        TextureData CookTexture(TextureData texture, const TextureCookInfo& cookInfo);
+        // cross layouts at their native face size are copied row by row with every mip of the source, any other conversion
+        // resamples the top mip bilinearly into a single mip. Faces are written top-down in parallel straight into the result
+        TextureData Convert2DTextureToCubeMap(const TextureData& texture, const CubeMapConversionInfo& info = {});
+        // transcodes every layer and mip of an R8G8B8A8 texture to a BC format, logs the encode throughput
+        TextureData CompressTexture(const TextureData& texture, const TextureCompressionInfo& info);
     };
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "TexturePacker.h"
+#include "Context.h"
+#include "MipBuilder.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace VALX
+{
+    struct AtlasPlacement
+    {
+        uint32_t Layer = 0;
+        uint32_t X = 0;
+        uint32_t Y = 0;
+    };
+
+    static uint32_t GetAtlasCellSize(uint32_t size, uint32_t padding)
+    {
+        return (size + 2 * padding + padding - 1) / padding * padding;
+    }
+
+    // writes the top mip at x, y surrounded by padding texels that repeat its edges, so filtering and mips of
+    // the atlas read the entry itself instead of its neighbours
+    static void CopyWithGutter(const TextureData& source, uint8_t* target, uint32_t atlasSize, uint32_t x, uint32_t y, uint32_t padding)
+    {
+        size_t pixelSize = GetPixelByteSize(source.TextureFormat);
+        size_t sourceRowPitch = GetImageRowPitch(source.TextureFormat, source.Width);
+        size_t targetRowPitch = GetImageRowPitch(source.TextureFormat, atlasSize);
+        const uint8_t* sourceBytes = source.GetSubresourceData(0, 0);
+
+        int32_t height = (int32_t)source.Height;
+        for (int32_t row = -(int32_t)padding; row < height + (int32_t)padding; row++)
+        {
+            const uint8_t* sourceRow = sourceBytes + size_t(std::clamp(row, 0, height - 1)) * sourceRowPitch;
+            uint8_t* targetRow = target + size_t(int32_t(y + padding) + row) * targetRowPitch + size_t(x) * pixelSize;
+            for (uint32_t i = 0; i < padding; i++)
+                std::memcpy(targetRow + i * pixelSize, sourceRow, pixelSize);
+            std::memcpy(targetRow + padding * pixelSize, sourceRow, source.Width * pixelSize);
+            for (uint32_t i = 0; i < padding; i++)
+                std::memcpy(targetRow + (padding + source.Width + i) * pixelSize, sourceRow + (source.Width - 1) * pixelSize, pixelSize);
+        }
+    }
+
+    TexturePacker::TexturePacker(const TexturePackerInfo& info)
+        : info(info)
+    {
+        VALX_ASSERT(info.AtlasPadding > 0 && (info.AtlasPadding & (info.AtlasPadding - 1)) == 0 && "atlas padding has to be a power of two");
+        VALX_ASSERT(info.MaxLayers > 0);
+    }
+
+    PackedTextureHandle TexturePacker::AddTexture(TextureData data, const std::string& name)
+    {
+        VALX_ASSERT(!data.IsEmpty());
+        PackedTextureHandle handle = static_cast<PackedTextureHandle>(this->packedTextures.size());
+        this->packedTextures.emplace_back();
+        this->pendingTextures.push_back(PendingTexture{ std::move(data), name, handle });
+        return handle;
+    }
+
+    const Texture* TexturePacker::CreateTexture(Context& context, const TextureData& data, const std::string& name)
+    {
+        TextureInfo textureInfo;
+        textureInfo.Name = name;
+        textureInfo.Type = data.Type;
+        textureInfo.TextureFormat = data.TextureFormat;
+        textureInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST;
+        textureInfo.Width = data.Width;
+        textureInfo.Height = data.Height;
+        textureInfo.Depth = std::max(data.Depth, 1u);
+        textureInfo.Layers = data.Layers;
+        textureInfo.Mips = data.MipCount;
+        textureInfo.TopDown = data.TopDown;
+
+        std::unique_ptr<Texture> texture = context.CreateTexture(textureInfo);
+        context.UploadTexture(*texture, data, TextureUploadInfo{});
+        this->statistics.CreatedTextureCount++;
+        return this->textures.emplace_back(std::move(texture)).get();
+    }
+
+    void TexturePacker::BuildArrays(Context& context, std::vector<PendingTexture*>& group)
+    {
+        const TextureData& first = group.front()->Data;
+        for (size_t begin = 0; begin < group.size(); begin += this->info.MaxLayers)
+        {
+            uint32_t layerCount = static_cast<uint32_t>(std::min<size_t>(this->info.MaxLayers, group.size() - begin));
+
+            TextureData array;
+            array.FilePath = fmt::format("{} array {}x{} #{}", this->info.Name, first.Width, first.Height, this->textures.size());
+            array.Width = first.Width;
+            array.Height = first.Height;
+            array.Depth = 1;
+            array.MipCount = first.MipCount;
+            array.Layers = layerCount;
+            array.TextureFormat = first.TextureFormat;
+            array.TopDown = first.TopDown;
+            array.AllocateSubresources();
+
+            for (uint32_t layer = 0; layer < layerCount; layer++)
+            {
+                TextureData& source = group[begin + layer]->Data;
+                for (uint32_t mip = 0; mip < array.MipCount; mip++)
+                    std::memcpy(array.GetSubresourceData(layer, mip), source.GetSubresourceData(0, mip), source.GetSubresource(0, mip).Size);
+                source = TextureData{};
+            }
+
+            const Texture* texture = this->CreateTexture(context, array, array.FilePath);
+            for (uint32_t layer = 0; layer < layerCount; layer++)
+            {
+                PackedTexture& packed = this->packedTextures[group[begin + layer]->Handle];
+                packed.Container = texture;
+                packed.Layer = layer;
+            }
+            this->statistics.ArrayLayerCount += layerCount;
+        }
+    }
+
+    void TexturePacker::BuildAtlas(Context& context, std::vector<PendingTexture*>& group)
+    {
+        uint32_t atlasSize = this->info.AtlasSize;
+        uint32_t padding = this->info.AtlasPadding;
+
+        // tallest first keeps the shelves tight, every entry stays aligned to the padding so it covers whole texels in every mip
+        std::sort(group.begin(), group.end(), [](const PendingTexture* left, const PendingTexture* right)
+        {
+            return std::make_pair(left->Data.Height, left->Data.Width) > std::make_pair(right->Data.Height, right->Data.Width);
+        });
+
+        std::vector<AtlasPlacement> placements(group.size());
+        uint32_t layer = 0;
+        uint32_t shelfY = 0;
+        uint32_t shelfHeight = 0;
+        uint32_t cursorX = 0;
+        for (size_t i = 0; i < group.size(); i++)
+        {
+            uint32_t cellWidth = GetAtlasCellSize(group[i]->Data.Width, padding);
+            uint32_t cellHeight = GetAtlasCellSize(group[i]->Data.Height, padding);
+            if (cursorX + cellWidth > atlasSize)
+            {
+                shelfY += shelfHeight;
+                shelfHeight = 0;
+                cursorX = 0;
+            }
+            if (shelfY + cellHeight > atlasSize)
+            {
+                layer++;
+                shelfY = 0;
+                shelfHeight = 0;
+                cursorX = 0;
+            }
+            placements[i] = AtlasPlacement{ layer, cursorX, shelfY };
+            cursorX += cellWidth;
+            shelfHeight = std::max(shelfHeight, cellHeight);
+        }
+
+        const TextureData& first = group.front()->Data;
+        uint32_t layerCount = layer + 1;
+        for (uint32_t beginLayer = 0; beginLayer < layerCount; beginLayer += this->info.MaxLayers)
+        {
+            uint32_t endLayer = std::min(layerCount, beginLayer + this->info.MaxLayers);
+
+            TextureData atlas;
+            atlas.FilePath = fmt::format("{} atlas #{}", this->info.Name, this->textures.size());
+            atlas.Width = atlasSize;
+            atlas.Height = atlasSize;
+            atlas.Depth = 1;
+            atlas.MipCount = 1;
+            atlas.Layers = endLayer - beginLayer;
+            atlas.TextureFormat = first.TextureFormat;
+            atlas.TopDown = first.TopDown;
+            atlas.AllocateSubresources();
+
+            // entries never overlap, each one is copied on its own
+            GetThreadPool()->ParallelFor(group.size(), [&](size_t i)
+            {
+                const AtlasPlacement& placement = placements[i];
+                if (placement.Layer >= beginLayer && placement.Layer < endLayer)
+                    CopyWithGutter(group[i]->Data, atlas.GetSubresourceData(placement.Layer - beginLayer, 0), atlasSize, placement.X, placement.Y, padding);
+            });
+
+            // a box filter reads only the texels the mip texel covers, so the gutter halves per mip and never runs out
+            MipBuildInfo mipInfo;
+            mipInfo.Filter = MipFilter::BOX;
+            mipInfo.MipCount = GetMipLevelCount(padding);
+            BuildMips(atlas, mipInfo);
+
+            const Texture* texture = this->CreateTexture(context, atlas, atlas.FilePath);
+            for (size_t i = 0; i < group.size(); i++)
+            {
+                const AtlasPlacement& placement = placements[i];
+                if (placement.Layer < beginLayer || placement.Layer >= endLayer)
+                    continue;
+
+                const TextureData& source = group[i]->Data;
+                PackedTexture& packed = this->packedTextures[group[i]->Handle];
+                packed.Container = texture;
+                packed.Layer = placement.Layer - beginLayer;
+                packed.UVOffset[0] = float(placement.X + padding) / float(atlasSize);
+                packed.UVOffset[1] = float(placement.Y + padding) / float(atlasSize);
+                packed.UVScale[0] = float(source.Width) / float(atlasSize);
+                packed.UVScale[1] = float(source.Height) / float(atlasSize);
+            }
+        }
+        this->statistics.AtlasEntryCount += static_cast<uint32_t>(group.size());
+
+        for (PendingTexture* pending : group)
+            pending->Data = TextureData{};
+    }
+
+    void TexturePacker::Build(Context& context)
+    {
+        if (this->pendingTextures.empty())
+            return;
+        size_t createdTextureCount = this->textures.size();
+
+        std::map<std::tuple<Format, uint32_t, uint32_t, uint32_t, bool>, std::vector<PendingTexture*>> arrayGroups;
+        std::map<std::pair<Format, bool>, std::vector<PendingTexture*>> atlasGroups;
+        std::vector<PendingTexture*> standalone;
+        for (PendingTexture& pending : this->pendingTextures)
+        {
+            const TextureData& data = pending.Data;
+            bool isPackable = data.Type == TextureType::TEXTURE_2D && data.Layers == 1 && data.Depth <= 1 &&
+                std::max(data.Width, data.Height) <= this->info.MaxPackedSize;
+            if (isPackable)
+                arrayGroups[{ data.TextureFormat, data.Width, data.Height, data.MipCount, data.TopDown }].push_back(&pending);
+            else
+                standalone.push_back(&pending);
+        }
+
+        // a single texture of a size gains nothing from an array, it goes into the atlas if its format can be filtered on the CPU.
+        // The atlas only has the mips its padding covers, textures with a longer chain would lose their coarse mips there
+        uint32_t maxAtlasEntrySize = this->info.AtlasSize - 2 * this->info.AtlasPadding;
+        uint32_t maxAtlasMipCount = GetMipLevelCount(this->info.AtlasPadding);
+        for (auto& [key, group] : arrayGroups)
+        {
+            const TextureData& data = group.front()->Data;
+            if (group.size() > 1)
+                this->BuildArrays(context, group);
+            else if (IsMipBuildSupported(data.TextureFormat) && std::max(data.Width, data.Height) <= maxAtlasEntrySize && data.MipCount <= maxAtlasMipCount)
+                atlasGroups[{ data.TextureFormat, data.TopDown }].push_back(group.front());
+            else
+                standalone.push_back(group.front());
+        }
+
+        for (auto& [key, group] : atlasGroups)
+            this->BuildAtlas(context, group);
+
+        for (PendingTexture* pending : standalone)
+        {
+            PackedTexture& packed = this->packedTextures[pending->Handle];
+            packed.Container = this->CreateTexture(context, pending->Data, pending->Name);
+            this->statistics.StandaloneCount++;
+        }
+
+        GetCurrentLogger()->LogInfo("TexturePacker", fmt::format("`{}`: {} textures packed into {}, {} array layers, {} atlas entries and {} on their own so far",
+            this->info.Name, this->pendingTextures.size(), this->textures.size() - createdTextureCount, this->statistics.ArrayLayerCount,
+            this->statistics.AtlasEntryCount, this->statistics.StandaloneCount));
+        this->pendingTextures.clear();
+    }
+
+    const PackedTexture& TexturePacker::GetPackedTexture(PackedTextureHandle handle) const
+    {
+        VALX_ASSERT(handle < this->packedTextures.size() && this->packedTextures[handle].Container != nullptr && "texture is not packed yet, call Build");
+        return this->packedTextures[handle];
+    }
+
+    const std::vector<std::unique_ptr<Texture>>& TexturePacker::GetTextures() const
+    {
+        return this->textures;
+    }
+
+    TexturePackerStatistics TexturePacker::GetStatistics() const
+    {
+        return this->statistics;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Texture.h"
+#include "TextureLoader.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VALX
+{
+    class Context;
+
+    struct TexturePackerInfo
+    {
+        // prefix of the names of the created textures
+        std::string Name = "Packed";
+        // textures larger than this in either dimension get a texture of their own
+        uint32_t MaxPackedSize = 256;
+        uint32_t AtlasSize = 2048;
+        // power of two, texels of edge replicated gutter around every atlas entry. The atlas gets log2(padding) + 1 box
+        // filtered mips, in each of them the entries stay aligned to texels and keep at least one texel of gutter.
+        // Textures with more mips than that are not put into the atlas, raise the padding to pack longer chains
+        uint32_t AtlasPadding = 8;
+        // layers of one array or atlas texture, further textures of the same kind start a new one
+        uint32_t MaxLayers = 256;
+    };
+
+    // index of a texture in the order it was added
+    using PackedTextureHandle = uint32_t;
+
+    // where a packed texture ended up, valid once Build has run. Shaders sample the layer at uv * UVScale + UVOffset,
+    // for array layers and textures of their own the transform is the identity
+    struct PackedTexture
+    {
+        // array, atlas or texture of its own that holds the data
+        const Texture* Container = nullptr;
+        uint32_t Layer = 0;
+        float UVOffset[2] = { 0.0f, 0.0f };
+        float UVScale[2] = { 1.0f, 1.0f };
+    };
+
+    struct TexturePackerStatistics
+    {
+        uint32_t ArrayLayerCount = 0;
+        uint32_t AtlasEntryCount = 0;
+        uint32_t StandaloneCount = 0;
+        // textures created for all of the above, one per texture without the packer
+        uint32_t CreatedTextureCount = 0;
+    };
+
+    // groups small textures into fewer GPU textures: textures of the same format, size, mip count and row order go into the
+    // layers of 2D arrays, the remaining ones of formats the mip builder supports are shelf packed into atlas layers.
+    // Block compressed textures without a partner, mip chains longer than the atlas keeps and everything larger, cube,
+    // 3D or arrayed get a texture of their own
+    class TexturePacker
+    {
+        struct PendingTexture
+        {
+            TextureData Data;
+            std::string Name;
+            PackedTextureHandle Handle = 0;
+        };
+
+        TexturePackerInfo info;
+        std::vector<PendingTexture> pendingTextures;
+        std::vector<PackedTexture> packedTextures;
+        std::vector<std::unique_ptr<Texture>> textures;
+        TexturePackerStatistics statistics;
+
+        const Texture* CreateTexture(Context& context, const TextureData& data, const std::string& name);
+        void BuildArrays(Context& context, std::vector<PendingTexture*>& group);
+        void BuildAtlas(Context& context, std::vector<PendingTexture*>& group);
+
+    public:
+        TexturePacker(const TexturePackerInfo& info = {});
+
+        VALX_NO_COPY_NO_MOVE(TexturePacker);
+
+        // the data is kept until the next Build
+        PackedTextureHandle AddTexture(TextureData data, const std::string& name);
+        // packs, creates and uploads every texture added since the last call, blocks until the uploads are done
+        void Build(Context& context);
+
+        const PackedTexture& GetPackedTexture(PackedTextureHandle handle) const;
+        const std::vector<std::unique_ptr<Texture>>& GetTextures() const;
+        TexturePackerStatistics GetStatistics() const;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Texture.h"
+#include "CommandBuffer.h"
+
+#include <string>
+#include <vector>
+
+namespace VALX
+{
+    struct TextureStreamerInfo
+    {
+        // texture memory the streamer may keep resident, 0 derives it every frame from the budget of the device local heap
+        uint64_t BudgetBytes = 0;
+        // share of the device local heap budget taken when BudgetBytes is 0, the rest is left to other resources
+        float BudgetFraction = 0.5f;
+        // mips of at most this many texels are uploaded when a texture is added and never evicted
+        uint32_t MinResidentSize = 128;
+        // finished loads beyond this wait for the next frame, a single mip larger than it is still uploaded
+        uint64_t MaxUploadBytesPerFrame = 32 * 1024 * 1024;
+        uint32_t MaxPendingLoads = 8;
+        // frames the GPU runs behind the CPU, replaced textures and staging memory are released this many frames later
+        uint32_t FramesInFlight = 2;
+    };
+
+    struct TextureStreamerStatistics
+    {
+        uint64_t ResidentBytes = 0;
+        uint64_t BudgetBytes = 0;
+        uint32_t TextureCount = 0;
+        uint32_t PendingLoads = 0;
+        uint64_t StreamedMips = 0;
+        uint64_t EvictedMips = 0;
+    };
+
+    // stable slot of a streamed texture, the texture in it is replaced whenever mips are streamed in or evicted
+    using StreamedTextureHandle = uint32_t;
+
+    // keeps the mip chains of .dds textures resident as far as the budget allows. Textures are added with their smallest mips only,
+    // the finer ones are read from the mapped file on the thread pool in order of the screen size and distance they were last
+    // requested with, and the mips of the least recently used textures are evicted when the budget runs out
+    class TextureStreamer
+    {
+    public:
+        // maps the file and uploads the mips up to MinResidentSize, blocks for those only. Formats the device can not sample are
+        // streamed in their fallback format, see GetFallbackFormat
+        virtual StreamedTextureHandle AddTexture(const std::string& filePath, const std::string& name) = 0;
+        // the texture is released once the frames in flight are done with it
+        virtual void RemoveTexture(StreamedTextureHandle handle) = 0;
+        // reports a use until the next Update. Screen size is the extent in pixels the texture covers at its largest, it selects the
+        // mip that is needed; distance to the camera orders requests of equal size. Requests in one frame keep the largest size
+        virtual void RequestTexture(StreamedTextureHandle handle, float screenSize, float distance) = 0;
+        // call once per frame before the textures are bound, the frame FramesInFlight frames ago has to have finished. Records the
+        // copies of finished loads and evictions, then schedules loads for the textures requested since the last call
+        virtual void Update(CommandBuffer& commandBuffer) = 0;
+
+        virtual Texture& GetTexture(StreamedTextureHandle handle) = 0;
+        // slots whose texture the last Update replaced, descriptors referring to them have to be rewritten
+        virtual const std::vector<StreamedTextureHandle>& GetChangedTextures() const = 0;
+        // index of the most detailed resident mip in the mip chain of the file
+        virtual uint32_t GetResidentMip(StreamedTextureHandle handle) const = 0;
+        virtual TextureStreamerStatistics GetStatistics() const = 0;
+        virtual ~TextureStreamer() = default;
+    };
+}
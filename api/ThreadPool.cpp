@@ -0,0 +1,114 @@
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <algorithm>
+
+namespace VALX
+{
+    ThreadPool::ThreadPool(size_t threadCount)
+    {
+        this->workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            this->workers.emplace_back([this]() { this->WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->isStopping = true;
+        }
+        this->condition.notify_all();
+
+        for (std::thread& worker : this->workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [this]() { return this->isStopping || !this->tasks.empty(); });
+                if (this->isStopping && this->tasks.empty())
+                    return;
+
+                task = std::move(this->tasks.front());
+                this->tasks.pop();
+            }
+            task();
+        }
+    }
+
+    size_t ThreadPool::GetThreadCount() const
+    {
+        return this->workers.size();
+    }
+
+    void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& function)
+    {
+        if (count == 0)
+            return;
+
+        if (count == 1 || this->workers.empty())
+        {
+            for (size_t i = 0; i < count; i++)
+                function(i);
+            return;
+        }
+
+        struct SharedState
+        {
+            std::function<void(size_t)> Function;
+            std::atomic<size_t> NextIndex{ 0 };
+            std::atomic<size_t> CompletedCount{ 0 };
+            size_t Count = 0;
+            std::mutex Mutex;
+            std::condition_variable Done;
+        };
+
+        auto state = std::make_shared<SharedState>();
+        state->Function = function;
+        state->Count = count;
+
+        auto runItems = [state]()
+        {
+            size_t index = 0;
+            while ((index = state->NextIndex.fetch_add(1)) < state->Count)
+            {
+                state->Function(index);
+                if (state->CompletedCount.fetch_add(1) + 1 == state->Count)
+                {
+                    std::lock_guard<std::mutex> lock(state->Mutex);
+                    state->Done.notify_all();
+                }
+            }
+        };
+
+        size_t helperCount = std::min(count, this->workers.size() + 1) - 1;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            for (size_t i = 0; i < helperCount; i++)
+                this->tasks.emplace(runItems);
+        }
+        this->condition.notify_all();
+
+        runItems();
+
+        // helpers which did not start yet will find no work left, so we only wait for the items in flight
+        std::unique_lock<std::mutex> lock(state->Mutex);
+        state->Done.wait(lock, [&state]() { return state->CompletedCount.load() == state->Count; });
+    }
+
+    ThreadPool* GetThreadPool()
+    {
+        static ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        return &threadPool;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Utilities.h"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace VALX
+{
+    class ThreadPool
+    {
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool isStopping = false;
+
+        void WorkerLoop();
+    public:
+        ThreadPool(size_t threadCount);
+        ~ThreadPool();
+
+        VALX_NO_COPY_NO_MOVE(ThreadPool);
+
+        size_t GetThreadCount() const;
+
+        template<typename F>
+        auto Submit(F&& function) -> std::future<decltype(function())>
+        {
+            using ResultType = decltype(function());
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(function));
+            std::future<ResultType> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->tasks.emplace([task]() { (*task)(); });
+            }
+            this->condition.notify_one();
+            return result;
+        }
+
+        // calls function(i) for every i in [0, count), the calling thread takes part in the work.
+        // safe to call from inside a pool task, as the caller never waits for a task which has not started yet
+        void ParallelFor(size_t count, const std::function<void(size_t)>& function);
+    };
+
+    ThreadPool* GetThreadPool();
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "VertexLayout.h"
+#include "Utilities.h"
+
+#include <cstddef>
+#include <cmath>
+
+namespace VALX
+{
+    VertexLayout GetVertexLayout(VertexFormat format)
+    {
+        VertexLayout layout;
+        switch (format)
+        {
+        case VALX::VertexFormat::FULL:
+            layout.Stride = sizeof(Vertex);
+            layout.Attributes = {
+                { 0, Format::R32G32B32_SFLOAT, offsetof(Vertex, Position) },
+                { 1, Format::R32G32_SFLOAT, offsetof(Vertex, TexCoord) },
+                { 2, Format::R32G32B32_SFLOAT, offsetof(Vertex, Normal) },
+                { 3, Format::R32G32B32_SFLOAT, offsetof(Vertex, Tangent) },
+                { 4, Format::R32G32B32_SFLOAT, offsetof(Vertex, Bitangent) },
+            };
+            break;
+        case VALX::VertexFormat::QUANTIZED:
+            layout.Stride = sizeof(QuantizedVertex);
+            layout.Attributes = {
+                { 0, Format::R16G16B16A16_SNORM, offsetof(QuantizedVertex, Position) },
+                { 1, Format::R16G16_SFLOAT, offsetof(QuantizedVertex, TexCoord) },
+                { 2, Format::R16G16_SNORM, offsetof(QuantizedVertex, Normal) },
+                { 3, Format::R16G16_SNORM, offsetof(QuantizedVertex, Tangent) },
+            };
+            break;
+        default:
+            VALX_ASSERT(false && "invalid vertex format");
+            break;
+        }
+        return layout;
+    }
+
+    glm::vec2 EncodeOctahedral(const glm::vec3& direction)
+    {
+        float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (sum == 0.0f)
+            return glm::vec2(0.0f);
+
+        glm::vec2 result(direction.x / sum, direction.y / sum);
+        if (direction.z < 0.0f)
+        {
+            // fold the lower hemisphere over the diagonals
+            result = glm::vec2(
+                (1.0f - std::abs(result.y)) * (result.x >= 0.0f ? 1.0f : -1.0f),
+                (1.0f - std::abs(result.x)) * (result.y >= 0.0f ? 1.0f : -1.0f)
+            );
+        }
+        return result;
+    }
+
+    glm::vec3 DecodeOctahedral(const glm::vec2& encoded)
+    {
+        glm::vec3 result(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        float t = std::max(-result.z, 0.0f);
+        result.x += result.x >= 0.0f ? -t : t;
+        result.y += result.y >= 0.0f ? -t : t;
+        return glm::normalize(result);
+    }
+
+    QuantizedVertex QuantizeVertex(const Vertex& vertex, const VertexQuantization& quantization)
+    {
+        QuantizedVertex result;
+        glm::vec3 position = (vertex.Position - quantization.PositionOffset) / quantization.PositionScale;
+        glm::vec2 normal = EncodeOctahedral(vertex.Normal);
+        glm::vec2 tangent = EncodeOctahedral(vertex.Tangent);
+        float handedness = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) < 0.0f ? -1.0f : 1.0f;
+
+        result.Position[0] = FloatToSnorm16(position.x);
+        result.Position[1] = FloatToSnorm16(position.y);
+        result.Position[2] = FloatToSnorm16(position.z);
+        result.Position[3] = FloatToSnorm16(handedness);
+        result.TexCoord[0] = FloatToHalf(vertex.TexCoord.x);
+        result.TexCoord[1] = FloatToHalf(vertex.TexCoord.y);
+        result.Normal[0] = FloatToSnorm16(normal.x);
+        result.Normal[1] = FloatToSnorm16(normal.y);
+        result.Tangent[0] = FloatToSnorm16(tangent.x);
+        result.Tangent[1] = FloatToSnorm16(tangent.y);
+        return result;
+    }
+
+    Vertex DequantizeVertex(const QuantizedVertex& vertex, const VertexQuantization& quantization)
+    {
+        Vertex result;
+        glm::vec3 position(Snorm16ToFloat(vertex.Position[0]), Snorm16ToFloat(vertex.Position[1]), Snorm16ToFloat(vertex.Position[2]));
+        result.Position = quantization.PositionOffset + position * quantization.PositionScale;
+        result.TexCoord = glm::vec2(HalfToFloat(vertex.TexCoord[0]), HalfToFloat(vertex.TexCoord[1]));
+        result.Normal = DecodeOctahedral(glm::vec2(Snorm16ToFloat(vertex.Normal[0]), Snorm16ToFloat(vertex.Normal[1])));
+        result.Tangent = DecodeOctahedral(glm::vec2(Snorm16ToFloat(vertex.Tangent[0]), Snorm16ToFloat(vertex.Tangent[1])));
+        result.Bitangent = glm::cross(result.Normal, result.Tangent) * Snorm16ToFloat(vertex.Position[3]);
+        return result;
+    }
+}
\ No newline at end of file
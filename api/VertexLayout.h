@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Format.h"
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace VALX
+{
+    // matches the vertex inputs expected by the default shaders (see examples/dummy/main_vertex.glsl)
+    struct Vertex
+    {
+        glm::vec3 Position = glm::vec3(0.0f);
+        glm::vec2 TexCoord = glm::vec2(0.0f);
+        glm::vec3 Normal = glm::vec3(0.0f);
+        glm::vec3 Tangent = glm::vec3(0.0f);
+        glm::vec3 Bitangent = glm::vec3(0.0f);
+    };
+
+    // 20 bytes instead of 56: position is normalized to the mesh bounds (see VertexQuantization),
+    // normal and tangent are octahedral encoded, bitangent is reconstructed from their cross product and the sign in Position[3]
+    struct QuantizedVertex
+    {
+        int16_t Position[4] = { };
+        uint16_t TexCoord[2] = { };
+        int16_t Normal[2] = { };
+        int16_t Tangent[2] = { };
+    };
+
+    // dequantized position = PositionOffset + snorm(Position.xyz) * PositionScale
+    struct VertexQuantization
+    {
+        glm::vec3 PositionOffset = glm::vec3(0.0f);
+        glm::vec3 PositionScale = glm::vec3(1.0f);
+    };
+
+    enum class VertexFormat
+    {
+        FULL,
+        QUANTIZED,
+    };
+
+    struct VertexAttribute
+    {
+        uint32_t Location = 0;
+        Format AttributeFormat = Format::UNKNOWN;
+        uint32_t Offset = 0;
+    };
+
+    struct VertexLayout
+    {
+        uint32_t Stride = 0;
+        std::vector<VertexAttribute> Attributes;
+    };
+
+    VertexLayout GetVertexLayout(VertexFormat format = VertexFormat::FULL);
+
+    glm::vec2 EncodeOctahedral(const glm::vec3& direction);
+    glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+    QuantizedVertex QuantizeVertex(const Vertex& vertex, const VertexQuantization& quantization);
+    Vertex DequantizeVertex(const QuantizedVertex& vertex, const VertexQuantization& quantization);
+}
\ No newline at end of file
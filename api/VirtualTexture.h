@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Texture.h"
+#include "Buffer.h"
+#include "CommandBuffer.h"
+
+#include <string>
+
+namespace VALX
+{
+    struct VirtualTextureInfo
+    {
+        std::string Name;
+        // .dds file the pages are read from, it stays mapped and only requested pages are copied out of it
+        std::string FilePath;
+        // texels of a page without its border, a multiple of 4 for block compressed files
+        uint32_t PageSize = 128;
+        // texels of the neighbouring pages repeated around every page, so filter taps stay inside it
+        uint32_t PageBorder = 4;
+        // size of the physical page cache, together with the page size it bounds the resident memory
+        uint32_t PhysicalPageCountX = 32;
+        uint32_t PhysicalPageCountY = 32;
+        // unique page requests a frame can report, later ones are dropped and requested again next frame
+        uint32_t FeedbackCapacity = 4096;
+        uint32_t MaxUploadsPerFrame = 32;
+        uint32_t MaxPendingLoads = 128;
+        // frames the GPU runs behind the CPU, feedback is read back and staging memory reused this many frames later
+        uint32_t FramesInFlight = 2;
+    };
+
+    struct VirtualTextureStatistics
+    {
+        uint32_t ResidentPages = 0;
+        uint32_t PendingLoads = 0;
+        uint64_t LoadedPages = 0;
+        uint64_t EvictedPages = 0;
+        // requests lost to a full feedback buffer or the pending load limit
+        uint64_t DroppedRequests = 0;
+    };
+
+    // texture sampled through an indirection table from a fixed size cache of pages, which are streamed in on demand.
+    // Shaders prepend GetShaderSource, sample with SampleVirtualTexture and report the pages they need with
+    // RequestVirtualTexturePage, which writes into the feedback buffer (storage writes from fragment shaders need
+    // the fragmentStoresAndAtomics feature). The coarsest mip is always resident, missing pages fall back to it
+    class VirtualTexture
+    {
+    public:
+        // call once per frame before the passes that sample the texture, the frame FramesInFlight frames ago has to have
+        // finished. Reads its feedback, schedules loads of the missing pages on the thread pool and records the copies
+        // of finished loads, the indirection update and the clear of the feedback buffer of this frame
+        virtual void Update(CommandBuffer& commandBuffer) = 0;
+        // call after the last pass that requests pages, makes the feedback of this frame readable by the host
+        virtual void FinishFrame(CommandBuffer& commandBuffer) = 0;
+
+        virtual Texture& GetPhysicalTexture() = 0;
+        // R32_UINT, one texel per page and mip
+        virtual Texture& GetIndirectionTexture() = 0;
+        // the buffer of the current frame, bound as a storage buffer where the shader source declares it
+        virtual Buffer& GetFeedbackBuffer() = 0;
+        // GLSL declarations and functions for this texture, the including shader defines VIRTUAL_TEXTURE_FEEDBACK_SET
+        // and VIRTUAL_TEXTURE_FEEDBACK_BINDING before it
+        virtual const std::string& GetShaderSource() const = 0;
+        virtual VirtualTextureStatistics GetStatistics() const = 0;
+        virtual ~VirtualTexture() = default;
+    };
+}
@@ -4,6 +4,8 @@
 #include "ExternalFunctions.h"
 #include "api/Logger.h"
 
+#include <cstring>
+
 namespace VALX
 {
     VulkanBuffer::VulkanBuffer(const BufferInfo& info)
@@ -40,12 +42,53 @@ namespace VALX
         return static_cast<Buffer::Handle>(this->buffer);
     }
 
+    uint8_t* VulkanBuffer::MapMemory()
+    {
+        void* memory = nullptr;
+        VALX_VK_SUCCESS(vmaMapMemory(GetVulkanContext()->GetAllocator(), this->allocation, &memory));
+        // read back memory may not be coherent, device writes have to be made visible to the host first
+        if (this->info.MemoryType == BufferMemory::FROM_GPU_TO_CPU)
+            VALX_VK_SUCCESS(vmaInvalidateAllocation(GetVulkanContext()->GetAllocator(), this->allocation, 0, VK_WHOLE_SIZE));
+        return static_cast<uint8_t*>(memory);
+    }
+
+    void VulkanBuffer::UnmapMemory()
+    {
+        VALX_VK_SUCCESS(vmaFlushAllocation(GetVulkanContext()->GetAllocator(), this->allocation, 0, VK_WHOLE_SIZE));
+        vmaUnmapMemory(GetVulkanContext()->GetAllocator(), this->allocation);
+    }
+
     VulkanBuffer::~VulkanBuffer()
     {
         vmaDestroyBuffer(GetVulkanContext()->GetAllocator(), this->buffer, this->allocation);
         GetCurrentLogger()->LogInfo("VulkanBuffer", fmt::format("buffer `{}` destroyed", info.Name));
     }
 
+    void UploadBufferDataVulkan(const VulkanBuffer& buffer, const void* data, size_t size, size_t offset)
+    {
+        if (size == 0)
+            return;
+
+        BufferInfo stagingInfo;
+        stagingInfo.Name = buffer.GetInfo().Name + " staging";
+        stagingInfo.Flags = BufferFlags::COPY_SRC;
+        stagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+        stagingInfo.Size = static_cast<uint32_t>(size);
+        VulkanBuffer stagingBuffer(stagingInfo);
+
+        std::memcpy(stagingBuffer.MapMemory(), data, size);
+        stagingBuffer.UnmapMemory();
+
+        GetVulkanContext()->ImmediateSubmit([&stagingBuffer, &buffer, size, offset](VkCommandBuffer commandBuffer)
+        {
+            VkBufferCopy region = {};
+            region.srcOffset = 0;
+            region.dstOffset = offset;
+            region.size = size;
+            vkCmdCopyBuffer(commandBuffer, static_cast<VkBuffer>(stagingBuffer.GetHandle()), static_cast<VkBuffer>(buffer.GetHandle()), 1, &region);
+        });
+    }
+
     VkBufferUsageFlags ConvertBufferFlags(BufferFlags flags)
     {
         VkBufferUsageFlags result = {};
@@ -18,9 +18,14 @@ namespace VALX
 
         virtual const BufferInfo& GetInfo() const override;
         virtual Handle GetHandle() const override;
+        virtual uint8_t* MapMemory() override;
+        virtual void UnmapMemory() override;
         virtual ~VulkanBuffer() override;
     };
 
+    // copies data through a temporary staging buffer, blocks until the copy is finished
+    void UploadBufferDataVulkan(const VulkanBuffer& buffer, const void* data, size_t size, size_t offset = 0);
+
     VkBufferUsageFlags ConvertBufferFlags(BufferFlags flags);
     VmaMemoryUsage ConvertBufferMemory(BufferMemory memory);
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "VulkanClusterCuller.h"
+#include "VulkanContext.h"
+#include "Utilities.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+
+namespace VALX
+{
+    static const char* ClusterCullingShaderSource = R"(
+#version 460
+layout(local_size_x = 64) in;
+
+struct Meshlet
+{
+    vec4 Sphere;
+    vec4 ConeApex;
+    vec4 ConeAxisCutoff;
+    uvec4 Data; // vertex offset, triangle offset, triangle count, draw index
+};
+
+struct DrawCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+layout(set = 0, binding = 0) uniform uCullingParameters
+{
+    mat4 uModel;
+    vec4 uFrustumPlanes[6];
+    vec4 uCameraPosition;
+    uint uMeshletCount;
+    uint uFlags;
+};
+
+layout(set = 0, binding = 1, std430) readonly buffer bMeshlets { Meshlet meshlets[]; };
+layout(set = 0, binding = 2, std430) readonly buffer bMeshletVertices { uint meshletVertices[]; };
+layout(set = 0, binding = 3, std430) readonly buffer bMeshletTriangles { uint meshletTriangles[]; };
+layout(set = 0, binding = 4, std430) writeonly buffer bIndices { uint indices[]; };
+layout(set = 0, binding = 5, std430) buffer bDrawCommands { DrawCommand drawCommands[]; };
+
+const uint FRUSTUM_CULLING = 1;
+const uint BACKFACE_CONE_CULLING = 2;
+
+shared bool sIsVisible;
+shared uint sFirstIndex;
+
+void main()
+{
+    uint meshletIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    if (meshletIndex >= uMeshletCount)
+        return;
+
+    Meshlet meshlet = meshlets[meshletIndex];
+    uint triangleCount = meshlet.Data.z;
+    uint drawIndex = meshlet.Data.w;
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        float scale = max(length(uModel[0].xyz), max(length(uModel[1].xyz), length(uModel[2].xyz)));
+        vec3 center = (uModel * vec4(meshlet.Sphere.xyz, 1.0)).xyz;
+        float radius = meshlet.Sphere.w * scale;
+
+        bool isVisible = true;
+        if ((uFlags & FRUSTUM_CULLING) != 0)
+        {
+            for (int i = 0; i < 6; i++)
+                isVisible = isVisible && dot(uFrustumPlanes[i].xyz, center) + uFrustumPlanes[i].w > -radius;
+        }
+        if ((uFlags & BACKFACE_CONE_CULLING) != 0)
+        {
+            vec3 apex = (uModel * vec4(meshlet.ConeApex.xyz, 1.0)).xyz;
+            vec3 axis = normalize(mat3(uModel) * meshlet.ConeAxisCutoff.xyz);
+            isVisible = isVisible && dot(normalize(apex - uCameraPosition.xyz), axis) < meshlet.ConeAxisCutoff.w;
+        }
+
+        sIsVisible = isVisible;
+        if (isVisible)
+            sFirstIndex = drawCommands[drawIndex].FirstIndex + atomicAdd(drawCommands[drawIndex].IndexCount, 3 * triangleCount);
+    }
+    barrier();
+
+    if (!sIsVisible)
+        return;
+
+    for (uint triangle = gl_LocalInvocationIndex; triangle < triangleCount; triangle += gl_WorkGroupSize.x)
+    {
+        uint packed = meshletTriangles[meshlet.Data.y + triangle];
+        uint index = sFirstIndex + 3 * triangle;
+        indices[index + 0] = meshletVertices[meshlet.Data.x + (packed & 0xFF)];
+        indices[index + 1] = meshletVertices[meshlet.Data.x + ((packed >> 8) & 0xFF)];
+        indices[index + 2] = meshletVertices[meshlet.Data.x + ((packed >> 16) & 0xFF)];
+    }
+}
+)";
+
+    constexpr uint32_t MAX_DISPATCH_WIDTH = 65535;
+
+    // std140, matches uCullingParameters
+    struct ClusterCullingParameters
+    {
+        glm::mat4 Model;
+        glm::vec4 FrustumPlanes[6];
+        glm::vec4 CameraPosition;
+        uint32_t MeshletCount = 0;
+        uint32_t Flags = 0;
+        uint32_t Padding[2] = { };
+    };
+
+    // std430, matches Meshlet in the culling shader
+    struct GpuMeshlet
+    {
+        glm::vec4 Sphere;
+        glm::vec4 ConeApex;
+        glm::vec4 ConeAxisCutoff;
+        uint32_t VertexOffset = 0;
+        uint32_t TriangleOffset = 0;
+        uint32_t TriangleCount = 0;
+        uint32_t DrawIndex = 0;
+    };
+
+    static std::unique_ptr<VulkanBuffer> CreateStaticBuffer(const std::string& name, BufferFlags flags, const void* data, size_t size)
+    {
+        BufferInfo info;
+        info.Name = name;
+        info.Flags = flags | BufferFlags::COPY_DST;
+        info.MemoryType = BufferMemory::GPU_ONLY;
+        // zero sized buffers are not allowed, empty meshes still get a valid descriptor
+        info.Size = static_cast<uint32_t>(std::max(size, size_t(16)));
+        auto buffer = std::make_unique<VulkanBuffer>(info);
+        UploadBufferDataVulkan(*buffer, data, size);
+        return buffer;
+    }
+
+    // Gribb-Hartmann plane extraction, planes point inwards, clip space depth is [0, 1]
+    static void ExtractFrustumPlanes(const glm::mat4& viewProjection, glm::vec4 planes[6])
+    {
+        auto Row = [&viewProjection](int i)
+        {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+        planes[0] = Row(3) + Row(0);
+        planes[1] = Row(3) - Row(0);
+        planes[2] = Row(3) + Row(1);
+        planes[3] = Row(3) - Row(1);
+        planes[4] = Row(2);
+        planes[5] = Row(3) - Row(2);
+        for (int i = 0; i < 6; i++)
+        {
+            float length = glm::length(glm::vec3(planes[i].x, planes[i].y, planes[i].z));
+            planes[i] = planes[i] * (1.0f / length);
+        }
+    }
+
+    VulkanClusterCuller::VulkanClusterCuller(const MeshData& mesh, const MeshletData& meshlets)
+    {
+        this->meshletCount = static_cast<uint32_t>(meshlets.Meshlets.size());
+        this->drawCount = static_cast<uint32_t>(mesh.SubMeshes.size());
+
+        std::vector<GpuMeshlet> gpuMeshlets(meshlets.Meshlets.size());
+        for (size_t i = 0; i < meshlets.Meshlets.size(); i++)
+        {
+            const Meshlet& meshlet = meshlets.Meshlets[i];
+            GpuMeshlet& gpuMeshlet = gpuMeshlets[i];
+            gpuMeshlet.Sphere = glm::vec4(meshlet.Center, meshlet.Radius);
+            gpuMeshlet.ConeApex = glm::vec4(meshlet.ConeApex, 0.0f);
+            gpuMeshlet.ConeAxisCutoff = glm::vec4(meshlet.ConeAxis, meshlet.ConeCutoff);
+            gpuMeshlet.VertexOffset = meshlet.VertexOffset;
+            gpuMeshlet.TriangleOffset = meshlet.TriangleOffset;
+            gpuMeshlet.TriangleCount = meshlet.TriangleCount;
+            gpuMeshlet.DrawIndex = meshlet.SubMeshIndex;
+        }
+
+        // one byte per index is awkward to address in a shader, so triangles are packed into one uint each
+        std::vector<uint32_t> packedTriangles(meshlets.Triangles.size() / 3);
+        for (size_t i = 0; i < packedTriangles.size(); i++)
+        {
+            packedTriangles[i] = uint32_t(meshlets.Triangles[3 * i + 0]) |
+                (uint32_t(meshlets.Triangles[3 * i + 1]) << 8) |
+                (uint32_t(meshlets.Triangles[3 * i + 2]) << 16);
+        }
+
+        // every submesh owns a range of the compacted index buffer large enough for all its triangles
+        std::vector<DrawIndexedIndirectCommand> resetCommands(mesh.SubMeshes.size());
+        uint32_t indexCount = 0;
+        for (size_t i = 0; i < mesh.SubMeshes.size(); i++)
+        {
+            resetCommands[i].IndexCount = 0;
+            resetCommands[i].InstanceCount = 1;
+            resetCommands[i].FirstIndex = indexCount;
+            resetCommands[i].VertexOffset = static_cast<int32_t>(mesh.SubMeshes[i].VertexOffset);
+            resetCommands[i].FirstInstance = 0;
+            indexCount += mesh.SubMeshes[i].IndexCount;
+        }
+
+        const std::string& name = mesh.FilePath;
+        this->meshletBuffer = CreateStaticBuffer(name + " meshlets", BufferFlags::STORAGE_BUFFER, gpuMeshlets.data(), gpuMeshlets.size() * sizeof(GpuMeshlet));
+        this->meshletVertexBuffer = CreateStaticBuffer(name + " meshlet vertices", BufferFlags::STORAGE_BUFFER, meshlets.Vertices.data(), meshlets.Vertices.size() * sizeof(uint32_t));
+        this->meshletTriangleBuffer = CreateStaticBuffer(name + " meshlet triangles", BufferFlags::STORAGE_BUFFER, packedTriangles.data(), packedTriangles.size() * sizeof(uint32_t));
+        this->indirectResetBuffer = CreateStaticBuffer(name + " indirect reset", BufferFlags::COPY_SRC, resetCommands.data(), resetCommands.size() * sizeof(DrawIndexedIndirectCommand));
+
+        BufferInfo indexBufferInfo;
+        indexBufferInfo.Name = name + " culled indices";
+        indexBufferInfo.Flags = BufferFlags::STORAGE_BUFFER | BufferFlags::INDEX_BUFFER;
+        indexBufferInfo.MemoryType = BufferMemory::GPU_ONLY;
+        indexBufferInfo.Size = std::max(indexCount, 4u) * static_cast<uint32_t>(sizeof(uint32_t));
+        this->indexBuffer = std::make_unique<VulkanBuffer>(indexBufferInfo);
+
+        BufferInfo indirectBufferInfo;
+        indirectBufferInfo.Name = name + " culled draws";
+        indirectBufferInfo.Flags = BufferFlags::STORAGE_BUFFER | BufferFlags::INDIRECT_BUFFER | BufferFlags::COPY_DST;
+        indirectBufferInfo.MemoryType = BufferMemory::GPU_ONLY;
+        indirectBufferInfo.Size = this->indirectResetBuffer->GetInfo().Size;
+        this->indirectBuffer = std::make_unique<VulkanBuffer>(indirectBufferInfo);
+
+        BufferInfo parameterBufferInfo;
+        parameterBufferInfo.Name = name + " culling parameters";
+        parameterBufferInfo.Flags = BufferFlags::UNIFORM_BUFFER | BufferFlags::COPY_DST;
+        parameterBufferInfo.MemoryType = BufferMemory::GPU_ONLY;
+        parameterBufferInfo.Size = static_cast<uint32_t>(sizeof(ClusterCullingParameters));
+        this->parameterBuffer = std::make_unique<VulkanBuffer>(parameterBufferInfo);
+
+        this->pipeline = std::make_unique<VulkanComputePipeline>("Cluster Culling", ClusterCullingShaderSource, 1);
+        this->descriptorSet = this->pipeline->AllocateDescriptorSet();
+        WriteDescriptorBuffer(this->descriptorSet, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, static_cast<VkBuffer>(this->parameterBuffer->GetHandle()));
+        WriteDescriptorBuffer(this->descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(this->meshletBuffer->GetHandle()));
+        WriteDescriptorBuffer(this->descriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(this->meshletVertexBuffer->GetHandle()));
+        WriteDescriptorBuffer(this->descriptorSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(this->meshletTriangleBuffer->GetHandle()));
+        WriteDescriptorBuffer(this->descriptorSet, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(this->indexBuffer->GetHandle()));
+        WriteDescriptorBuffer(this->descriptorSet, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(this->indirectBuffer->GetHandle()));
+
+        GetCurrentLogger()->LogInfo("VulkanClusterCuller", fmt::format("cluster culler for `{}` created, {} meshlets, {} draws", name, this->meshletCount, this->drawCount));
+    }
+
+    void VulkanClusterCuller::Cull(CommandBuffer& commandBuffer, const ClusterCullingInfo& info)
+    {
+        VkCommandBuffer vkCommandBuffer = static_cast<VkCommandBuffer>(commandBuffer.GetHandle());
+
+        ClusterCullingParameters parameters;
+        parameters.Model = info.Model;
+        ExtractFrustumPlanes(info.ViewProjection, parameters.FrustumPlanes);
+        parameters.CameraPosition = glm::vec4(info.CameraPosition, 1.0f);
+        parameters.MeshletCount = this->meshletCount;
+        parameters.Flags = static_cast<uint32_t>(info.Flags);
+
+        // draws of the previous Cull call must be done reading the buffers before they are overwritten
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vkCmdUpdateBuffer(vkCommandBuffer, static_cast<VkBuffer>(this->parameterBuffer->GetHandle()), 0, sizeof(ClusterCullingParameters), &parameters);
+        VkBufferCopy resetRegion = {};
+        resetRegion.size = this->indirectResetBuffer->GetInfo().Size;
+        vkCmdCopyBuffer(vkCommandBuffer, static_cast<VkBuffer>(this->indirectResetBuffer->GetHandle()), static_cast<VkBuffer>(this->indirectBuffer->GetHandle()), 1, &resetRegion);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        if (this->meshletCount > 0)
+        {
+            this->pipeline->Bind(vkCommandBuffer, this->descriptorSet);
+            uint32_t groupCountX = std::min(this->meshletCount, MAX_DISPATCH_WIDTH);
+            vkCmdDispatch(vkCommandBuffer, groupCountX, GetDispatchSize(this->meshletCount, groupCountX), 1);
+        }
+
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    Buffer& VulkanClusterCuller::GetIndexBuffer()
+    {
+        return *this->indexBuffer;
+    }
+
+    Buffer& VulkanClusterCuller::GetIndirectBuffer()
+    {
+        return *this->indirectBuffer;
+    }
+
+    uint32_t VulkanClusterCuller::GetDrawCount() const
+    {
+        return this->drawCount;
+    }
+}
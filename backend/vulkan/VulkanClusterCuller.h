@@ -0,0 +1,34 @@
+#pragma once
+
+#include "api/ClusterCuller.h"
+#include "VulkanBuffer.h"
+#include "VulkanComputePipeline.h"
+
+#include <memory>
+
+namespace VALX
+{
+    class VulkanClusterCuller : public ClusterCuller
+    {
+        std::unique_ptr<VulkanComputePipeline> pipeline;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        std::unique_ptr<VulkanBuffer> parameterBuffer;
+        std::unique_ptr<VulkanBuffer> meshletBuffer;
+        std::unique_ptr<VulkanBuffer> meshletVertexBuffer;
+        std::unique_ptr<VulkanBuffer> meshletTriangleBuffer;
+        std::unique_ptr<VulkanBuffer> indexBuffer;
+        std::unique_ptr<VulkanBuffer> indirectBuffer;
+        // indirect commands with zero index count, copied over the indirect buffer before every dispatch
+        std::unique_ptr<VulkanBuffer> indirectResetBuffer;
+        uint32_t meshletCount = 0;
+        uint32_t drawCount = 0;
+
+    public:
+        VulkanClusterCuller(const MeshData& mesh, const MeshletData& meshlets);
+
+        virtual void Cull(CommandBuffer& commandBuffer, const ClusterCullingInfo& info) override;
+        virtual Buffer& GetIndexBuffer() override;
+        virtual Buffer& GetIndirectBuffer() override;
+        virtual uint32_t GetDrawCount() const override;
+    };
+}
@@ -22,6 +22,11 @@ namespace VALX
         VALX_VK_SUCCESS(vkEndCommandBuffer(this->commandBuffer));
     }
 
+    CommandBuffer::Handle VulkanCommandBuffer::GetHandle() const
+    {
+        return static_cast<CommandBuffer::Handle>(this->commandBuffer);
+    }
+
     VkCommandBufferUsageFlags ConvertCommandBufferFlagsVulkan(CommandBufferFlags flags)
     {
         VkCommandBufferUsageFlags result = {};
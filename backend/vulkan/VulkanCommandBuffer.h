@@ -14,6 +14,7 @@ namespace VALX
 
         virtual void Begin(CommandBufferFlags flags) override;
         virtual void End() override;
+        virtual Handle GetHandle() const override;
     };
 
     VkCommandBufferUsageFlags ConvertCommandBufferFlagsVulkan(CommandBufferFlags flags);
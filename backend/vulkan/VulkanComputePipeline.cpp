@@ -0,0 +1,139 @@
+#include "VulkanComputePipeline.h"
+#include "VulkanContext.h"
+#include "ExternalFunctions.h"
+#include "Utilities.h"
+#include "api/Logger.h"
+
+#include <array>
+
+namespace VALX
+{
+    VulkanComputePipeline::VulkanComputePipeline(const std::string& name, const std::string& source, uint32_t maxDescriptorSets,
+        const std::vector<ImmutableSamplerInfo>& immutableSamplers)
+    {
+        ShaderInfo shaderInfo;
+        shaderInfo.Name = name;
+        shaderInfo.ImmutableSamplers = immutableSamplers;
+        shaderInfo.Stages.push_back(GetVulkanContext()->GetShaderLoader()->LoadFromSourceString(source, ShaderStage::COMPUTE, ShaderLanguage::GLSL));
+        VALX_ASSERT(!shaderInfo.Stages.back().Bytecode.empty() && "compute shader compilation failed");
+        this->shader = std::make_unique<VulkanShader>(shaderInfo);
+
+        VkComputePipelineCreateInfo pipelineCreateInfo = {};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineCreateInfo.stage.module = this->shader->GetShaderModule(VK_SHADER_STAGE_COMPUTE_BIT);
+        pipelineCreateInfo.stage.pName = "main";
+        pipelineCreateInfo.layout = this->shader->GetPipelineLayout();
+        VALX_VK_SUCCESS(vkCreateComputePipelines(GetVulkanContext()->GetDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &this->pipeline));
+
+        // generous per-set budget, internal compute passes bind at most a few buffers and a single mip chain
+        std::array<VkDescriptorPoolSize, 5> poolSizes = {
+            VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 * maxDescriptorSets },
+            VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 8 * maxDescriptorSets },
+            VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16 * maxDescriptorSets },
+            VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4 * maxDescriptorSets },
+            VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * maxDescriptorSets },
+        };
+
+        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
+        descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolCreateInfo.maxSets = maxDescriptorSets;
+        descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        descriptorPoolCreateInfo.pPoolSizes = poolSizes.data();
+        VALX_VK_SUCCESS(vkCreateDescriptorPool(GetVulkanContext()->GetDevice(), &descriptorPoolCreateInfo, nullptr, &this->descriptorPool));
+
+        VkDebugUtilsObjectNameInfoEXT debugName = {};
+        debugName.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+        debugName.objectType = VK_OBJECT_TYPE_PIPELINE;
+        debugName.objectHandle = reinterpret_cast<uint64_t>(this->pipeline);
+        debugName.pObjectName = name.c_str();
+        funcs.vkSetDebugUtilsObjectNameEXT(GetVulkanContext()->GetDevice(), &debugName);
+
+        GetCurrentLogger()->LogInfo("VulkanComputePipeline", fmt::format("compute pipeline `{}` created", name));
+    }
+
+    VulkanComputePipeline::~VulkanComputePipeline()
+    {
+        vkDestroyDescriptorPool(GetVulkanContext()->GetDevice(), this->descriptorPool, nullptr);
+        vkDestroyPipeline(GetVulkanContext()->GetDevice(), this->pipeline, nullptr);
+        GetCurrentLogger()->LogInfo("VulkanComputePipeline", fmt::format("compute pipeline `{}` destroyed", this->shader->GetName()));
+    }
+
+    VkDescriptorSet VulkanComputePipeline::AllocateDescriptorSet(uint32_t setIndex)
+    {
+        const std::vector<VkDescriptorSetLayout>& layouts = this->shader->GetDescriptorSetLayouts();
+        VALX_ASSERT(setIndex < layouts.size());
+
+        VkDescriptorSetAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = this->descriptorPool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layouts[setIndex];
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VALX_VK_SUCCESS(vkAllocateDescriptorSets(GetVulkanContext()->GetDevice(), &allocateInfo, &descriptorSet));
+        return descriptorSet;
+    }
+
+    void VulkanComputePipeline::ResetDescriptorSets()
+    {
+        VALX_VK_SUCCESS(vkResetDescriptorPool(GetVulkanContext()->GetDevice(), this->descriptorPool, 0));
+    }
+
+    void VulkanComputePipeline::Bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, this->pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, this->shader->GetPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+    }
+
+    void VulkanComputePipeline::PushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size) const
+    {
+        vkCmdPushConstants(commandBuffer, this->shader->GetPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+    }
+
+    VkPipeline VulkanComputePipeline::GetPipeline() const
+    {
+        return this->pipeline;
+    }
+
+    VkPipelineLayout VulkanComputePipeline::GetPipelineLayout() const
+    {
+        return this->shader->GetPipelineLayout();
+    }
+
+    void WriteDescriptorBuffer(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    {
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = buffer;
+        bufferInfo.offset = offset;
+        bufferInfo.range = range;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(GetVulkanContext()->GetDevice(), 1, &write, 0, nullptr);
+    }
+
+    void WriteDescriptorImage(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType type, VkImageView view, VkImageLayout layout, VkSampler sampler, uint32_t arrayElement)
+    {
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageView = view;
+        imageInfo.imageLayout = layout;
+        imageInfo.sampler = sampler;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding;
+        write.dstArrayElement = arrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(GetVulkanContext()->GetDevice(), 1, &write, 0, nullptr);
+    }
+}
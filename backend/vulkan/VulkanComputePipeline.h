@@ -0,0 +1,46 @@
+#pragma once
+
+#include "VulkanShader.h"
+#include "api/Utilities.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VALX
+{
+    // compute shader compiled from GLSL source together with its pipeline and a descriptor pool for its sets
+    class VulkanComputePipeline
+    {
+        std::unique_ptr<VulkanShader> shader;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+
+    public:
+        // combined image samplers with an immutable sampler are written without one, see ImmutableSamplerInfo
+        VulkanComputePipeline(const std::string& name, const std::string& source, uint32_t maxDescriptorSets,
+            const std::vector<ImmutableSamplerInfo>& immutableSamplers = {});
+        ~VulkanComputePipeline();
+
+        VALX_NO_COPY_NO_MOVE(VulkanComputePipeline);
+
+        VkDescriptorSet AllocateDescriptorSet(uint32_t setIndex = 0);
+        // invalidates all descriptor sets allocated from this pipeline
+        void ResetDescriptorSets();
+
+        void Bind(VkCommandBuffer commandBuffer, VkDescriptorSet descriptorSet) const;
+        void PushConstants(VkCommandBuffer commandBuffer, const void* data, uint32_t size) const;
+
+        VkPipeline GetPipeline() const;
+        VkPipelineLayout GetPipelineLayout() const;
+    };
+
+    void WriteDescriptorBuffer(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    void WriteDescriptorImage(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType type, VkImageView view, VkImageLayout layout, VkSampler sampler = VK_NULL_HANDLE, uint32_t arrayElement = 0);
+    // number of workgroups covering count invocations
+    inline uint32_t GetDispatchSize(uint32_t count, uint32_t groupSize)
+    {
+        return (count + groupSize - 1) / groupSize;
+    }
+}
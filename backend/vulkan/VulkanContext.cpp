@@ -2,6 +2,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cstring>
 
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
@@ -15,10 +16,17 @@
 #include "VulkanSwapChain.h"
 #include "VulkanCommandBuffer.h"
 #include "VulkanTexture.h"
+#include "VulkanFormat.h"
 #include "VulkanBuffer.h"
 #include "VulkanShader.h"
 #include "VulkanSampler.h"
 #include "VulkanShaderLoader.h"
+#include "VulkanClusterCuller.h"
+#include "VulkanMipGenerator.h"
+#include "VulkanCubeMapConverter.h"
+#include "VulkanEnvironmentBaker.h"
+#include "VulkanVirtualTexture.h"
+#include "VulkanTextureStreamer.h"
 #include "window/Window.h"
 #include "window/vulkan/VulkanSurface.h"
 #include "api/Logger.h"
@@ -120,6 +128,24 @@ namespace VALX
         return deviceQueues;
     }
 
+    // read once from the capability table, so loads never ask the device which block format to transcode to
+    static std::vector<Format> GetSampledTranscodeFormats(const std::array<FormatCapabilities, FORMAT_COUNT>& formatCapabilities)
+    {
+        std::vector<Format> result;
+        const Format candidates[] = {
+            Format::BC7_UNORM_BLOCK, Format::BC7_SRGB_BLOCK,
+            Format::BC5_UNORM_BLOCK,
+            Format::BC3_UNORM_BLOCK, Format::BC3_SRGB_BLOCK,
+            Format::BC1_RGB_UNORM_BLOCK, Format::BC1_RGB_SRGB_BLOCK,
+        };
+        for (Format candidate : candidates)
+        {
+            if (formatCapabilities[static_cast<size_t>(candidate)].Supports(FormatFeatures::SAMPLED))
+                result.push_back(candidate);
+        }
+        return result;
+    }
+
     VulkanContext::VulkanContext(const ContextCreateInfo& info)
     {
         // VkInstance creation
@@ -199,6 +225,18 @@ namespace VALX
         deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
         deviceExtensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
 
+        // lets the allocator report the heap budget of the driver instead of an estimate, which the texture streamer sizes itself by
+        uint32_t extensionCount = 0;
+        VALX_VK_SUCCESS(vkEnumerateDeviceExtensionProperties(this->physicalDevice, nullptr, &extensionCount, nullptr));
+        std::vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        VALX_VK_SUCCESS(vkEnumerateDeviceExtensionProperties(this->physicalDevice, nullptr, &extensionCount, supportedExtensions.data()));
+        bool isMemoryBudgetSupported = std::any_of(supportedExtensions.begin(), supportedExtensions.end(), [](const VkExtensionProperties& extension)
+        {
+            return std::strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0;
+        });
+        if (isMemoryBudgetSupported)
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
         VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures = {};
         descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
         descriptorIndexingFeatures.descriptorBindingPartiallyBound = true;
@@ -215,8 +253,31 @@ namespace VALX
         multiviewFeatures.multiview = true;
         multiviewFeatures.pNext = &descriptorIndexingFeatures;
 
+        VkPhysicalDeviceFeatures supportedDeviceFeatures = {};
+        vkGetPhysicalDeviceFeatures(this->physicalDevice, &supportedDeviceFeatures);
+
         VkPhysicalDeviceFeatures enabledDeviceFeatures = {};
         enabledDeviceFeatures.samplerAnisotropy = true;
+        enabledDeviceFeatures.textureCompressionBC = supportedDeviceFeatures.textureCompressionBC;
+        // used by the compute mip downsampler, which writes every color format through the same shader
+        enabledDeviceFeatures.shaderStorageImageWriteWithoutFormat = supportedDeviceFeatures.shaderStorageImageWriteWithoutFormat;
+        this->enabledDeviceFeatures = enabledDeviceFeatures;
+
+        // format support never changes for a device, texture creation and uploads read the cached table. Block formats the
+        // device reports count only with the feature enabled
+        uint32_t sampledFormatCount = 0;
+        for (size_t format = 1; format < FORMAT_COUNT; format++)
+        {
+            VkFormatProperties& properties = this->formatProperties[format];
+            vkGetPhysicalDeviceFormatProperties(this->physicalDevice, ConvertFormatVulkan(static_cast<Format>(format)), &properties);
+            if (IsBlockCompressedFormat(static_cast<Format>(format)) && !enabledDeviceFeatures.textureCompressionBC)
+                properties = VkFormatProperties{};
+
+            this->formatCapabilities[format].OptimalTiling = ConvertVulkanFormatFeatures(properties.optimalTilingFeatures);
+            this->formatCapabilities[format].LinearTiling = ConvertVulkanFormatFeatures(properties.linearTilingFeatures);
+            sampledFormatCount += this->formatCapabilities[format].Supports(FormatFeatures::SAMPLED) ? 1 : 0;
+        }
+        GetCurrentLogger()->LogInfo("VulkanContext", fmt::format("{} of {} formats can be sampled with optimal tiling", sampledFormatCount, FORMAT_COUNT - 1));
 
         VkDeviceCreateInfo deviceCreateInfo = {};
         deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -299,14 +360,25 @@ namespace VALX
         allocatorCreateInfo.physicalDevice = this->physicalDevice;
         allocatorCreateInfo.device = this->device;
         allocatorCreateInfo.instance = this->instance;
+        if (isMemoryBudgetSupported)
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
         VALX_VK_SUCCESS(vmaCreateAllocator(&allocatorCreateInfo, &this->allocator));
         GetCurrentLogger()->LogInfo("VulkanContext", "allocator created");
 
+        // immediate submission resources creation
+        VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+        commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        commandPoolCreateInfo.queueFamilyIndex = this->mainQueueFamilyIndex;
+        VALX_VK_SUCCESS(vkCreateCommandPool(this->device, &commandPoolCreateInfo, nullptr, &this->immediateCommandPool));
+
         // compiler creation
         glslang::InitializeProcess();
         GetCurrentLogger()->LogInfo("VulkanContext", "online compiler initialized");
 
         this->textureLoader = std::unique_ptr<TextureLoader>(new TextureLoader());
+        this->textureLoader->SetTranscodeFormats(GetSampledTranscodeFormats(this->formatCapabilities));
+        this->meshLoader = std::unique_ptr<MeshLoader>(new MeshLoader());
         this->shaderLoader = std::unique_ptr<ShaderLoader>(new VulkanShaderLoader());
     }
 
@@ -314,6 +386,13 @@ namespace VALX
     {
         glslang::FinalizeProcess();
 
+        this->cubeMapConverter.reset();
+        this->mipGenerator.reset();
+
+        for (VkFence fence : this->immediateFences)
+            vkDestroyFence(this->device, fence, nullptr);
+        vkDestroyCommandPool(this->device, this->immediateCommandPool, nullptr);
+
         vmaDestroyAllocator(this->allocator);
 
         if (this->debugUtilsMessenger != VK_NULL_HANDLE)
@@ -331,6 +410,11 @@ namespace VALX
         return this->textureLoader.get();
     }
 
+    MeshLoader* VulkanContext::GetMeshLoader()
+    {
+        return this->meshLoader.get();
+    }
+
     ShaderLoader* VulkanContext::GetShaderLoader()
     {
         return this->shaderLoader.get();
@@ -346,9 +430,35 @@ namespace VALX
         return std::unique_ptr<SwapChain>(new VulkanSwapChain(surface));
     }
 
+    const FormatCapabilities& VulkanContext::GetFormatCapabilities(Format format) const
+    {
+        return this->formatCapabilities[static_cast<size_t>(format)];
+    }
+
+    Format VulkanContext::GetSupportedTextureFormat(Format format, TextureFlags flags) const
+    {
+        FormatFeatures required = GetRequiredFormatFeatures(flags);
+        if (this->GetFormatCapabilities(format).Supports(required))
+            return format;
+
+        Format fallback = GetFallbackFormat(format);
+        if (fallback != Format::UNKNOWN && this->GetFormatCapabilities(fallback).Supports(required))
+            return fallback;
+        return Format::UNKNOWN;
+    }
+
     std::unique_ptr<Texture> VulkanContext::CreateTexture(const TextureInfo& info)
     {
-        return std::unique_ptr<Texture>(new VulkanTexture(info));
+        Format format = this->GetSupportedTextureFormat(info.TextureFormat, info.Flags);
+        VALX_ASSERT(format != Format::UNKNOWN && "texture format is not supported for its flags and has no supported fallback");
+        if (format == info.TextureFormat)
+            return std::unique_ptr<Texture>(new VulkanTexture(info));
+
+        GetCurrentLogger()->LogWarning("VulkanContext", fmt::format("texture `{}`: {} is not supported for its flags, using {}", info.Name,
+            string_VkFormat(ConvertFormatVulkan(info.TextureFormat)), string_VkFormat(ConvertFormatVulkan(format))));
+        TextureInfo fallbackInfo = info;
+        fallbackInfo.TextureFormat = format;
+        return std::unique_ptr<Texture>(new VulkanTexture(fallbackInfo));
     }
 
     std::unique_ptr<Buffer> VulkanContext::CreateBuffer(const BufferInfo& info)
@@ -366,6 +476,244 @@ namespace VALX
         return std::unique_ptr<Sampler>(new VulkanSampler(info));
     }
 
+    std::shared_ptr<Sampler> VulkanContext::GetSampler(const SamplerInfo& info)
+    {
+        std::lock_guard<std::mutex> lock(this->sharedSamplersMutex);
+        auto it = this->sharedSamplers.find(info);
+        if (it != this->sharedSamplers.end())
+        {
+            if (std::shared_ptr<Sampler> sampler = it->second.lock())
+                return sampler;
+        }
+
+        // expired entries are dropped here, so the registry never outgrows the samplers alive
+        for (auto entry = this->sharedSamplers.begin(); entry != this->sharedSamplers.end();)
+            entry = entry->second.expired() ? this->sharedSamplers.erase(entry) : std::next(entry);
+
+        std::shared_ptr<Sampler> sampler(new VulkanSampler(info));
+        this->sharedSamplers[info] = sampler;
+        uint32_t maxSamplerCount = this->physicalDeviceProperties.limits.maxSamplerAllocationCount;
+        if (this->sharedSamplers.size() * 4 > size_t(maxSamplerCount) * 3)
+        {
+            GetCurrentLogger()->LogWarning("VulkanContext", fmt::format("{} shared samplers alive, the device allows {} samplers at once",
+                this->sharedSamplers.size(), maxSamplerCount));
+        }
+        return sampler;
+    }
+
+    std::unique_ptr<ClusterCuller> VulkanContext::CreateClusterCuller(const MeshData& mesh, const MeshletData& meshlets)
+    {
+        return std::unique_ptr<ClusterCuller>(new VulkanClusterCuller(mesh, meshlets));
+    }
+
+    std::unique_ptr<EnvironmentBaker> VulkanContext::CreateEnvironmentBaker()
+    {
+        return std::unique_ptr<EnvironmentBaker>(new VulkanEnvironmentBaker());
+    }
+
+    std::unique_ptr<VirtualTexture> VulkanContext::CreateVirtualTexture(const VirtualTextureInfo& info)
+    {
+        return std::unique_ptr<VirtualTexture>(new VulkanVirtualTexture(info));
+    }
+
+    std::unique_ptr<TextureStreamer> VulkanContext::CreateTextureStreamer(const TextureStreamerInfo& info)
+    {
+        return std::unique_ptr<TextureStreamer>(new VulkanTextureStreamer(info));
+    }
+
+    std::unique_ptr<Texture> VulkanContext::CreateCubeMap(const TextureData& source, const CubeMapConversionInfo& info)
+    {
+        VALX_ASSERT(source.Type == TextureType::TEXTURE_2D && source.Layers == 1);
+        VALX_ASSERT(this->enabledDeviceFeatures.shaderStorageImageWriteWithoutFormat && !IsSRGBFormat(info.TextureFormat) &&
+            "cube maps are written through storage images");
+
+        TextureInfo sourceInfo;
+        sourceInfo.Name = info.Name + " source";
+        sourceInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST;
+        sourceInfo.TextureFormat = this->GetSupportedTextureFormat(source.TextureFormat, sourceInfo.Flags);
+        VALX_ASSERT(sourceInfo.TextureFormat != Format::UNKNOWN && "cube map source format can not be sampled");
+        sourceInfo.Width = source.Width;
+        sourceInfo.Height = source.Height;
+        sourceInfo.Mips = source.MipCount;
+        sourceInfo.TopDown = source.TopDown;
+        VulkanTexture sourceTexture(sourceInfo);
+        this->UploadTexture(sourceTexture, source, TextureUploadInfo{});
+
+        TextureInfo cubeInfo;
+        cubeInfo.Name = info.Name;
+        cubeInfo.Type = TextureType::TEXTURE_CUBE;
+        cubeInfo.TextureFormat = info.TextureFormat;
+        cubeInfo.Width = info.FaceSize != 0 ? info.FaceSize : source.Width / 4;
+        cubeInfo.Height = cubeInfo.Width;
+        cubeInfo.Layers = 6;
+        cubeInfo.Mips = info.Mips;
+        bool generateMips = GetTextureMipCount(cubeInfo) > 1;
+        cubeInfo.Flags = TextureFlags::SAMPLED | TextureFlags::STORAGE | TextureFlags::COPY_DST | (generateMips ? TextureFlags::GENERATE_MIPS : TextureFlags::NONE);
+        auto cube = std::make_unique<VulkanTexture>(cubeInfo);
+
+        std::scoped_lock lock(this->mipGeneratorMutex);
+        if (this->cubeMapConverter == nullptr)
+            this->cubeMapConverter = std::make_unique<VulkanCubeMapConverter>();
+        if (generateMips && this->mipGenerator == nullptr)
+            this->mipGenerator = std::make_unique<VulkanMipGenerator>();
+
+        this->ImmediateSubmit([&](VkCommandBuffer commandBuffer)
+        {
+            this->cubeMapConverter->RecordConvert(commandBuffer, sourceTexture, source.TopDown, info.Layout, *cube);
+            if (generateMips)
+            {
+                this->mipGenerator->RecordGenerateMips(commandBuffer, *cube, 0);
+                return;
+            }
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = static_cast<VkImage>(cube->GetHandle());
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = cubeInfo.Layers;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        });
+
+        this->cubeMapConverter->ReleaseTransientResources();
+        if (generateMips)
+            this->mipGenerator->ReleaseTransientResources();
+
+        GetCurrentLogger()->LogInfo("VulkanContext", fmt::format("cube map `{}` created from `{}`: {}x{} faces, {} mips",
+            cubeInfo.Name, source.FilePath, cubeInfo.Width, cubeInfo.Height, GetTextureMipCount(cubeInfo)));
+        return cube;
+    }
+
+    template<typename Data>
+    void VulkanContext::UploadConvertedTexture(Texture& texture, const Data& data, const uint8_t* sourceBytes, const TextureUploadInfo& info)
+    {
+        Format format = texture.GetInfo().TextureFormat;
+        VALX_ASSERT(GetFallbackFormat(data.TextureFormat) == format && "texture format differs from the data format and is not its fallback");
+
+        std::vector<TextureSubresource> stagingSubresources;
+        size_t stagingSize = ComputeTextureSubresources(format, data.Width, data.Height, std::max(data.Depth, 1u), data.MipCount, data.Layers, stagingSubresources);
+        this->UploadTextureSubresources(texture, format, data.MipCount, stagingSubresources, stagingSize, [&](uint8_t* stagingMemory)
+        {
+            ConvertTextureSubresources(data.TextureFormat, sourceBytes, data.Subresources, format, stagingMemory, stagingSubresources);
+        }, info);
+    }
+
+    void VulkanContext::UploadTexture(Texture& texture, const TextureData& data, const TextureUploadInfo& info)
+    {
+        if (texture.GetInfo().TextureFormat != data.TextureFormat)
+            return this->UploadConvertedTexture(texture, data, data.Bytes.data(), info);
+
+        // the blob is already laid out for staging, so it goes over with a single copy
+        this->UploadTextureSubresources(texture, data.TextureFormat, data.MipCount, data.Subresources, data.Bytes.size(), [&data](uint8_t* stagingMemory)
+        {
+            std::memcpy(stagingMemory, data.Bytes.data(), data.Bytes.size());
+        }, info);
+    }
+
+    void VulkanContext::UploadTexture(Texture& texture, const MappedTextureData& data, const TextureUploadInfo& info)
+    {
+        if (texture.GetInfo().TextureFormat != data.TextureFormat)
+            return this->UploadConvertedTexture(texture, data, data.File->GetData(), info);
+
+        // file offsets are not aligned for copies, every subresource moves from the mapping to an aligned staging offset
+        std::vector<TextureSubresource> stagingSubresources;
+        size_t stagingSize = ComputeTextureSubresources(data.TextureFormat, data.Width, data.Height, data.Depth, data.MipCount, data.Layers, stagingSubresources);
+        this->UploadTextureSubresources(texture, data.TextureFormat, data.MipCount, stagingSubresources, stagingSize, [&](uint8_t* stagingMemory)
+        {
+            for (size_t i = 0; i < stagingSubresources.size(); i++)
+                std::memcpy(stagingMemory + stagingSubresources[i].Offset, data.File->GetData() + data.Subresources[i].Offset, data.Subresources[i].Size);
+        }, info);
+    }
+
+    void VulkanContext::UploadTextureSubresources(Texture& texture, Format format, uint32_t dataMipCount, const std::vector<TextureSubresource>& subresources,
+        size_t stagingSize, const std::function<void(uint8_t*)>& writeStaging, const TextureUploadInfo& info)
+    {
+        VulkanTexture& vulkanTexture = static_cast<VulkanTexture&>(texture);
+        const TextureInfo& textureInfo = texture.GetInfo();
+        uint32_t textureMipCount = GetTextureMipCount(textureInfo);
+        dataMipCount = std::min(textureMipCount, dataMipCount);
+        VALX_ASSERT(textureInfo.TextureFormat == format);
+
+        bool generateMips = info.GenerateMips && dataMipCount < textureMipCount;
+        VALX_ASSERT((!generateMips || static_cast<bool>(textureInfo.Flags & TextureFlags::GENERATE_MIPS)) && "texture was not created with TextureFlags::GENERATE_MIPS");
+
+        // subresources the texture has no room for stay in the staging buffer but are not copied
+        std::vector<VkBufferImageCopy> regions;
+        for (const TextureSubresource& subresource : subresources)
+        {
+            if (subresource.Layer < textureInfo.Layers && subresource.Mip < dataMipCount)
+                regions.push_back(ConvertTextureSubresourceVulkan(subresource, format));
+        }
+        VALX_ASSERT(!regions.empty());
+
+        BufferInfo stagingInfo;
+        stagingInfo.Name = textureInfo.Name + " staging";
+        stagingInfo.Flags = BufferFlags::COPY_SRC;
+        stagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+        stagingInfo.Size = static_cast<uint32_t>(stagingSize);
+        VulkanBuffer stagingBuffer(stagingInfo);
+
+        writeStaging(stagingBuffer.MapMemory());
+        stagingBuffer.UnmapMemory();
+
+        // only the mip generator is shared, plain copies of several threads go through ImmediateSubmit side by side
+        std::unique_lock<std::mutex> mipGeneratorLock(this->mipGeneratorMutex, std::defer_lock);
+        if (generateMips)
+        {
+            mipGeneratorLock.lock();
+            if (this->mipGenerator == nullptr)
+                this->mipGenerator = std::make_unique<VulkanMipGenerator>();
+        }
+
+        this->ImmediateSubmit([&](VkCommandBuffer commandBuffer)
+        {
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = static_cast<VkImage>(texture.GetHandle());
+            barrier.subresourceRange.aspectMask = GetImageAspectFlagsVulkan(format);
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = textureMipCount;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = textureInfo.Layers;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            vkCmdCopyBufferToImage(commandBuffer, static_cast<VkBuffer>(stagingBuffer.GetHandle()), barrier.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(regions.size()), regions.data());
+
+            if (generateMips)
+            {
+                this->mipGenerator->RecordGenerateMips(commandBuffer, vulkanTexture, dataMipCount - 1);
+                return;
+            }
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        });
+
+        if (generateMips)
+            this->mipGenerator->ReleaseTransientResources();
+
+        GetCurrentLogger()->LogInfo("VulkanContext", fmt::format("texture `{}` uploaded: {} of {} mips from data{}",
+            textureInfo.Name, dataMipCount, textureMipCount, generateMips ? ", the rest generated" : ""));
+    }
+
     VkInstance VulkanContext::GetInstance() const
     {
         return this->instance;
@@ -391,6 +739,16 @@ namespace VALX
         return this->allocator;
     }
 
+    const VkPhysicalDeviceFeatures& VulkanContext::GetEnabledDeviceFeatures() const
+    {
+        return this->enabledDeviceFeatures;
+    }
+
+    const VkFormatProperties& VulkanContext::GetFormatProperties(Format format) const
+    {
+        return this->formatProperties[static_cast<size_t>(format)];
+    }
+
     VkQueue VulkanContext::GetMainQueue() const
     {
         return this->mainQueue;
@@ -426,6 +784,53 @@ namespace VALX
         return this->transferQueueFamilyIndex;
     }
 
+    void VulkanContext::ImmediateSubmit(const std::function<void(VkCommandBuffer)>& recordCommands)
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        {
+            // the command pool and the queue need the lock, waiting for the GPU does not, so submissions of several threads overlap
+            std::scoped_lock lock(this->immediateSubmitMutex);
+
+            VkCommandBufferAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.commandPool = this->immediateCommandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            VALX_VK_SUCCESS(vkAllocateCommandBuffers(this->device, &allocateInfo, &commandBuffer));
+
+            VulkanCommandBuffer wrapper(commandBuffer);
+            wrapper.Begin(CommandBufferFlags::SUBMIT_ONCE);
+            recordCommands(commandBuffer);
+            wrapper.End();
+
+            if (this->immediateFences.empty())
+            {
+                VkFenceCreateInfo fenceCreateInfo = {};
+                fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                VALX_VK_SUCCESS(vkCreateFence(this->device, &fenceCreateInfo, nullptr, &fence));
+            }
+            else
+            {
+                fence = this->immediateFences.back();
+                this->immediateFences.pop_back();
+            }
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            VALX_VK_SUCCESS(vkQueueSubmit(this->mainQueue, 1, &submitInfo, fence));
+        }
+
+        VALX_VK_SUCCESS(vkWaitForFences(this->device, 1, &fence, VK_TRUE, UINT64_MAX));
+        VALX_VK_SUCCESS(vkResetFences(this->device, 1, &fence));
+
+        std::scoped_lock lock(this->immediateSubmitMutex);
+        this->immediateFences.push_back(fence);
+        vkFreeCommandBuffers(this->device, this->immediateCommandPool, 1, &commandBuffer);
+    }
+
     VulkanContext* GetVulkanContext()
     {
         return static_cast<VulkanContext*>(GetCurrentContext());
@@ -2,10 +2,17 @@
 
 #include "api/Context.h"
 #include "api/Utilities.h"
+#include "VulkanSampler.h"
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace VALX
 {
     class VulkanContext : public Context
@@ -15,6 +22,10 @@ namespace VALX
 
         VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
         VkPhysicalDeviceProperties physicalDeviceProperties = {};
+        VkPhysicalDeviceFeatures enabledDeviceFeatures = {};
+        // indexed by Format
+        std::array<VkFormatProperties, FORMAT_COUNT> formatProperties = {};
+        std::array<FormatCapabilities, FORMAT_COUNT> formatCapabilities = {};
 
         VkDevice device = VK_NULL_HANDLE;
 
@@ -29,21 +40,57 @@ namespace VALX
 
         VmaAllocator allocator = nullptr;
 
+        VkCommandPool immediateCommandPool = VK_NULL_HANDLE;
+        // fences of finished immediate submissions, each submission in flight takes one
+        std::vector<VkFence> immediateFences;
+        std::mutex immediateSubmitMutex;
+
+        // created on the first upload that generates mips
+        std::unique_ptr<class VulkanMipGenerator> mipGenerator;
+        // created on the first cube map conversion, guarded by the mip generator mutex as well
+        std::unique_ptr<class VulkanCubeMapConverter> cubeMapConverter;
+        std::mutex mipGeneratorMutex;
+
+        // samplers handed out by GetSampler, entries of released samplers expire and are replaced on the next request
+        std::unordered_map<SamplerInfo, std::weak_ptr<Sampler>, SamplerInfoHash, SamplerInfoEqual> sharedSamplers;
+        std::mutex sharedSamplersMutex;
+
         std::unique_ptr<ShaderLoader> shaderLoader = nullptr;
         std::unique_ptr<TextureLoader> textureLoader = nullptr;
+        std::unique_ptr<MeshLoader> meshLoader = nullptr;
+
+        // subresource offsets are into the staging buffer, which writeStaging fills
+        void UploadTextureSubresources(Texture& texture, Format format, uint32_t dataMipCount, const std::vector<TextureSubresource>& subresources,
+            size_t stagingSize, const std::function<void(uint8_t*)>& writeStaging, const TextureUploadInfo& info);
+        // for textures created with the fallback of the data format, the data is converted while the staging memory is written
+        template<typename Data>
+        void UploadConvertedTexture(Texture& texture, const Data& data, const uint8_t* sourceBytes, const TextureUploadInfo& info);
     public:
         VulkanContext(const ContextCreateInfo& info);
         ~VulkanContext();
 
         virtual TextureLoader* GetTextureLoader() override;
+        virtual MeshLoader* GetMeshLoader() override;
         virtual ShaderLoader* GetShaderLoader() override;
 
+        virtual const FormatCapabilities& GetFormatCapabilities(Format format) const override;
+        virtual Format GetSupportedTextureFormat(Format format, TextureFlags flags) const override;
+
         virtual std::unique_ptr<Surface> CreateSurface(const class Window& window) override;
         virtual std::unique_ptr<SwapChain> CreateSwapChain(const Surface& surface) override;
         virtual std::unique_ptr<Texture> CreateTexture(const TextureInfo& info) override;
         virtual std::unique_ptr<Buffer> CreateBuffer(const BufferInfo& info) override;
         virtual std::unique_ptr<Shader> CreateShader(const ShaderInfo& info) override;
         virtual std::unique_ptr<Sampler> CreateSampler(const SamplerInfo& info) override;
+        virtual std::shared_ptr<Sampler> GetSampler(const SamplerInfo& info) override;
+        virtual std::unique_ptr<ClusterCuller> CreateClusterCuller(const MeshData& mesh, const MeshletData& meshlets) override;
+        virtual std::unique_ptr<EnvironmentBaker> CreateEnvironmentBaker() override;
+        virtual std::unique_ptr<VirtualTexture> CreateVirtualTexture(const VirtualTextureInfo& info) override;
+        virtual std::unique_ptr<TextureStreamer> CreateTextureStreamer(const TextureStreamerInfo& info) override;
+        virtual std::unique_ptr<Texture> CreateCubeMap(const TextureData& source, const CubeMapConversionInfo& info) override;
+
+        virtual void UploadTexture(Texture& texture, const TextureData& data, const TextureUploadInfo& info) override;
+        virtual void UploadTexture(Texture& texture, const MappedTextureData& data, const TextureUploadInfo& info) override;
         
         VALX_NO_COPY_NO_MOVE(VulkanContext);
 
@@ -52,6 +99,8 @@ namespace VALX
         VkPhysicalDevice GetPhysicalDevice() const;
         VkDevice GetDevice() const;
         VmaAllocator GetAllocator() const;
+        const VkPhysicalDeviceFeatures& GetEnabledDeviceFeatures() const;
+        const VkFormatProperties& GetFormatProperties(Format format) const;
         VkQueue GetMainQueue() const;
         VkQueue GetComputeQueue() const;
         size_t GetTransferQueueCount() const;
@@ -59,6 +108,10 @@ namespace VALX
         uint32_t GetMainQueueFamilyIndex() const;
         uint32_t GetComputeQueueFamilyIndex() const;
         uint32_t GetTransferQueueFamilyIndex() const;
+
+        // records commands into a one time command buffer, submits it to the main queue and waits for completion. Safe to call from
+        // several threads, only recording and submitting are serialized
+        void ImmediateSubmit(const std::function<void(VkCommandBuffer)>& recordCommands);
     };
 
     VulkanContext* GetVulkanContext();
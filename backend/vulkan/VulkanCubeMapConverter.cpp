@@ -0,0 +1,173 @@
+#include "VulkanCubeMapConverter.h"
+#include "VulkanContext.h"
+#include "VulkanFormat.h"
+#include "Utilities.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VALX
+{
+    // one invocation per face texel, the source is read from the mip closest to the face resolution.
+    // Face and cross conventions match TextureLoader::Convert2DTextureToCubeMap
+    static const char* CubeMapShaderSource = R"(
+#version 460
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(set = 0, binding = 0) uniform sampler2D uSource;
+layout(set = 0, binding = 1) uniform writeonly image2DArray uFaces;
+
+layout(push_constant) uniform uCubeMapParameters
+{
+    int uFaceSize;
+    int uIsEquirectangular;
+    int uSourceTopDown;
+    float uSourceLod;
+};
+
+const float PI = 3.14159265358979323846;
+const ivec2 CROSS_CELLS[6] = ivec2[](ivec2(2, 1), ivec2(0, 1), ivec2(1, 0), ivec2(1, 2), ivec2(1, 1), ivec2(3, 1));
+
+vec3 GetDirection(int face, vec2 uv)
+{
+    switch (face)
+    {
+    case 0: return vec3(1.0, -uv.y, -uv.x);
+    case 1: return vec3(-1.0, -uv.y, uv.x);
+    case 2: return vec3(uv.x, 1.0, uv.y);
+    case 3: return vec3(uv.x, -1.0, -uv.y);
+    case 4: return vec3(uv.x, -uv.y, 1.0);
+    default: return vec3(-uv.x, -uv.y, -1.0);
+    }
+}
+
+void main()
+{
+    ivec3 texel = ivec3(gl_GlobalInvocationID);
+    if (any(greaterThanEqual(texel.xy, ivec2(uFaceSize))))
+        return;
+
+    vec2 uv = (vec2(texel.xy) + 0.5) / float(uFaceSize) * 2.0 - 1.0;
+    vec2 sourceUV;
+    if (uIsEquirectangular != 0)
+    {
+        vec3 direction = normalize(GetDirection(texel.z, uv));
+        sourceUV = vec2(atan(direction.z, direction.x) / (2.0 * PI) + 0.5, 0.5 - asin(clamp(direction.y, -1.0, 1.0)) / PI);
+    }
+    else
+    {
+        // kept half a texel of the sampled mip inside the cell, so filtering does not pick up the neighbouring faces
+        vec2 cellSize = vec2(textureSize(uSource, 0)) / vec2(4.0, 3.0);
+        vec2 margin = vec2(0.5 * exp2(uSourceLod));
+        vec2 position = clamp((uv * 0.5 + 0.5) * cellSize, margin, cellSize - margin);
+        sourceUV = (vec2(CROSS_CELLS[texel.z]) * cellSize + position) / (cellSize * vec2(4.0, 3.0));
+    }
+    if (uSourceTopDown == 0)
+        sourceUV.y = 1.0 - sourceUV.y;
+
+    imageStore(uFaces, texel, textureLod(uSource, sourceUV, uSourceLod));
+}
+)";
+
+    constexpr uint32_t CUBE_MAP_GROUP_SIZE = 8;
+
+    struct CubeMapParameters
+    {
+        int32_t FaceSize;
+        int32_t IsEquirectangular;
+        int32_t SourceTopDown;
+        float SourceLod;
+    };
+
+    VulkanCubeMapConverter::VulkanCubeMapConverter()
+    {
+        // panoramas wrap around horizontally, cross cells are clamped in the shader
+        ImmutableSamplerInfo sourceSampler;
+        sourceSampler.Binding = 0;
+        sourceSampler.Sampler.Name = "Cube Map Conversion Source";
+        sourceSampler.Sampler.MagFilter = Filter::LINEAR;
+        sourceSampler.Sampler.MinFilter = Filter::LINEAR;
+        sourceSampler.Sampler.MipMapFilter = Filter::LINEAR;
+        sourceSampler.Sampler.AddressModeU = AddressMode::REPEAT;
+        sourceSampler.Sampler.AddressModeV = AddressMode::CLAMP_TO_EDGE;
+        sourceSampler.Sampler.AddressModeW = AddressMode::CLAMP_TO_EDGE;
+        sourceSampler.Sampler.EnableAnisotropy = false;
+        this->pipeline = std::make_unique<VulkanComputePipeline>("Cube Map Conversion", CubeMapShaderSource, 1, std::vector<ImmutableSamplerInfo>{ sourceSampler });
+    }
+
+    VulkanCubeMapConverter::~VulkanCubeMapConverter()
+    {
+        this->ReleaseTransientResources();
+    }
+
+    void VulkanCubeMapConverter::RecordConvert(VkCommandBuffer commandBuffer, const VulkanTexture& source, bool sourceTopDown, CubeMapLayout layout, const VulkanTexture& cube)
+    {
+        const TextureInfo& sourceInfo = source.GetInfo();
+        const TextureInfo& cubeInfo = cube.GetInfo();
+        VALX_ASSERT(sourceInfo.Layers == 1 && cubeInfo.Layers == 6);
+        VALX_ASSERT(static_cast<bool>(cubeInfo.Flags & TextureFlags::STORAGE));
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = static_cast<VkImage>(cube.GetHandle());
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = cubeInfo.Layers;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        uint32_t sourceMipCount = GetTextureMipCount(sourceInfo);
+        TextureViewInfo faceView;
+        faceView.Type = TextureViewType::TEXTURE_2D_ARRAY;
+        faceView.MipCount = 1;
+
+        VkDescriptorSet descriptorSet = this->pipeline->AllocateDescriptorSet();
+        WriteDescriptorImage(descriptorSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, static_cast<VkImageView>(source.GetView()),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        WriteDescriptorImage(descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, static_cast<VkImageView>(cube.GetView(faceView)), VK_IMAGE_LAYOUT_GENERAL);
+
+        // a cross has four faces across, a panorama covers four faces around the equator
+        CubeMapParameters parameters = {};
+        parameters.FaceSize = (int32_t)cubeInfo.Width;
+        parameters.IsEquirectangular = layout == CubeMapLayout::EQUIRECTANGULAR ? 1 : 0;
+        parameters.SourceTopDown = sourceTopDown ? 1 : 0;
+        parameters.SourceLod = std::clamp(std::log2(float(sourceInfo.Width) / float(4 * cubeInfo.Width)), 0.0f, float(sourceMipCount - 1));
+
+        this->pipeline->Bind(commandBuffer, descriptorSet);
+        this->pipeline->PushConstants(commandBuffer, &parameters, sizeof(parameters));
+        vkCmdDispatch(commandBuffer, GetDispatchSize(cubeInfo.Width, CUBE_MAP_GROUP_SIZE), GetDispatchSize(cubeInfo.Height, CUBE_MAP_GROUP_SIZE), cubeInfo.Layers);
+
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // the remaining mips hold nothing yet
+        uint32_t cubeMipCount = GetTextureMipCount(cubeInfo);
+        if (cubeMipCount > 1)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.subresourceRange.baseMipLevel = 1;
+            barrier.subresourceRange.levelCount = cubeMipCount - 1;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+    }
+
+    void VulkanCubeMapConverter::ReleaseTransientResources()
+    {
+        this->pipeline->ResetDescriptorSets();
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "api/TextureLoader.h"
+#include "VulkanTexture.h"
+#include "VulkanComputePipeline.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+
+namespace VALX
+{
+    // resamples a 4x3 cross or an equirectangular panorama into the top mip of every face of a cube map with one dispatch
+    class VulkanCubeMapConverter
+    {
+        std::unique_ptr<VulkanComputePipeline> pipeline;
+
+    public:
+        VulkanCubeMapConverter();
+        ~VulkanCubeMapConverter();
+
+        VALX_NO_COPY_NO_MOVE(VulkanCubeMapConverter);
+
+        // expects every mip of the source in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, leaves every mip of the cube
+        // in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL with the top one filled, as VulkanMipGenerator expects
+        void RecordConvert(VkCommandBuffer commandBuffer, const VulkanTexture& source, bool sourceTopDown, CubeMapLayout layout, const VulkanTexture& cube);
+        // descriptor sets referenced by the recorded commands, call once they have finished executing
+        void ReleaseTransientResources();
+    };
+}
@@ -0,0 +1,497 @@
+#include "VulkanEnvironmentBaker.h"
+#include "VulkanContext.h"
+#include "VulkanFormat.h"
+#include "Utilities.h"
+#include "api/Hash.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace VALX
+{
+    // face directions match the cube map conversion, samples of the environment are taken from the mip whose texels
+    // cover the solid angle of one sample (filtered importance sampling), which keeps the sample counts low
+    static const char* EnvironmentCommonSource = R"(
+#version 460
+layout(local_size_x = 8, local_size_y = 8) in;
+
+const float PI = 3.14159265358979323846;
+
+vec3 GetDirection(int face, vec2 uv)
+{
+    switch (face)
+    {
+    case 0: return vec3(1.0, -uv.y, -uv.x);
+    case 1: return vec3(-1.0, -uv.y, uv.x);
+    case 2: return vec3(uv.x, 1.0, uv.y);
+    case 3: return vec3(uv.x, -1.0, -uv.y);
+    case 4: return vec3(uv.x, -uv.y, 1.0);
+    default: return vec3(-uv.x, -uv.y, -1.0);
+    }
+}
+
+vec2 Hammersley(uint index, uint count)
+{
+    return vec2(float(index) / float(count), float(bitfieldReverse(index)) * 2.3283064365386963e-10);
+}
+
+mat3 GetTangentFrame(vec3 normal)
+{
+    vec3 up = abs(normal.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent = normalize(cross(up, normal));
+    return mat3(tangent, cross(normal, tangent), normal);
+}
+
+// half vector around +Z distributed proportionally to D(h) * NdotH
+vec3 ImportanceSampleGGX(vec2 xi, float alpha)
+{
+    float phi = 2.0 * PI * xi.x;
+    float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (alpha * alpha - 1.0) * xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    return vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+}
+
+float DistributionGGX(float NH, float alpha)
+{
+    float alpha2 = alpha * alpha;
+    float denominator = NH * NH * (alpha2 - 1.0) + 1.0;
+    return alpha2 / (PI * denominator * denominator);
+}
+)";
+
+    static const char* EnvironmentFilterSource = R"(
+layout(set = 0, binding = 0) uniform samplerCube uEnvironment;
+layout(set = 0, binding = 1, rgba16f) uniform writeonly image2DArray uOutput;
+
+layout(push_constant) uniform uFilterParameters
+{
+    int uFaceSize;
+    uint uSampleCount;
+    float uRoughness;
+    float uEnvironmentSize;
+    float uMaxLod;
+    float uOutputExponent;
+};
+
+float GetSampleLod(float pdf)
+{
+    float sampleSolidAngle = 1.0 / (float(uSampleCount) * max(pdf, 1e-6));
+    float texelSolidAngle = 4.0 * PI / (6.0 * uEnvironmentSize * uEnvironmentSize);
+    return clamp(0.5 * log2(sampleSolidAngle / texelSolidAngle) + 1.0, 0.0, uMaxLod);
+}
+
+vec3 Filter(vec3 normal);
+
+void main()
+{
+    ivec3 texel = ivec3(gl_GlobalInvocationID);
+    if (any(greaterThanEqual(texel.xy, ivec2(uFaceSize))))
+        return;
+
+    vec2 uv = (vec2(texel.xy) + 0.5) / float(uFaceSize) * 2.0 - 1.0;
+    vec3 color = Filter(normalize(GetDirection(texel.z, uv)));
+    imageStore(uOutput, texel, vec4(pow(max(color, vec3(0.0)), vec3(uOutputExponent)), 1.0));
+}
+)";
+
+    // cosine weighted samples, the pdf cancels the cosine and the 1 / PI of a lambertian surface
+    static const char* IrradianceShaderSource = R"(
+vec3 Filter(vec3 normal)
+{
+    mat3 frame = GetTangentFrame(normal);
+    vec3 irradiance = vec3(0.0);
+    for (uint i = 0; i < uSampleCount; i++)
+    {
+        vec2 xi = Hammersley(i, uSampleCount);
+        float cosTheta = sqrt(1.0 - xi.y);
+        float sinTheta = sqrt(xi.y);
+        float phi = 2.0 * PI * xi.x;
+        vec3 direction = frame * vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+        irradiance += textureLod(uEnvironment, direction, GetSampleLod(cosTheta / PI)).rgb;
+    }
+    return irradiance / float(uSampleCount);
+}
+)";
+
+    // split sum prefilter with the normal, view and reflection directions assumed equal, weighted by NdotL
+    static const char* PrefilterShaderSource = R"(
+vec3 Filter(vec3 normal)
+{
+    if (uRoughness == 0.0)
+        return textureLod(uEnvironment, normal, 0.0).rgb;
+
+    mat3 frame = GetTangentFrame(normal);
+    float alpha = uRoughness * uRoughness;
+    vec3 color = vec3(0.0);
+    float weight = 0.0;
+    for (uint i = 0; i < uSampleCount; i++)
+    {
+        vec3 halfVector = frame * ImportanceSampleGGX(Hammersley(i, uSampleCount), alpha);
+        float NH = max(dot(normal, halfVector), 0.0);
+        vec3 direction = 2.0 * NH * halfVector - normal;
+        float NL = dot(normal, direction);
+        if (NL <= 0.0)
+            continue;
+
+        // D * NdotH / (4 * VdotH) with V = N
+        float pdf = DistributionGGX(NH, alpha) * 0.25;
+        color += textureLod(uEnvironment, direction, GetSampleLod(pdf)).rgb * NL;
+        weight += NL;
+    }
+    return color / max(weight, 1e-4);
+}
+)";
+
+    // x is NdotV and y is 1 - roughness, as main_fragment.glsl addresses it
+    static const char* BRDFLUTShaderSource = R"(
+layout(set = 0, binding = 0, rg16f) uniform writeonly image2D uOutput;
+
+layout(push_constant) uniform uBRDFLUTParameters
+{
+    int uSize;
+    uint uSampleCount;
+};
+
+float GeometrySchlickGGX(float NdotX, float k)
+{
+    return NdotX / (NdotX * (1.0 - k) + k);
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(texel, ivec2(uSize))))
+        return;
+
+    float NV = (float(texel.x) + 0.5) / float(uSize);
+    float roughness = 1.0 - (float(texel.y) + 0.5) / float(uSize);
+    float alpha = roughness * roughness;
+    float k = alpha * 0.5;
+    vec3 view = vec3(sqrt(1.0 - NV * NV), 0.0, NV);
+
+    vec2 result = vec2(0.0);
+    for (uint i = 0; i < uSampleCount; i++)
+    {
+        vec3 halfVector = ImportanceSampleGGX(Hammersley(i, uSampleCount), alpha);
+        float VH = max(dot(view, halfVector), 0.0);
+        vec3 light = 2.0 * VH * halfVector - view;
+        float NL = light.z;
+        float NH = max(halfVector.z, 0.0);
+        if (NL <= 0.0)
+            continue;
+
+        float visibility = GeometrySchlickGGX(NV, k) * GeometrySchlickGGX(NL, k) * VH / max(NH * NV, 1e-6);
+        float fresnel = pow(1.0 - VH, 5.0);
+        result += vec2(1.0 - fresnel, fresnel) * visibility;
+    }
+    imageStore(uOutput, texel, vec4(result / float(uSampleCount), 0.0, 0.0));
+}
+)";
+
+    constexpr uint32_t ENVIRONMENT_GROUP_SIZE = 8;
+    constexpr uint32_t BRDF_LUT_SIZE = 256;
+    constexpr uint32_t BRDF_LUT_SAMPLE_COUNT = 1024;
+    // one descriptor set per mip of the prefiltered map
+    constexpr uint32_t MAX_PREFILTER_MIPS = 16;
+
+    struct EnvironmentFilterParameters
+    {
+        int32_t FaceSize;
+        uint32_t SampleCount;
+        float Roughness;
+        float EnvironmentSize;
+        float MaxLod;
+        float OutputExponent;
+    };
+
+    struct BRDFLUTParameters
+    {
+        int32_t Size;
+        uint32_t SampleCount;
+    };
+
+    static void TransitionTexture(VkCommandBuffer commandBuffer, const VulkanTexture& texture, VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = static_cast<VkImage>(texture.GetHandle());
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = GetTextureMipCount(texture.GetInfo());
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = texture.GetInfo().Layers;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    // the settings that change the baked maps, names and the environment face size for cube sources are left out
+    static uint64_t ComputeEnvironmentCacheKey(const TextureData& environment, const EnvironmentBakeInfo& info)
+    {
+        uint32_t outputGamma = 0;
+        std::memcpy(&outputGamma, &info.OutputGamma, sizeof(outputGamma));
+
+        bool isCube = environment.Type == TextureType::TEXTURE_CUBE;
+        uint32_t settings[] = {
+            environment.Width,
+            environment.Height,
+            environment.MipCount,
+            environment.Layers,
+            (uint32_t)environment.Type,
+            (uint32_t)environment.TextureFormat,
+            environment.TopDown,
+            isCube ? 0 : (uint32_t)info.SourceLayout,
+            isCube ? 0 : info.EnvironmentSize,
+            info.IrradianceSize,
+            info.IrradianceSampleCount,
+            info.PrefilteredSize,
+            info.PrefilteredSampleCount,
+            outputGamma,
+        };
+        uint64_t sourceHash = HashBytes(environment.Bytes.data(), environment.Bytes.size());
+        return HashBytes(settings, sizeof(settings), sourceHash);
+    }
+
+    VulkanEnvironmentBaker::VulkanEnvironmentBaker()
+    {
+        // both filters share one sampler through the registry
+        ImmutableSamplerInfo environmentSampler;
+        environmentSampler.Binding = 0;
+        environmentSampler.Sampler.Name = "Environment Source";
+        environmentSampler.Sampler.MagFilter = Filter::LINEAR;
+        environmentSampler.Sampler.MinFilter = Filter::LINEAR;
+        environmentSampler.Sampler.MipMapFilter = Filter::LINEAR;
+        environmentSampler.Sampler.AddressModeU = AddressMode::CLAMP_TO_EDGE;
+        environmentSampler.Sampler.AddressModeV = AddressMode::CLAMP_TO_EDGE;
+        environmentSampler.Sampler.AddressModeW = AddressMode::CLAMP_TO_EDGE;
+        environmentSampler.Sampler.EnableAnisotropy = false;
+
+        this->irradiancePipeline = std::make_unique<VulkanComputePipeline>("Environment Irradiance",
+            std::string(EnvironmentCommonSource) + EnvironmentFilterSource + IrradianceShaderSource, 1, std::vector<ImmutableSamplerInfo>{ environmentSampler });
+        this->prefilterPipeline = std::make_unique<VulkanComputePipeline>("Environment Prefilter",
+            std::string(EnvironmentCommonSource) + EnvironmentFilterSource + PrefilterShaderSource, MAX_PREFILTER_MIPS, std::vector<ImmutableSamplerInfo>{ environmentSampler });
+        this->brdfLUTPipeline = std::make_unique<VulkanComputePipeline>("Environment BRDF LUT",
+            std::string(EnvironmentCommonSource) + BRDFLUTShaderSource, 1);
+    }
+
+    VulkanEnvironmentBaker::~VulkanEnvironmentBaker()
+    {
+        this->ReleaseTransientResources();
+    }
+
+    std::unique_ptr<VulkanTexture> VulkanEnvironmentBaker::CreateEnvironmentCube(const TextureData& environment, const EnvironmentBakeInfo& info)
+    {
+        if (environment.Type != TextureType::TEXTURE_CUBE)
+        {
+            CubeMapConversionInfo conversionInfo;
+            conversionInfo.Name = info.Name + " environment";
+            conversionInfo.Layout = info.SourceLayout;
+            conversionInfo.FaceSize = info.EnvironmentSize;
+            conversionInfo.TextureFormat = Format::R16G16B16A16_SFLOAT;
+            conversionInfo.Mips = ALL_MIPS;
+            std::unique_ptr<Texture> cube = GetVulkanContext()->CreateCubeMap(environment, conversionInfo);
+            return std::unique_ptr<VulkanTexture>(static_cast<VulkanTexture*>(cube.release()));
+        }
+
+        VALX_ASSERT(environment.Layers == 6);
+        TextureInfo cubeInfo;
+        cubeInfo.Name = info.Name + " environment";
+        cubeInfo.Type = TextureType::TEXTURE_CUBE;
+        cubeInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST;
+        cubeInfo.TextureFormat = GetVulkanContext()->GetSupportedTextureFormat(environment.TextureFormat, cubeInfo.Flags);
+        VALX_ASSERT(cubeInfo.TextureFormat != Format::UNKNOWN && "environment cube format can not be sampled");
+        cubeInfo.Width = environment.Width;
+        cubeInfo.Height = environment.Height;
+        cubeInfo.Layers = 6;
+
+        // block-compressed sources such as BC6H are filtered from the mips stored with them, formats the device can not sample
+        // are decoded to their fallback on upload and get their chain generated like any other uncompressed source
+        bool generateMips = !IsBlockCompressedFormat(cubeInfo.TextureFormat) && environment.MipCount < GetMipLevelCount(std::max(environment.Width, environment.Height)) &&
+            GetVulkanContext()->GetFormatCapabilities(cubeInfo.TextureFormat).Supports(GetRequiredFormatFeatures(cubeInfo.Flags | TextureFlags::GENERATE_MIPS));
+        if (generateMips)
+            cubeInfo.Flags |= TextureFlags::GENERATE_MIPS;
+        cubeInfo.Mips = generateMips ? ALL_MIPS : environment.MipCount;
+        auto cube = std::make_unique<VulkanTexture>(cubeInfo);
+
+        TextureUploadInfo uploadInfo;
+        uploadInfo.GenerateMips = generateMips;
+        GetVulkanContext()->UploadTexture(*cube, environment, uploadInfo);
+        return cube;
+    }
+
+    void VulkanEnvironmentBaker::RecordFilter(VkCommandBuffer commandBuffer, VulkanComputePipeline& pipeline, const VulkanTexture& environment, const VulkanTexture& target,
+        uint32_t sampleCount, float outputGamma)
+    {
+        const TextureInfo& environmentInfo = environment.GetInfo();
+        const TextureInfo& targetInfo = target.GetInfo();
+        uint32_t environmentMipCount = GetTextureMipCount(environmentInfo);
+        uint32_t targetMipCount = GetTextureMipCount(targetInfo);
+        VALX_ASSERT(targetMipCount <= MAX_PREFILTER_MIPS);
+
+        VkImageView environmentView = static_cast<VkImageView>(environment.GetView());
+        TransitionTexture(commandBuffer, target, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+        for (uint32_t mip = 0; mip < targetMipCount; mip++)
+        {
+            uint32_t faceSize = std::max(targetInfo.Width >> mip, 1u);
+
+            VkDescriptorSet descriptorSet = pipeline.AllocateDescriptorSet();
+            WriteDescriptorImage(descriptorSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, environmentView,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            TextureViewInfo mipView;
+            mipView.Type = TextureViewType::TEXTURE_2D_ARRAY;
+            mipView.BaseMip = mip;
+            mipView.MipCount = 1;
+            WriteDescriptorImage(descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, static_cast<VkImageView>(target.GetView(mipView)), VK_IMAGE_LAYOUT_GENERAL);
+
+            EnvironmentFilterParameters parameters = {};
+            parameters.FaceSize = (int32_t)faceSize;
+            parameters.SampleCount = sampleCount;
+            parameters.Roughness = GetPrefilteredMipRoughness(mip, targetInfo.Width);
+            parameters.EnvironmentSize = float(environmentInfo.Width);
+            parameters.MaxLod = float(environmentMipCount - 1);
+            parameters.OutputExponent = 1.0f / outputGamma;
+
+            pipeline.Bind(commandBuffer, descriptorSet);
+            pipeline.PushConstants(commandBuffer, &parameters, sizeof(parameters));
+            vkCmdDispatch(commandBuffer, GetDispatchSize(faceSize, ENVIRONMENT_GROUP_SIZE), GetDispatchSize(faceSize, ENVIRONMENT_GROUP_SIZE), targetInfo.Layers);
+        }
+
+        TransitionTexture(commandBuffer, target, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    void VulkanEnvironmentBaker::RecordBRDFLUT(VkCommandBuffer commandBuffer)
+    {
+        TransitionTexture(commandBuffer, *this->brdfLUT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+        VkDescriptorSet descriptorSet = this->brdfLUTPipeline->AllocateDescriptorSet();
+        WriteDescriptorImage(descriptorSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, static_cast<VkImageView>(this->brdfLUT->GetView()), VK_IMAGE_LAYOUT_GENERAL);
+
+        BRDFLUTParameters parameters = {};
+        parameters.Size = (int32_t)BRDF_LUT_SIZE;
+        parameters.SampleCount = BRDF_LUT_SAMPLE_COUNT;
+
+        this->brdfLUTPipeline->Bind(commandBuffer, descriptorSet);
+        this->brdfLUTPipeline->PushConstants(commandBuffer, &parameters, sizeof(parameters));
+        vkCmdDispatch(commandBuffer, GetDispatchSize(BRDF_LUT_SIZE, ENVIRONMENT_GROUP_SIZE), GetDispatchSize(BRDF_LUT_SIZE, ENVIRONMENT_GROUP_SIZE), 1);
+
+        TransitionTexture(commandBuffer, *this->brdfLUT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    EnvironmentMaps VulkanEnvironmentBaker::Bake(const TextureData& environment, const EnvironmentBakeInfo& info)
+    {
+        VALX_ASSERT(info.OutputGamma > 0.0f);
+        std::scoped_lock lock(this->mutex);
+
+        uint64_t key = ComputeEnvironmentCacheKey(environment, info);
+        for (CacheEntry& entry : this->cache)
+        {
+            if (entry.Key == key)
+            {
+                entry.LastUse = ++this->useCounter;
+                GetCurrentLogger()->LogInfo("VulkanEnvironmentBaker", fmt::format("environment `{}` found in the cache", info.Name));
+                return entry.Maps;
+            }
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::unique_ptr<VulkanTexture> environmentCube = this->CreateEnvironmentCube(environment, info);
+
+        TextureInfo irradianceInfo;
+        irradianceInfo.Name = info.Name + " irradiance";
+        irradianceInfo.Type = TextureType::TEXTURE_CUBE;
+        irradianceInfo.TextureFormat = Format::R16G16B16A16_SFLOAT;
+        irradianceInfo.Flags = TextureFlags::SAMPLED | TextureFlags::STORAGE;
+        irradianceInfo.Width = info.IrradianceSize;
+        irradianceInfo.Height = info.IrradianceSize;
+        irradianceInfo.Layers = 6;
+        irradianceInfo.Mips = 1;
+        auto irradiance = std::make_shared<VulkanTexture>(irradianceInfo);
+
+        TextureInfo prefilteredInfo = irradianceInfo;
+        prefilteredInfo.Name = info.Name + " prefiltered";
+        prefilteredInfo.Width = info.PrefilteredSize != 0 ? info.PrefilteredSize : environmentCube->GetInfo().Width;
+        prefilteredInfo.Height = prefilteredInfo.Width;
+        prefilteredInfo.Mips = ALL_MIPS;
+        auto prefiltered = std::make_shared<VulkanTexture>(prefilteredInfo);
+
+        bool bakeBRDFLUT = this->brdfLUT == nullptr;
+        if (bakeBRDFLUT)
+        {
+            TextureInfo brdfLUTInfo;
+            brdfLUTInfo.Name = "Environment BRDF LUT";
+            brdfLUTInfo.TextureFormat = Format::R16G16_SFLOAT;
+            brdfLUTInfo.Flags = TextureFlags::SAMPLED | TextureFlags::STORAGE;
+            brdfLUTInfo.Width = BRDF_LUT_SIZE;
+            brdfLUTInfo.Height = BRDF_LUT_SIZE;
+            this->brdfLUT = std::make_shared<VulkanTexture>(brdfLUTInfo);
+        }
+
+        GetVulkanContext()->ImmediateSubmit([&](VkCommandBuffer commandBuffer)
+        {
+            this->RecordFilter(commandBuffer, *this->irradiancePipeline, *environmentCube, *irradiance, info.IrradianceSampleCount, info.OutputGamma);
+            this->RecordFilter(commandBuffer, *this->prefilterPipeline, *environmentCube, *prefiltered, info.PrefilteredSampleCount, info.OutputGamma);
+            if (bakeBRDFLUT)
+                this->RecordBRDFLUT(commandBuffer);
+        });
+        this->ReleaseTransientResources();
+
+        CacheEntry& entry = this->cache.emplace_back();
+        entry.Key = key;
+        entry.LastUse = ++this->useCounter;
+        entry.Maps.Irradiance = irradiance;
+        entry.Maps.Prefiltered = prefiltered;
+        entry.Maps.BRDFLUT = this->brdfLUT;
+        EnvironmentMaps result = entry.Maps;
+        this->TrimCache();
+
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        GetCurrentLogger()->LogInfo("VulkanEnvironmentBaker", fmt::format("environment `{}` baked in {:.1f} ms: {}x{} irradiance, {}x{} prefiltered with {} mips",
+            info.Name, milliseconds, irradianceInfo.Width, irradianceInfo.Height, prefilteredInfo.Width, prefilteredInfo.Height, GetTextureMipCount(prefilteredInfo)));
+        return result;
+    }
+
+    void VulkanEnvironmentBaker::SetCacheCapacity(size_t capacity)
+    {
+        std::scoped_lock lock(this->mutex);
+        this->cacheCapacity = capacity;
+        this->TrimCache();
+    }
+
+    void VulkanEnvironmentBaker::ClearCache()
+    {
+        std::scoped_lock lock(this->mutex);
+        this->cache.clear();
+    }
+
+    void VulkanEnvironmentBaker::TrimCache()
+    {
+        while (this->cache.size() > this->cacheCapacity)
+        {
+            auto leastRecentlyUsed = std::min_element(this->cache.begin(), this->cache.end(), [](const CacheEntry& left, const CacheEntry& right)
+            {
+                return left.LastUse < right.LastUse;
+            });
+            this->cache.erase(leastRecentlyUsed);
+        }
+    }
+
+    void VulkanEnvironmentBaker::ReleaseTransientResources()
+    {
+        this->irradiancePipeline->ResetDescriptorSets();
+        this->prefilterPipeline->ResetDescriptorSets();
+        this->brdfLUTPipeline->ResetDescriptorSets();
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "api/EnvironmentBaker.h"
+#include "VulkanTexture.h"
+#include "VulkanComputePipeline.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace VALX
+{
+    class VulkanEnvironmentBaker : public EnvironmentBaker
+    {
+        struct CacheEntry
+        {
+            uint64_t Key = 0;
+            uint64_t LastUse = 0;
+            EnvironmentMaps Maps;
+        };
+
+        std::unique_ptr<VulkanComputePipeline> irradiancePipeline;
+        std::unique_ptr<VulkanComputePipeline> prefilterPipeline;
+        std::unique_ptr<VulkanComputePipeline> brdfLUTPipeline;
+        // created on the first bake, it does not depend on the environment
+        std::shared_ptr<VulkanTexture> brdfLUT;
+        std::vector<CacheEntry> cache;
+        size_t cacheCapacity = 4;
+        uint64_t useCounter = 0;
+        std::mutex mutex;
+
+        std::unique_ptr<VulkanTexture> CreateEnvironmentCube(const TextureData& environment, const EnvironmentBakeInfo& info);
+        void RecordFilter(VkCommandBuffer commandBuffer, VulkanComputePipeline& pipeline, const VulkanTexture& environment, const VulkanTexture& target,
+            uint32_t sampleCount, float outputGamma);
+        void RecordBRDFLUT(VkCommandBuffer commandBuffer);
+        void ReleaseTransientResources();
+        void TrimCache();
+
+    public:
+        VulkanEnvironmentBaker();
+        virtual ~VulkanEnvironmentBaker() override;
+
+        VALX_NO_COPY_NO_MOVE(VulkanEnvironmentBaker);
+
+        virtual EnvironmentMaps Bake(const TextureData& environment, const EnvironmentBakeInfo& info) override;
+        virtual void SetCacheCapacity(size_t capacity) override;
+        virtual void ClearCache() override;
+    };
+}
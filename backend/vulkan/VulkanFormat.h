@@ -1,9 +1,13 @@
 #pragma once
 
 #include "api/Format.h"
+#include "api/FormatSupport.h"
 #include <vulkan/vulkan.h>
 
 namespace VALX
 {
     VkFormat ConvertFormatVulkan(Format format);
-}
\ No newline at end of file
+    // depth and / or stencil for depth stencil formats, color for every other one
+    VkImageAspectFlags GetImageAspectFlagsVulkan(Format format);
+    FormatFeatures ConvertVulkanFormatFeatures(VkFormatFeatureFlags flags);
+}
@@ -0,0 +1,357 @@
+#include "VulkanMipGenerator.h"
+#include "VulkanContext.h"
+#include "VulkanFormat.h"
+#include "Utilities.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+#include <array>
+
+namespace VALX
+{
+    // every workgroup reduces a 64x64 tile of the base mip to the next 6 mips, the last workgroup to finish a layer
+    // then reduces the 64x64 grid of tile results (mip 6) to mips 7-12 from the intermediate buffer
+    static const char* DownsampleShaderSource = R"(
+#version 460
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(set = 0, binding = 0) uniform sampler2DArray uSource;
+layout(set = 0, binding = 1) uniform writeonly image2DArray uMips[12];
+layout(set = 0, binding = 2, std430) coherent buffer bIntermediate { vec4 intermediate[]; };
+layout(set = 0, binding = 3, std430) coherent buffer bCounters { uint counters[]; };
+
+layout(push_constant) uniform uDownsampleParameters
+{
+    ivec2 uBaseSize;
+    ivec2 uTileCount;
+    int uMipCount;
+    int uIsSRGB;
+};
+
+shared vec4 sTexels[16][16];
+shared uint sIsLastGroup;
+
+vec3 LinearToSRGB(vec3 color)
+{
+    return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, greaterThan(color, vec3(0.0031308)));
+}
+
+ivec2 GetMipSize(int mip)
+{
+    return max(uBaseSize >> mip, ivec2(1));
+}
+
+void StoreMip(int mip, ivec2 coord, int layer, vec4 value)
+{
+    if (mip > uMipCount || any(greaterThanEqual(coord, GetMipSize(mip))))
+        return;
+    if (uIsSRGB != 0)
+        value.rgb = LinearToSRGB(value.rgb);
+    imageStore(uMips[mip - 1], ivec3(coord, layer), value);
+}
+
+vec4 LoadTexel(bool fromIntermediate, ivec2 coord, int layer)
+{
+    if (fromIntermediate)
+    {
+        coord = min(coord, GetMipSize(6) - 1);
+        return intermediate[layer * 4096 + coord.y * 64 + coord.x];
+    }
+    return texelFetch(uSource, ivec3(min(coord, uBaseSize - 1), layer), 0);
+}
+
+// each thread reduces a 4x4 input block to two mips, the workgroup then reduces its 16x16 results in shared memory,
+// returns the single texel of the last mip in the first thread
+vec4 DownsampleTile(bool fromIntermediate, ivec2 tile, int layer, int firstMip)
+{
+    ivec2 thread = ivec2(gl_LocalInvocationID.xy);
+    ivec2 origin = tile * 64 + thread * 4;
+
+    vec4 texel = vec4(0.0);
+    for (int i = 0; i < 4; i++)
+    {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        ivec2 corner = origin + offset * 2;
+        vec4 value = (LoadTexel(fromIntermediate, corner, layer) + LoadTexel(fromIntermediate, corner + ivec2(1, 0), layer) +
+            LoadTexel(fromIntermediate, corner + ivec2(0, 1), layer) + LoadTexel(fromIntermediate, corner + ivec2(1, 1), layer)) * 0.25;
+        StoreMip(firstMip, tile * 32 + thread * 2 + offset, layer, value);
+        texel += value * 0.25;
+    }
+    StoreMip(firstMip + 1, tile * 16 + thread, layer, texel);
+    sTexels[thread.y][thread.x] = texel;
+
+    int groupSize = 8;
+    for (int level = 2; level < 6; level++, groupSize /= 2)
+    {
+        barrier();
+        bool active = all(lessThan(thread, ivec2(groupSize)));
+        if (active)
+        {
+            ivec2 source = thread * 2;
+            texel = (sTexels[source.y][source.x] + sTexels[source.y][source.x + 1] +
+                sTexels[source.y + 1][source.x] + sTexels[source.y + 1][source.x + 1]) * 0.25;
+        }
+        barrier();
+        if (active)
+        {
+            sTexels[thread.y][thread.x] = texel;
+            StoreMip(firstMip + level, tile * groupSize + thread, layer, texel);
+        }
+    }
+    return texel;
+}
+
+void main()
+{
+    int layer = int(gl_WorkGroupID.z);
+    ivec2 tile = ivec2(gl_WorkGroupID.xy);
+    vec4 texel = DownsampleTile(false, tile, layer, 1);
+    if (uMipCount <= 6)
+        return;
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        intermediate[layer * 4096 + tile.y * 64 + tile.x] = texel;
+        memoryBarrierBuffer();
+        sIsLastGroup = atomicAdd(counters[layer], 1) == uint(uTileCount.x * uTileCount.y - 1) ? 1 : 0;
+    }
+    barrier();
+    if (sIsLastGroup == 0)
+        return;
+
+    memoryBarrierBuffer();
+    DownsampleTile(true, ivec2(0), layer, 7);
+}
+)";
+
+    constexpr uint32_t MAX_DOWNSAMPLE_MIPS = 12;
+    constexpr uint32_t DOWNSAMPLE_TILE_SIZE = 64;
+    // mip 6 of the tiles of one layer, read back by the last workgroup
+    constexpr uint32_t MAX_DOWNSAMPLE_TILES = 64;
+    constexpr uint32_t MAX_DOWNSAMPLE_PASSES = 8;
+
+    struct DownsampleParameters
+    {
+        int32_t BaseSize[2];
+        int32_t TileCount[2];
+        int32_t MipCount;
+        int32_t IsSRGB;
+    };
+
+    static VkFormatFeatureFlags GetOptimalTilingFeatures(Format format)
+    {
+        return GetVulkanContext()->GetFormatProperties(format).optimalTilingFeatures;
+    }
+
+    bool SupportsLinearBlit(Format format)
+    {
+        VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (GetOptimalTilingFeatures(format) & required) == required;
+    }
+
+    bool SupportsStorageDownsample(Format format)
+    {
+        return GetVulkanContext()->GetEnabledDeviceFeatures().shaderStorageImageWriteWithoutFormat &&
+            (GetOptimalTilingFeatures(format) & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0 &&
+            (GetOptimalTilingFeatures(GetLinearFormat(format)) & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+    }
+
+    static void TransitionMips(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip, uint32_t mipCount,
+        VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        if (mipCount == 0)
+            return;
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = static_cast<VkImage>(texture.GetHandle());
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = baseMip;
+        barrier.subresourceRange.levelCount = mipCount;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = texture.GetInfo().Layers;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    VulkanMipGenerator::~VulkanMipGenerator()
+    {
+        this->ReleaseTransientResources();
+    }
+
+    void VulkanMipGenerator::RecordGenerateMips(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip)
+    {
+        const TextureInfo& info = texture.GetInfo();
+        uint32_t mipCount = GetTextureMipCount(info);
+        VALX_ASSERT(baseMip < mipCount);
+        VALX_ASSERT(static_cast<bool>(info.Flags & TextureFlags::GENERATE_MIPS) && "texture was not created with TextureFlags::GENERATE_MIPS");
+
+        if (SupportsLinearBlit(info.TextureFormat))
+        {
+            this->RecordBlitChain(commandBuffer, texture, baseMip);
+        }
+        else if (info.Type != TextureType::TEXTURE_3D && SupportsStorageDownsample(info.TextureFormat))
+        {
+            this->RecordComputeDownsample(commandBuffer, texture, baseMip);
+        }
+        else
+        {
+            GetCurrentLogger()->LogWarning("VulkanMipGenerator", fmt::format("texture `{}`: format {} supports neither linear blits nor storage writes, mips are left empty",
+                info.Name, (int)info.TextureFormat));
+            TransitionMips(commandBuffer, texture, 0, mipCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+        }
+    }
+
+    void VulkanMipGenerator::RecordBlitChain(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip)
+    {
+        const TextureInfo& info = texture.GetInfo();
+        uint32_t mipCount = GetTextureMipCount(info);
+        VkImage image = static_cast<VkImage>(texture.GetHandle());
+
+        // mips below the base are already filled and only need to end up in the same layout as the generated ones
+        TransitionMips(commandBuffer, texture, 0, baseMip, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+        for (uint32_t mip = baseMip + 1; mip < mipCount; mip++)
+        {
+            TransitionMips(commandBuffer, texture, mip - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+            VkImageBlit blit = {};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = mip - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = info.Layers;
+            blit.srcOffsets[1] = VkOffset3D{ (int32_t)std::max(info.Width >> (mip - 1), 1u), (int32_t)std::max(info.Height >> (mip - 1), 1u), (int32_t)std::max(info.Depth >> (mip - 1), 1u) };
+            blit.dstSubresource = blit.srcSubresource;
+            blit.dstSubresource.mipLevel = mip;
+            blit.dstOffsets[1] = VkOffset3D{ (int32_t)std::max(info.Width >> mip, 1u), (int32_t)std::max(info.Height >> mip, 1u), (int32_t)std::max(info.Depth >> mip, 1u) };
+            vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+        }
+
+        TransitionMips(commandBuffer, texture, 0, mipCount - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+        TransitionMips(commandBuffer, texture, mipCount - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    // every mip of every layer as an array, the source is read and the storage format written one mip at a time
+    static VkImageView GetMipView(const VulkanTexture& texture, Format format, uint32_t mip)
+    {
+        TextureViewInfo view;
+        view.Type = TextureViewType::TEXTURE_2D_ARRAY;
+        view.ViewFormat = format;
+        view.BaseMip = mip;
+        view.MipCount = 1;
+        return static_cast<VkImageView>(texture.GetView(view));
+    }
+
+    void VulkanMipGenerator::RecordComputeDownsample(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip)
+    {
+        const TextureInfo& info = texture.GetInfo();
+        uint32_t mipCount = GetTextureMipCount(info);
+
+        if (this->downsamplePipeline == nullptr)
+        {
+            ImmutableSamplerInfo sourceSampler;
+            sourceSampler.Binding = 0;
+            sourceSampler.Sampler.Name = "Mip Downsample Source";
+            sourceSampler.Sampler.AddressModeU = AddressMode::CLAMP_TO_EDGE;
+            sourceSampler.Sampler.AddressModeV = AddressMode::CLAMP_TO_EDGE;
+            sourceSampler.Sampler.AddressModeW = AddressMode::CLAMP_TO_EDGE;
+            sourceSampler.Sampler.EnableAnisotropy = false;
+            this->downsamplePipeline = std::make_unique<VulkanComputePipeline>("Mip Downsample", DownsampleShaderSource, MAX_DOWNSAMPLE_PASSES,
+                std::vector<ImmutableSamplerInfo>{ sourceSampler });
+        }
+
+        BufferInfo intermediateInfo;
+        intermediateInfo.Name = info.Name + " downsample intermediate";
+        intermediateInfo.Flags = BufferFlags::STORAGE_BUFFER;
+        intermediateInfo.MemoryType = BufferMemory::GPU_ONLY;
+        intermediateInfo.Size = info.Layers * MAX_DOWNSAMPLE_TILES * MAX_DOWNSAMPLE_TILES * 4 * sizeof(float);
+        auto& intermediateBuffer = this->transientBuffers.emplace_back(std::make_unique<VulkanBuffer>(intermediateInfo));
+
+        BufferInfo counterInfo;
+        counterInfo.Name = info.Name + " downsample counters";
+        counterInfo.Flags = BufferFlags::STORAGE_BUFFER | BufferFlags::COPY_DST;
+        counterInfo.MemoryType = BufferMemory::GPU_ONLY;
+        counterInfo.Size = info.Layers * sizeof(uint32_t);
+        auto& counterBuffer = this->transientBuffers.emplace_back(std::make_unique<VulkanBuffer>(counterInfo));
+
+        VkBuffer counterHandle = static_cast<VkBuffer>(counterBuffer->GetHandle());
+        Format storageFormat = GetLinearFormat(info.TextureFormat);
+
+        TransitionMips(commandBuffer, texture, 0, mipCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        // one pass produces up to 12 mips, only 6 when the tile results of a layer do not fit into the intermediate buffer
+        uint32_t mip = baseMip;
+        while (mip + 1 < mipCount)
+        {
+            uint32_t width = std::max(info.Width >> mip, 1u);
+            uint32_t height = std::max(info.Height >> mip, 1u);
+            uint32_t tileCountX = GetDispatchSize(width, DOWNSAMPLE_TILE_SIZE);
+            uint32_t tileCountY = GetDispatchSize(height, DOWNSAMPLE_TILE_SIZE);
+            bool fitsIntermediate = tileCountX <= MAX_DOWNSAMPLE_TILES && tileCountY <= MAX_DOWNSAMPLE_TILES;
+            uint32_t passMipCount = std::min(mipCount - 1 - mip, fitsIntermediate ? MAX_DOWNSAMPLE_MIPS : MAX_DOWNSAMPLE_MIPS / 2);
+
+            VkDescriptorSet descriptorSet = this->downsamplePipeline->AllocateDescriptorSet();
+            WriteDescriptorImage(descriptorSet, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, GetMipView(texture, info.TextureFormat, mip),
+                VK_IMAGE_LAYOUT_GENERAL);
+            // unused slots repeat the last written mip, the shader never stores to them
+            VkImageView mipView = VK_NULL_HANDLE;
+            for (uint32_t i = 0; i < MAX_DOWNSAMPLE_MIPS; i++)
+            {
+                if (i < passMipCount)
+                    mipView = GetMipView(texture, storageFormat, mip + 1 + i);
+                WriteDescriptorImage(descriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, mipView, VK_IMAGE_LAYOUT_GENERAL, VK_NULL_HANDLE, i);
+            }
+            WriteDescriptorBuffer(descriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<VkBuffer>(intermediateBuffer->GetHandle()));
+            WriteDescriptorBuffer(descriptorSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, counterHandle);
+
+            vkCmdFillBuffer(commandBuffer, counterHandle, 0, VK_WHOLE_SIZE, 0);
+            VkMemoryBarrier counterBarrier = {};
+            counterBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            counterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &counterBarrier, 0, nullptr, 0, nullptr);
+
+            DownsampleParameters parameters = {};
+            parameters.BaseSize[0] = (int32_t)width;
+            parameters.BaseSize[1] = (int32_t)height;
+            parameters.TileCount[0] = (int32_t)tileCountX;
+            parameters.TileCount[1] = (int32_t)tileCountY;
+            parameters.MipCount = (int32_t)passMipCount;
+            parameters.IsSRGB = IsSRGBFormat(info.TextureFormat) ? 1 : 0;
+
+            this->downsamplePipeline->Bind(commandBuffer, descriptorSet);
+            this->downsamplePipeline->PushConstants(commandBuffer, &parameters, sizeof(parameters));
+            vkCmdDispatch(commandBuffer, tileCountX, tileCountY, info.Layers);
+
+            // the last mip of this pass is the source of the next one, the counters are cleared again by a transfer
+            VkMemoryBarrier passBarrier = {};
+            passBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            passBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            passBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &passBarrier, 0, nullptr, 0, nullptr);
+
+            mip += passMipCount;
+        }
+
+        TransitionMips(commandBuffer, texture, 0, mipCount, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    void VulkanMipGenerator::ReleaseTransientResources()
+    {
+        this->transientBuffers.clear();
+        if (this->downsamplePipeline != nullptr)
+            this->downsamplePipeline->ResetDescriptorSets();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "VulkanTexture.h"
+#include "VulkanBuffer.h"
+#include "VulkanComputePipeline.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+
+namespace VALX
+{
+    // fills the mip chain of a texture from one of its mips, with a chain of linear blits where the format supports it
+    // and with a single dispatch compute downsampler (up to 12 mips per dispatch) otherwise
+    class VulkanMipGenerator
+    {
+        std::unique_ptr<VulkanComputePipeline> downsamplePipeline;
+        std::vector<std::unique_ptr<VulkanBuffer>> transientBuffers;
+
+        void RecordBlitChain(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip);
+        void RecordComputeDownsample(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip);
+
+    public:
+        VulkanMipGenerator() = default;
+        ~VulkanMipGenerator();
+
+        VALX_NO_COPY_NO_MOVE(VulkanMipGenerator);
+
+        // expects every mip in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and mips up to baseMip filled,
+        // leaves every mip in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        void RecordGenerateMips(VkCommandBuffer commandBuffer, const VulkanTexture& texture, uint32_t baseMip);
+        // buffers and descriptor sets referenced by the recorded commands, call once they have finished executing
+        void ReleaseTransientResources();
+    };
+
+    bool SupportsLinearBlit(Format format);
+    bool SupportsStorageDownsample(Format format);
+}
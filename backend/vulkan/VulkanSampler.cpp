@@ -2,10 +2,38 @@
 #include "Utilities.h"
 #include "VulkanContext.h"
 #include "ExternalFunctions.h"
+#include "api/Hash.h"
 #include "api/Logger.h"
 
 namespace VALX
 {
+    size_t SamplerInfoHash::operator()(const SamplerInfo& info) const
+    {
+        size_t hash = 0;
+        HashCombine(hash, info.MagFilter);
+        HashCombine(hash, info.MinFilter);
+        HashCombine(hash, info.MipMapFilter);
+        HashCombine(hash, info.AddressModeU);
+        HashCombine(hash, info.AddressModeV);
+        HashCombine(hash, info.AddressModeW);
+        HashCombine(hash, info.MipLodBias);
+        HashCombine(hash, info.EnableAnisotropy);
+        HashCombine(hash, info.MaxAnisotropy);
+        HashCombine(hash, info.Compare);
+        HashCombine(hash, info.MinLod);
+        HashCombine(hash, info.MaxLod);
+        HashCombine(hash, info.Border);
+        return hash;
+    }
+
+    bool SamplerInfoEqual::operator()(const SamplerInfo& info1, const SamplerInfo& info2) const
+    {
+        return info1.MagFilter == info2.MagFilter && info1.MinFilter == info2.MinFilter && info1.MipMapFilter == info2.MipMapFilter &&
+            info1.AddressModeU == info2.AddressModeU && info1.AddressModeV == info2.AddressModeV && info1.AddressModeW == info2.AddressModeW &&
+            info1.MipLodBias == info2.MipLodBias && info1.EnableAnisotropy == info2.EnableAnisotropy && info1.MaxAnisotropy == info2.MaxAnisotropy &&
+            info1.Compare == info2.Compare && info1.MinLod == info2.MinLod && info1.MaxLod == info2.MaxLod && info1.Border == info2.Border;
+    }
+
     VkFilter ConvertFilter(Filter filter)
     {
         switch (filter)
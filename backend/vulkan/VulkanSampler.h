@@ -2,6 +2,7 @@
 
 #include "api/Sampler.h"
 #include <vulkan/vulkan.h>
+#include <cstddef>
 
 namespace VALX
 {
@@ -17,6 +18,17 @@ namespace VALX
         virtual ~VulkanSampler() override;
     };
 
+    // key of the shared sampler registry, the name is left out since it does not change the sampler
+    struct SamplerInfoHash
+    {
+        size_t operator()(const SamplerInfo& info) const;
+    };
+
+    struct SamplerInfoEqual
+    {
+        bool operator()(const SamplerInfo& info1, const SamplerInfo& info2) const;
+    };
+
     VkFilter ConvertFilter(Filter filter);
     VkSamplerMipmapMode ConvertMipMapFilter(Filter filter);
     VkSamplerAddressMode ConvertAddressMode(AddressMode addressMode);
@@ -24,6 +24,7 @@ namespace VALX
     struct ReflectionInfo
     {
         std::vector<VkDescriptorSetLayout> DescriptorSetLayouts;
+        std::vector<std::shared_ptr<Sampler>> ImmutableSamplers;
         VkPushConstantRange PushConstantRange = {};
     };
 
@@ -52,7 +53,7 @@ namespace VALX
         }
     };
 
-    static ReflectionInfo GenerateLayoutFromReflection(const std::vector<ShaderStageInfo>& stages)
+    static ReflectionInfo GenerateLayoutFromReflection(const std::vector<ShaderStageInfo>& stages, const std::vector<ImmutableSamplerInfo>& immutableSamplers)
     {
         std::unordered_map<SetBinding, VkDescriptorSetLayoutBinding, SetBindingHash, SetBindingEqual> bindings;
         uint32_t maxSetIndex = 0;
@@ -110,13 +111,32 @@ namespace VALX
             spvReflectDestroyShaderModule(&module);
         }
 
+        // every element of an arrayed binding gets the same sampler, the handle arrays have to outlive the layout creation
+        ReflectionInfo reflection;
+        std::vector<std::vector<VkSampler>> immutableSamplerHandles;
+        immutableSamplerHandles.reserve(immutableSamplers.size());
+        for (const ImmutableSamplerInfo& immutableSampler : immutableSamplers)
+        {
+            auto it = bindings.find({ immutableSampler.Set, immutableSampler.Binding });
+            VALX_ASSERT(it != bindings.end() && "immutable sampler declared for a binding the shader does not use");
+            VkDescriptorSetLayoutBinding& binding = it->second;
+            VALX_ASSERT((binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER || binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) &&
+                "immutable samplers need a sampler or combined image sampler binding");
+            VALX_ASSERT(binding.pImmutableSamplers == nullptr && "binding has more than one immutable sampler");
+            VALX_ASSERT(binding.descriptorCount > 0 && "runtime sized arrays can not have immutable samplers");
+
+            std::shared_ptr<Sampler> sampler = GetVulkanContext()->GetSampler(immutableSampler.Sampler);
+            immutableSamplerHandles.emplace_back(binding.descriptorCount, static_cast<VkSampler>(sampler->GetHandle()));
+            binding.pImmutableSamplers = immutableSamplerHandles.back().data();
+            reflection.ImmutableSamplers.push_back(std::move(sampler));
+        }
+
         std::vector<std::vector<VkDescriptorSetLayoutBinding>> bindingsPerSet(maxSetIndex + 1);
         for (const auto& [setBinding, binding] : bindings)
         {
             bindingsPerSet[setBinding.Set].push_back(binding);
         }
 
-        ReflectionInfo reflection;
         reflection.DescriptorSetLayouts.resize(maxSetIndex + 1);
         for (size_t i = 0; i < reflection.DescriptorSetLayouts.size(); i++)
         {
@@ -150,7 +170,7 @@ namespace VALX
             this->stages[i].Stage = ConvertShaderStageVulkan(stageInfo.Stage);
         }
 
-        ReflectionInfo reflection = GenerateLayoutFromReflection(info.Stages);
+        ReflectionInfo reflection = GenerateLayoutFromReflection(info.Stages, info.ImmutableSamplers);
 
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -161,6 +181,7 @@ namespace VALX
         VALX_VK_SUCCESS(vkCreatePipelineLayout(GetVulkanContext()->GetDevice(), &pipelineLayoutCreateInfo, nullptr, &this->pipelineLayout));
         this->name = info.Name;
         this->descriptorSetLayouts = std::move(reflection.DescriptorSetLayouts);
+        this->immutableSamplers = std::move(reflection.ImmutableSamplers);
 
         VkDebugUtilsObjectNameInfoEXT debugName = {};
         debugName.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -198,6 +219,26 @@ namespace VALX
         GetCurrentLogger()->LogInfo("VulkanShader", fmt::format("shader `{}` destroyed", this->name));
     }
 
+    VkPipelineLayout VulkanShader::GetPipelineLayout() const
+    {
+        return this->pipelineLayout;
+    }
+
+    const std::vector<VkDescriptorSetLayout>& VulkanShader::GetDescriptorSetLayouts() const
+    {
+        return this->descriptorSetLayouts;
+    }
+
+    VkShaderModule VulkanShader::GetShaderModule(VkShaderStageFlagBits stage) const
+    {
+        for (const ShaderStage& shaderStage : this->stages)
+        {
+            if (shaderStage.Stage == stage)
+                return shaderStage.Module;
+        }
+        return VK_NULL_HANDLE;
+    }
+
     VkShaderStageFlagBits ConvertShaderStageVulkan(ShaderStage stage)
     {
         switch (stage)
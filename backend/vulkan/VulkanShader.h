@@ -2,6 +2,8 @@
 
 #include "api/Shader.h"
 #include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
 
 namespace VALX
 {
@@ -15,6 +17,8 @@ namespace VALX
         std::string name;
         std::vector<ShaderStage> stages;
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+        // referenced by the set layouts, kept alive as long as they are
+        std::vector<std::shared_ptr<Sampler>> immutableSamplers;
         VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
 
     public:
@@ -23,6 +27,10 @@ namespace VALX
         virtual const std::string& GetName() const override;
         virtual Handle GetHandle() const override;
         virtual ~VulkanShader() override;
+
+        VkPipelineLayout GetPipelineLayout() const;
+        const std::vector<VkDescriptorSetLayout>& GetDescriptorSetLayouts() const;
+        VkShaderModule GetShaderModule(VkShaderStageFlagBits stage) const;
     };
 
     VkShaderStageFlagBits ConvertShaderStageVulkan(ShaderStage stage);
@@ -2,7 +2,12 @@
 #include "Utilities.h"
 #include "api/Logger.h"
 #include "VulkanContext.h"
+#include "api/Hash.h"
+#include "api/MappedFile.h"
 
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 
 #include <ShaderLang.h>
@@ -156,10 +161,89 @@ namespace VALX
         }
     }
 
-    ShaderStageInfo VulkanShaderLoader::LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language)
+    // bumped whenever the cache layout or the compiler settings change, so stale entries are never hit
+    static constexpr uint32_t SHADER_CACHE_VERSION = 1;
+    static constexpr uint32_t SHADER_CACHE_MAGIC = 0x43535856; // "VXSC"
+    static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    static constexpr int GLSL_VERSION = 460;
+
+    struct ShaderCacheHeader
+    {
+        uint32_t Magic = SHADER_CACHE_MAGIC;
+        uint32_t Version = SHADER_CACHE_VERSION;
+        uint64_t Key = 0;
+        uint64_t ByteSize = 0;
+    };
+
+    static std::string GetDefinesPreamble(const std::vector<ShaderDefine>& defines)
+    {
+        std::string result;
+        for (const ShaderDefine& define : defines)
+            result += fmt::format("#define {} {}\n", define.Name, define.Value);
+        return result;
+    }
+
+    // the preamble stands for the defines, the API version for the target environment the bytecode is built for
+    static uint64_t ComputeShaderCacheKey(const std::string& source, const std::string& preamble, ShaderStage stage, ShaderLanguage language)
+    {
+        uint32_t settings[] = {
+            SHADER_CACHE_VERSION,
+            (uint32_t)stage,
+            (uint32_t)language,
+            (uint32_t)GLSL_VERSION,
+            GetVulkanContext()->GetAPIVersion(),
+            (uint32_t)glslang::EShTargetLanguageVersion::EShTargetSpv_1_5,
+        };
+        uint64_t sourceHash = HashBytes(source.data(), source.size());
+        uint64_t settingsHash = HashBytes(settings, sizeof(settings), sourceHash);
+        return HashBytes(preamble.data(), preamble.size(), settingsHash);
+    }
+
+    static std::string GetShaderCachePath(const std::string& directory, uint64_t key)
+    {
+        return (std::filesystem::path(directory) / fmt::format("{:016x}.vxspv", key)).string();
+    }
+
+    static bool ReadCachedShader(const std::string& cachePath, uint64_t key, std::vector<char>& bytecode)
+    {
+        std::ifstream file(cachePath, std::ifstream::binary | std::ifstream::ate);
+        if (!file.good())
+            return false;
+        uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+
+        ShaderCacheHeader header;
+        if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+        if (header.Magic != SHADER_CACHE_MAGIC || header.Version != SHADER_CACHE_VERSION || header.Key != key)
+            return false;
+        // the size is checked against the file before it is allocated
+        if (header.ByteSize != fileSize - sizeof(header) || header.ByteSize < sizeof(uint32_t) || header.ByteSize % sizeof(uint32_t) != 0)
+            return false;
+
+        bytecode.resize(header.ByteSize);
+        if (!file.read(bytecode.data(), bytecode.size()))
+            return false;
+
+        uint32_t magic = 0;
+        std::memcpy(&magic, bytecode.data(), sizeof(magic));
+        return magic == SPIRV_MAGIC;
+    }
+
+    static bool WriteCachedShader(const std::string& cachePath, uint64_t key, const std::vector<char>& bytecode)
+    {
+        ShaderCacheHeader header;
+        header.Key = key;
+        header.ByteSize = bytecode.size();
+
+        // several loaders, also of other processes, may share one cache directory
+        return WriteFileAtomically(cachePath, { { &header, sizeof(header) }, { bytecode.data(), bytecode.size() } });
+    }
+
+    ShaderStageInfo VulkanShaderLoader::LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines)
     {
         std::ifstream file(filepath, std::ifstream::binary);
-        return this->LoadFromSourceString(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()), stage, language);
+        return this->LoadFromSourceString(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()), stage, language, defines);
     }
 
     ShaderStageInfo VulkanShaderLoader::LoadFromBinaryFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language)
@@ -171,22 +255,23 @@ namespace VALX
         return result;
     }
 
-    ShaderStageInfo VulkanShaderLoader::LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language)
+    std::vector<char> VulkanShaderLoader::CompileSource(const std::string& source, const std::string& preamble, ShaderStage stage, ShaderLanguage language)
     {
+        auto startTime = std::chrono::steady_clock::now();
         const char* sourcePtr = source.c_str();
-        const int shaderVersion = 460;
         EShLanguage shaderStage = ConvertShaderStageGlslang(stage);
         glslang::TShader shader(shaderStage);
         shader.setStrings(&sourcePtr, 1);
-        shader.setEnvInput(ConvertShaderLanguage(language), shaderStage, glslang::EShClient::EShClientVulkan, shaderVersion);
+        shader.setPreamble(preamble.c_str());
+        shader.setEnvInput(ConvertShaderLanguage(language), shaderStage, glslang::EShClient::EShClientVulkan, GLSL_VERSION);
         shader.setEnvClient(glslang::EShClient::EShClientVulkan, (glslang::EShTargetClientVersion)GetVulkanContext()->GetAPIVersion());
         shader.setEnvTarget(glslang::EShTargetLanguage::EShTargetSpv, glslang::EShTargetLanguageVersion::EShTargetSpv_1_5);
-        bool isParsed = shader.parse(&glslang::DefaultTBuiltInResource, shaderVersion, false, EShMessages::EShMsgDefault);
+        bool isParsed = shader.parse(&glslang::DefaultTBuiltInResource, GLSL_VERSION, false, EShMessages::EShMsgDefault);
         if (!isParsed)
         {
             const char* log = shader.getInfoLog();
             GetCurrentLogger()->LogError("VulkanShaderLoader", std::string(log));
-            return ShaderStageInfo{ };
+            return {};
         }
 
         glslang::TProgram program;
@@ -196,17 +281,74 @@ namespace VALX
         {
             const char* log = shader.getInfoLog();
             GetCurrentLogger()->LogError("VulkanShaderLoader", std::string(log));
-            return ShaderStageInfo{ };
-
+            return {};
         }
 
         auto intermediate = program.getIntermediate(shaderStage);
         std::vector<uint32_t> bytecode;
         glslang::GlslangToSpv(*intermediate, bytecode);
 
+        this->compileMicroseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+        return std::vector<char>(reinterpret_cast<const char*>(bytecode.data()), reinterpret_cast<const char*>(bytecode.data() + bytecode.size()));
+    }
+
+    ShaderStageInfo VulkanShaderLoader::LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines)
+    {
+        std::string preamble = GetDefinesPreamble(defines);
         ShaderStageInfo result;
-        result.Bytecode = std::vector<char>(reinterpret_cast<const char*>(bytecode.data()), reinterpret_cast<const char*>(bytecode.data() + bytecode.size()));
         result.Stage = stage;
+        if (this->cacheDirectory.empty())
+        {
+            result.Bytecode = this->CompileSource(source, preamble, stage, language);
+            return result;
+        }
+
+        uint64_t key = ComputeShaderCacheKey(source, preamble, stage, language);
+        std::string cachePath = GetShaderCachePath(this->cacheDirectory, key);
+        if (ReadCachedShader(cachePath, key, result.Bytecode))
+        {
+            this->cacheHits++;
+            return result;
+        }
+
+        // failed compilations are not cached, their errors are reported again on the next load
+        this->cacheMisses++;
+        result.Bytecode = this->CompileSource(source, preamble, stage, language);
+        if (!result.Bytecode.empty() && !WriteCachedShader(cachePath, key, result.Bytecode))
+            GetCurrentLogger()->LogWarning("VulkanShaderLoader", fmt::format("cannot write shader cache entry `{}`", cachePath));
         return result;
     }
-}
\ No newline at end of file
+
+    void VulkanShaderLoader::SetCacheDirectory(const std::string& directory)
+    {
+        this->cacheDirectory = directory;
+        if (!directory.empty())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+            if (error)
+                GetCurrentLogger()->LogWarning("VulkanShaderLoader", fmt::format("cannot create shader cache directory `{}`: {}", directory, error.message()));
+        }
+    }
+
+    const std::string& VulkanShaderLoader::GetCacheDirectory() const
+    {
+        return this->cacheDirectory;
+    }
+
+    ShaderCacheStatistics VulkanShaderLoader::GetCacheStatistics() const
+    {
+        ShaderCacheStatistics statistics;
+        statistics.Hits = this->cacheHits.load();
+        statistics.Misses = this->cacheMisses.load();
+        statistics.CompileMilliseconds = double(this->compileMicroseconds.load()) / 1000.0;
+        return statistics;
+    }
+
+    void VulkanShaderLoader::ResetCacheStatistics()
+    {
+        this->cacheHits = 0;
+        this->cacheMisses = 0;
+        this->compileMicroseconds = 0;
+    }
+}
@@ -2,13 +2,28 @@
 
 #include "api/ShaderLoader.h"
 
+#include <atomic>
+
 namespace VALX
 {
     class VulkanShaderLoader : public ShaderLoader
     {
+        std::string cacheDirectory;
+        std::atomic<uint64_t> cacheHits{ 0 };
+        std::atomic<uint64_t> cacheMisses{ 0 };
+        // microseconds, atomics of double need C++20
+        std::atomic<uint64_t> compileMicroseconds{ 0 };
+
+        std::vector<char> CompileSource(const std::string& source, const std::string& preamble, ShaderStage stage, ShaderLanguage language);
+
     public:
-        virtual ShaderStageInfo LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language) override;
+        virtual ShaderStageInfo LoadFromSourceFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines = {}) override;
         virtual ShaderStageInfo LoadFromBinaryFile(const std::string& filepath, ShaderStage stage, ShaderLanguage language) override;
-        virtual ShaderStageInfo LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language) override;
+        virtual ShaderStageInfo LoadFromSourceString(const std::string& source, ShaderStage stage, ShaderLanguage language, const std::vector<ShaderDefine>& defines = {}) override;
+
+        virtual void SetCacheDirectory(const std::string& directory) override;
+        virtual const std::string& GetCacheDirectory() const override;
+        virtual ShaderCacheStatistics GetCacheStatistics() const override;
+        virtual void ResetCacheStatistics() override;
     };
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Utilities.h"
 #include "VulkanFormat.h"
 #include "VulkanContext.h"
+#include "VulkanMipGenerator.h"
 #include "ExternalFunctions.h"
 #include "api/Logger.h"
 
@@ -9,6 +10,13 @@
 
 namespace VALX
 {
+    // mirrors the path VulkanMipGenerator::RecordGenerateMips takes, only the compute downsampler needs storage views
+    static bool UsesStorageDownsample(const TextureInfo& info)
+    {
+        return static_cast<bool>(info.Flags & TextureFlags::GENERATE_MIPS) && info.Type != TextureType::TEXTURE_3D &&
+            !IsBlockCompressedFormat(info.TextureFormat) && !SupportsLinearBlit(info.TextureFormat) && SupportsStorageDownsample(info.TextureFormat);
+    }
+
     static VkImageCreateFlags GetImageCreateFlags(const TextureInfo& info)
     {
         VkImageCreateFlags result = {};
@@ -16,6 +24,13 @@ namespace VALX
             result |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
         if (info.Type == TextureType::TEXTURE_CUBE)
             result |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        // the compute downsampler writes through views with a storable format, sRGB is encoded manually
+        if (UsesStorageDownsample(info))
+        {
+            result |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+            if (IsSRGBFormat(info.TextureFormat))
+                result |= VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+        }
 
         return result;
     }
@@ -30,6 +45,10 @@ namespace VALX
         {
             VALX_ASSERT(info.Layers == 1);
         }
+        VALX_ASSERT(GetVulkanContext()->GetFormatCapabilities(info.TextureFormat).Supports(GetRequiredFormatFeatures(info.Flags)) &&
+            "texture format is not supported for its flags, Context::CreateTexture picks a fallback");
+        VALX_ASSERT(!(static_cast<bool>(info.Flags & TextureFlags::GENERATE_MIPS) && IsBlockCompressedFormat(info.TextureFormat)) &&
+            "block-compressed textures cannot generate mips, upload the mips stored with the data instead");
 
         VkImageCreateInfo imageCreateInfo = {};
         imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -41,11 +60,13 @@ namespace VALX
         imageCreateInfo.samples = ConvertSampleCountVulkan(info.Samples);
         imageCreateInfo.format = ConvertFormatVulkan(info.TextureFormat);
         imageCreateInfo.imageType = ConvertTextureTypeVulkan(info.Type);
-        imageCreateInfo.mipLevels = (info.Mips == ALL_MIPS) ? GetMipLevelCount(std::max({ info.Width, info.Height, info.Depth })) : info.Mips;
+        imageCreateInfo.mipLevels = GetTextureMipCount(info);
         imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         imageCreateInfo.usage = ConvertTextureFlags(info.Flags);
+        if (UsesStorageDownsample(info))
+            imageCreateInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
 
         VmaAllocationCreateInfo allocationCreateInfo = {};
         allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -73,8 +94,87 @@ namespace VALX
         return static_cast<Texture::Handle>(this->image);
     }
 
+    TextureViewInfo VulkanTexture::ResolveViewInfo(const TextureViewInfo& view) const
+    {
+        TextureViewInfo result = view;
+        uint32_t mipCount = GetTextureMipCount(this->info);
+        VALX_ASSERT(view.BaseMip < mipCount && view.BaseLayer < this->info.Layers);
+        if (result.MipCount == ALL_MIPS)
+            result.MipCount = mipCount - view.BaseMip;
+        if (result.LayerCount == ALL_LAYERS)
+            result.LayerCount = this->info.Layers - view.BaseLayer;
+        VALX_ASSERT(result.BaseMip + result.MipCount <= mipCount && result.BaseLayer + result.LayerCount <= this->info.Layers);
+
+        if (result.ViewFormat == Format::UNKNOWN)
+            result.ViewFormat = this->info.TextureFormat;
+        VALX_ASSERT((result.ViewFormat == this->info.TextureFormat || (GetImageCreateFlags(this->info) & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT) != 0) &&
+            "views of another format need a texture created with a mutable format");
+
+        if (result.Type == TextureViewType::DEFAULT)
+        {
+            if (this->info.Type == TextureType::TEXTURE_3D)
+                result.Type = TextureViewType::TEXTURE_3D;
+            else if (this->info.Type == TextureType::TEXTURE_CUBE && result.LayerCount % 6 == 0)
+                result.Type = result.LayerCount == 6 ? TextureViewType::TEXTURE_CUBE : TextureViewType::TEXTURE_CUBE_ARRAY;
+            else
+                result.Type = result.LayerCount == 1 ? TextureViewType::TEXTURE_2D : TextureViewType::TEXTURE_2D_ARRAY;
+        }
+
+        if (result.Aspect == TextureAspect::DEFAULT && !IsDepthFormat(result.ViewFormat) && !IsStencilFormat(result.ViewFormat))
+            result.Aspect = TextureAspect::COLOR;
+        return result;
+    }
+
+    Texture::Handle VulkanTexture::GetView(const TextureViewInfo& view) const
+    {
+        TextureViewInfo resolved = this->ResolveViewInfo(view);
+
+        std::lock_guard<std::mutex> lock(this->viewsMutex);
+        for (const CachedView& cached : this->views)
+        {
+            if (cached.Info == resolved)
+                return static_cast<Texture::Handle>(cached.View);
+        }
+
+        VkImageViewCreateInfo viewCreateInfo = {};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = this->image;
+        viewCreateInfo.viewType = ConvertTextureViewTypeVulkan(resolved.Type);
+        viewCreateInfo.format = ConvertFormatVulkan(resolved.ViewFormat);
+        viewCreateInfo.components.r = ConvertComponentSwizzleVulkan(resolved.SwizzleR);
+        viewCreateInfo.components.g = ConvertComponentSwizzleVulkan(resolved.SwizzleG);
+        viewCreateInfo.components.b = ConvertComponentSwizzleVulkan(resolved.SwizzleB);
+        viewCreateInfo.components.a = ConvertComponentSwizzleVulkan(resolved.SwizzleA);
+        switch (resolved.Aspect)
+        {
+        case TextureAspect::COLOR:
+            viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            break;
+        case TextureAspect::DEPTH:
+            viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            break;
+        case TextureAspect::STENCIL:
+            viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
+            break;
+        default:
+            viewCreateInfo.subresourceRange.aspectMask = GetImageAspectFlagsVulkan(resolved.ViewFormat);
+            break;
+        }
+        viewCreateInfo.subresourceRange.baseMipLevel = resolved.BaseMip;
+        viewCreateInfo.subresourceRange.levelCount = resolved.MipCount;
+        viewCreateInfo.subresourceRange.baseArrayLayer = resolved.BaseLayer;
+        viewCreateInfo.subresourceRange.layerCount = resolved.LayerCount;
+
+        VkImageView result = VK_NULL_HANDLE;
+        VALX_VK_SUCCESS(vkCreateImageView(GetVulkanContext()->GetDevice(), &viewCreateInfo, nullptr, &result));
+        this->views.push_back(CachedView{ resolved, result });
+        return static_cast<Texture::Handle>(result);
+    }
+
     VulkanTexture::~VulkanTexture()
     {
+        for (const CachedView& cached : this->views)
+            vkDestroyImageView(GetVulkanContext()->GetDevice(), cached.View, nullptr);
         vmaDestroyImage(GetVulkanContext()->GetAllocator(), this->image, this->allocation);
         GetCurrentLogger()->LogInfo("VulkanTexture", fmt::format("texture `{}` destroyed", info.Name));
     }
@@ -134,7 +234,66 @@ namespace VALX
             result |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
         if (static_cast<bool>(flags & TextureFlags::DEPTH_STENCIL_ATTACHMENT))
             result |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        if (static_cast<bool>(flags & TextureFlags::GENERATE_MIPS))
+            result |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         
         return result;
     }
+
+    VkImageViewType ConvertTextureViewTypeVulkan(TextureViewType type)
+    {
+        switch (type)
+        {
+        case VALX::TextureViewType::TEXTURE_2D:
+            return VK_IMAGE_VIEW_TYPE_2D;
+        case VALX::TextureViewType::TEXTURE_2D_ARRAY:
+            return VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+        case VALX::TextureViewType::TEXTURE_3D:
+            return VK_IMAGE_VIEW_TYPE_3D;
+        case VALX::TextureViewType::TEXTURE_CUBE:
+            return VK_IMAGE_VIEW_TYPE_CUBE;
+        case VALX::TextureViewType::TEXTURE_CUBE_ARRAY:
+            return VK_IMAGE_VIEW_TYPE_CUBE_ARRAY;
+        default:
+            VALX_ASSERT(false && "view type has to be resolved before conversion");
+            return VK_IMAGE_VIEW_TYPE_2D;
+        }
+    }
+
+    VkComponentSwizzle ConvertComponentSwizzleVulkan(ComponentSwizzle swizzle)
+    {
+        switch (swizzle)
+        {
+        case VALX::ComponentSwizzle::IDENTITY:
+            return VK_COMPONENT_SWIZZLE_IDENTITY;
+        case VALX::ComponentSwizzle::ZERO:
+            return VK_COMPONENT_SWIZZLE_ZERO;
+        case VALX::ComponentSwizzle::ONE:
+            return VK_COMPONENT_SWIZZLE_ONE;
+        case VALX::ComponentSwizzle::R:
+            return VK_COMPONENT_SWIZZLE_R;
+        case VALX::ComponentSwizzle::G:
+            return VK_COMPONENT_SWIZZLE_G;
+        case VALX::ComponentSwizzle::B:
+            return VK_COMPONENT_SWIZZLE_B;
+        case VALX::ComponentSwizzle::A:
+            return VK_COMPONENT_SWIZZLE_A;
+        default:
+            VALX_ASSERT(false && "invalid component swizzle");
+            return VK_COMPONENT_SWIZZLE_IDENTITY;
+        }
+    }
+
+    VkBufferImageCopy ConvertTextureSubresourceVulkan(const TextureSubresource& subresource, Format format)
+    {
+        VALX_ASSERT(!(IsDepthFormat(format) && IsStencilFormat(format)) && "depth stencil formats are uploaded one aspect at a time");
+        VkBufferImageCopy region = {};
+        region.bufferOffset = subresource.Offset;
+        region.imageSubresource.aspectMask = GetImageAspectFlagsVulkan(format);
+        region.imageSubresource.mipLevel = subresource.Mip;
+        region.imageSubresource.baseArrayLayer = subresource.Layer;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = VkExtent3D{ subresource.Width, subresource.Height, subresource.Depth };
+        return region;
+    }
 }
\ No newline at end of file
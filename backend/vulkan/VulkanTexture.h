@@ -3,6 +3,8 @@
 #include "api/Texture.h"
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
+#include <mutex>
+#include <vector>
 
 namespace VALX
 {
@@ -13,15 +15,35 @@ namespace VALX
         VmaAllocation allocation = {};
         VmaAllocationInfo allocationInfo = {};
 
+        struct CachedView
+        {
+            TextureViewInfo Info;
+            VkImageView View = VK_NULL_HANDLE;
+        };
+
+        // keyed by the resolved info, so a default view and the same range spelled out share one entry. A texture has
+        // a handful of views at most, a linear search beats hashing them
+        mutable std::vector<CachedView> views;
+        mutable std::mutex viewsMutex;
+
+        TextureViewInfo ResolveViewInfo(const TextureViewInfo& view) const;
+
     public:
         VulkanTexture(const TextureInfo& info);
 
+        VALX_NO_COPY_NO_MOVE(VulkanTexture);
+
         virtual const TextureInfo& GetInfo() const override;
         virtual Handle GetHandle() const override;
+        virtual Handle GetView(const TextureViewInfo& view = {}) const override;
         virtual ~VulkanTexture() override;
     };
 
     VkImageType ConvertTextureTypeVulkan(TextureType type);
     VkSampleCountFlagBits ConvertSampleCountVulkan(SampleCount samples);
     VkImageUsageFlags ConvertTextureFlags(TextureFlags flags);
+    VkImageViewType ConvertTextureViewTypeVulkan(TextureViewType type);
+    VkComponentSwizzle ConvertComponentSwizzleVulkan(ComponentSwizzle swizzle);
+    // depth stencil formats are copied one aspect at a time, the staging layout holds a single one
+    VkBufferImageCopy ConvertTextureSubresourceVulkan(const TextureSubresource& subresource, Format format);
 }
\ No newline at end of file
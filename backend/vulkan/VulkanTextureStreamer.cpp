@@ -0,0 +1,517 @@
+#include "VulkanTextureStreamer.h"
+#include "VulkanContext.h"
+#include "Utilities.h"
+#include "api/ThreadPool.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+
+namespace VALX
+{
+    constexpr VkPipelineStageFlags SAMPLING_STAGES = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    static void TransitionImage(VkCommandBuffer commandBuffer, const VulkanTexture& texture, VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = static_cast<VkImage>(texture.GetHandle());
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = GetTextureMipCount(texture.GetInfo());
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = texture.GetInfo().Layers;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    // every layer of a streamed mip starts at an aligned offset of the staging memory
+    static size_t GetLayerStagingStride(const TextureSubresource& subresource, Format format)
+    {
+        size_t alignment = GetTextureSubresourceAlignment(format);
+        return (subresource.Size + alignment - 1) / alignment * alignment;
+    }
+
+    static const TextureFlags RESIDENT_TEXTURE_FLAGS = TextureFlags::SAMPLED | TextureFlags::COPY_SRC | TextureFlags::COPY_DST;
+
+    static TextureInfo GetResidentTextureInfo(const std::string& name, const MappedTextureData& source, Format format, uint32_t residentMip)
+    {
+        TextureInfo info;
+        info.Name = name;
+        info.Type = source.Type;
+        info.TextureFormat = format;
+        info.Flags = RESIDENT_TEXTURE_FLAGS;
+        info.Width = std::max(source.Width >> residentMip, 1u);
+        info.Height = std::max(source.Height >> residentMip, 1u);
+        info.Layers = source.Layers;
+        info.Mips = source.MipCount - residentMip;
+        info.TopDown = source.TopDown;
+        return info;
+    }
+
+    VulkanTextureStreamer::VulkanTextureStreamer(const TextureStreamerInfo& info)
+        : info(info)
+    {
+        VALX_ASSERT(info.FramesInFlight > 0 && info.MaxPendingLoads > 0);
+        this->stagingBuffers.resize(info.FramesInFlight);
+        this->budgetBytes = this->ComputeBudget();
+
+        GetCurrentLogger()->LogInfo("VulkanTextureStreamer", fmt::format("texture streamer created with a budget of {:.2f} MB", this->budgetBytes / 1e6));
+    }
+
+    VulkanTextureStreamer::~VulkanTextureStreamer()
+    {
+        // loads write into this object
+        for (std::future<void>& load : this->loads)
+            load.wait();
+    }
+
+    uint64_t VulkanTextureStreamer::ComputeBudget() const
+    {
+        if (this->info.BudgetBytes != 0)
+            return this->info.BudgetBytes;
+
+        VmaAllocator allocator = GetVulkanContext()->GetAllocator();
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(allocator, &memoryProperties);
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+        vmaGetHeapBudgets(allocator, budgets.data());
+
+        // the resident textures count as available, they are what the streamer would give back
+        uint64_t result = 0;
+        for (uint32_t heap = 0; heap < memoryProperties->memoryHeapCount; heap++)
+        {
+            if ((memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0)
+                continue;
+
+            const VmaBudget& budget = budgets[heap];
+            uint64_t available = budget.budget > budget.usage ? budget.budget - budget.usage : 0;
+            uint64_t share = static_cast<uint64_t>(budget.budget * double(this->info.BudgetFraction));
+            result = std::max(result, std::min(share, this->statistics.ResidentBytes + available));
+        }
+        return result;
+    }
+
+    TextureSubresource VulkanTextureStreamer::GetResidentSubresource(const StreamedTexture& texture, uint32_t layer, uint32_t mip) const
+    {
+        TextureSubresource result = texture.Source.GetSubresource(layer, mip);
+        result.Size = GetImageByteSize(texture.TextureFormat, result.Width, result.Height, result.Depth);
+        return result;
+    }
+
+    uint64_t VulkanTextureStreamer::GetMipByteSize(const StreamedTexture& texture, uint32_t mip) const
+    {
+        uint64_t result = 0;
+        for (uint32_t layer = 0; layer < texture.Source.Layers; layer++)
+            result += this->GetResidentSubresource(texture, layer, mip).Size;
+        return result;
+    }
+
+    uint64_t VulkanTextureStreamer::GetResidentByteSize(const StreamedTexture& texture) const
+    {
+        uint64_t result = 0;
+        for (uint32_t mip = texture.ResidentMip; mip < texture.Source.MipCount; mip++)
+            result += this->GetMipByteSize(texture, mip);
+        return result;
+    }
+
+    StreamedTextureHandle VulkanTextureStreamer::AddTexture(const std::string& filePath, const std::string& name)
+    {
+        MappedTextureData source = GetVulkanContext()->GetTextureLoader()->MapDDSFile(filePath);
+        VALX_ASSERT(!source.IsEmpty() && "streamed texture could not be mapped");
+        VALX_ASSERT(source.Type != TextureType::TEXTURE_3D && "volume textures are not streamed");
+
+        // the file layout only works for mip copies if the device samples the format as stored, otherwise every mip is converted
+        Format format = GetVulkanContext()->GetSupportedTextureFormat(source.TextureFormat, RESIDENT_TEXTURE_FLAGS);
+        if (format == Format::UNKNOWN)
+        {
+            GetCurrentLogger()->LogError("VulkanTextureStreamer", fmt::format("texture `{}`: format {} of `{}` can not be sampled and has no supported fallback",
+                name, (uint32_t)source.TextureFormat, filePath));
+        }
+        VALX_ASSERT(format != Format::UNKNOWN && "streamed texture format is not supported");
+        if (format != source.TextureFormat)
+        {
+            GetCurrentLogger()->LogWarning("VulkanTextureStreamer", fmt::format("texture `{}`: format {} is not supported, mips are converted to {} when streamed",
+                name, (uint32_t)source.TextureFormat, (uint32_t)format));
+        }
+
+        StreamedTextureHandle handle = static_cast<StreamedTextureHandle>(this->textures.size());
+        if (!this->freeHandles.empty())
+        {
+            handle = this->freeHandles.back();
+            this->freeHandles.pop_back();
+        }
+        else
+        {
+            this->textures.emplace_back();
+        }
+
+        StreamedTexture& texture = this->textures[handle];
+        texture.Name = name;
+        texture.Source = std::move(source);
+        texture.TextureFormat = format;
+        texture.BaseMip = texture.Source.MipCount - 1;
+        for (uint32_t mip = 0; mip < texture.Source.MipCount; mip++)
+        {
+            if (std::max(texture.Source.Width >> mip, texture.Source.Height >> mip) <= this->info.MinResidentSize)
+            {
+                texture.BaseMip = mip;
+                break;
+            }
+        }
+        texture.ResidentMip = texture.BaseMip;
+        texture.DesiredMip = texture.BaseMip;
+        texture.ScreenSize = 0.0f;
+        texture.Distance = 0.0f;
+        texture.LastUsedFrame = 0;
+        texture.IsLoading = false;
+        texture.IsUploadQueued = false;
+        texture.IsUsed = true;
+
+        // the tail of the chain is uploaded as if it were the whole file
+        MappedTextureData tail = texture.Source;
+        tail.Width = std::max(tail.Width >> texture.BaseMip, 1u);
+        tail.Height = std::max(tail.Height >> texture.BaseMip, 1u);
+        tail.MipCount -= texture.BaseMip;
+        tail.Subresources.clear();
+        for (const TextureSubresource& subresource : texture.Source.Subresources)
+        {
+            if (subresource.Mip < texture.BaseMip)
+                continue;
+            TextureSubresource& tailSubresource = tail.Subresources.emplace_back(subresource);
+            tailSubresource.Mip -= texture.BaseMip;
+        }
+
+        // converted on upload when the resident format is the fallback
+        texture.Texture = std::make_unique<VulkanTexture>(GetResidentTextureInfo(name, texture.Source, texture.TextureFormat, texture.ResidentMip));
+        GetVulkanContext()->UploadTexture(*texture.Texture, tail, TextureUploadInfo{});
+        this->statistics.ResidentBytes += this->GetResidentByteSize(texture);
+
+        GetCurrentLogger()->LogInfo("VulkanTextureStreamer", fmt::format("texture `{}` added with {} of {} mips resident",
+            name, texture.Source.MipCount - texture.ResidentMip, texture.Source.MipCount));
+        return handle;
+    }
+
+    void VulkanTextureStreamer::RemoveTexture(StreamedTextureHandle handle)
+    {
+        StreamedTexture& texture = this->textures[handle];
+        VALX_ASSERT(texture.IsUsed);
+        this->statistics.ResidentBytes -= this->GetResidentByteSize(texture);
+        this->retiredTextures.push_back(RetiredTexture{ this->frameCounter, std::move(texture.Texture) });
+
+        texture.Source = MappedTextureData{};
+        texture.TextureFormat = Format::UNKNOWN;
+        texture.Generation++;
+        texture.IsLoading = false;
+        texture.IsUploadQueued = false;
+        texture.IsUsed = false;
+        this->freeHandles.push_back(handle);
+    }
+
+    void VulkanTextureStreamer::RequestTexture(StreamedTextureHandle handle, float screenSize, float distance)
+    {
+        StreamedTexture& texture = this->textures[handle];
+        VALX_ASSERT(texture.IsUsed);
+        if (texture.LastUsedFrame != this->frameCounter)
+        {
+            texture.ScreenSize = screenSize;
+            texture.Distance = distance;
+        }
+        else
+        {
+            texture.ScreenSize = std::max(texture.ScreenSize, screenSize);
+            texture.Distance = std::min(texture.Distance, distance);
+        }
+        texture.LastUsedFrame = this->frameCounter;
+
+        // one texel per pixel at the largest use
+        float texelsPerPixel = std::max(texture.Source.Width, texture.Source.Height) / std::max(texture.ScreenSize, 1.0f);
+        uint32_t desiredMip = static_cast<uint32_t>(std::floor(std::log2(std::max(texelsPerPixel, 1.0f))));
+        texture.DesiredMip = std::min(desiredMip, texture.BaseMip);
+    }
+
+    bool VulkanTextureStreamer::EvictFor(VkCommandBuffer commandBuffer, uint64_t bytes, StreamedTextureHandle requester)
+    {
+        const StreamedTexture* requesterTexture = requester < this->textures.size() ? &this->textures[requester] : nullptr;
+        while (this->statistics.ResidentBytes + bytes > this->budgetBytes)
+        {
+            // mips nobody asked for this frame go first, least recently used and smallest on screen first, then the ones
+            // needed by textures smaller on screen than the requester
+            StreamedTextureHandle victim = ~0u;
+            std::tuple<int, uint64_t, float> victimKey;
+            for (StreamedTextureHandle handle = 0; handle < this->textures.size(); handle++)
+            {
+                const StreamedTexture& texture = this->textures[handle];
+                if (!texture.IsUsed || texture.IsUploadQueued || handle == requester || texture.ResidentMip >= texture.BaseMip)
+                    continue;
+
+                bool isNeeded = texture.LastUsedFrame == this->frameCounter && texture.ResidentMip >= texture.DesiredMip;
+                if (isNeeded && (requesterTexture == nullptr || texture.ScreenSize >= requesterTexture->ScreenSize))
+                    continue;
+
+                std::tuple<int, uint64_t, float> key{ isNeeded ? 1 : 0, texture.LastUsedFrame, texture.ScreenSize };
+                if (victim == ~0u || key < victimKey)
+                {
+                    victim = handle;
+                    victimKey = key;
+                }
+            }
+
+            if (victim == ~0u)
+                return false;
+            this->ReplaceTexture(commandBuffer, victim, this->textures[victim].ResidentMip + 1, nullptr, 0);
+            this->statistics.EvictedMips++;
+        }
+        return true;
+    }
+
+    void VulkanTextureStreamer::ScheduleLoads()
+    {
+        std::vector<StreamedTextureHandle> candidates;
+        for (StreamedTextureHandle handle = 0; handle < this->textures.size(); handle++)
+        {
+            const StreamedTexture& texture = this->textures[handle];
+            if (texture.IsUsed && !texture.IsLoading && texture.LastUsedFrame == this->frameCounter && texture.DesiredMip < texture.ResidentMip)
+                candidates.push_back(handle);
+        }
+
+        // larger on screen first, closer first among equally large ones
+        std::sort(candidates.begin(), candidates.end(), [this](StreamedTextureHandle left, StreamedTextureHandle right)
+        {
+            const StreamedTexture& leftTexture = this->textures[left];
+            const StreamedTexture& rightTexture = this->textures[right];
+            if (leftTexture.ScreenSize != rightTexture.ScreenSize)
+                return leftTexture.ScreenSize > rightTexture.ScreenSize;
+            return leftTexture.Distance < rightTexture.Distance;
+        });
+
+        for (StreamedTextureHandle handle : candidates)
+        {
+            if (this->loads.size() >= this->info.MaxPendingLoads)
+                break;
+
+            // mips stream in one at a time, so each texture gets sharper gradually instead of waiting for its whole chain
+            StreamedTexture& texture = this->textures[handle];
+            uint32_t mip = texture.ResidentMip - 1;
+            if (this->GetMipByteSize(texture, mip) > this->budgetBytes)
+                continue;
+
+            // source layers are at their file offsets, resident ones at the offsets of the staging layout
+            std::vector<TextureSubresource> layers;
+            std::vector<TextureSubresource> residentLayers;
+            size_t stride = GetLayerStagingStride(this->GetResidentSubresource(texture, 0, mip), texture.TextureFormat);
+            for (uint32_t layer = 0; layer < texture.Source.Layers; layer++)
+            {
+                layers.push_back(texture.Source.GetSubresource(layer, mip));
+                TextureSubresource& residentLayer = residentLayers.emplace_back(this->GetResidentSubresource(texture, layer, mip));
+                residentLayer.Offset = layer * stride;
+            }
+
+            texture.IsLoading = true;
+            this->loads.push_back(GetThreadPool()->Submit([this, file = texture.Source.File, sourceFormat = texture.Source.TextureFormat, format = texture.TextureFormat,
+                layers = std::move(layers), residentLayers = std::move(residentLayers), stride, handle, generation = texture.Generation, mip]()
+            {
+                LoadedMip loadedMip;
+                loadedMip.Handle = handle;
+                loadedMip.Generation = generation;
+                loadedMip.Mip = mip;
+
+                loadedMip.Bytes.resize(stride * layers.size());
+                if (format != sourceFormat)
+                {
+                    ConvertTextureSubresources(sourceFormat, file->GetData(), layers, format, loadedMip.Bytes.data(), residentLayers);
+                }
+                else
+                {
+                    for (size_t layer = 0; layer < layers.size(); layer++)
+                        std::memcpy(loadedMip.Bytes.data() + residentLayers[layer].Offset, file->GetData() + layers[layer].Offset, layers[layer].Size);
+                }
+
+                std::scoped_lock lock(this->loadedMipsMutex);
+                this->loadedMips.push_back(std::move(loadedMip));
+            }));
+        }
+    }
+
+    void VulkanTextureStreamer::ReplaceTexture(VkCommandBuffer commandBuffer, StreamedTextureHandle handle, uint32_t residentMip, const VulkanBuffer* stagingBuffer, size_t stagingOffset)
+    {
+        StreamedTexture& texture = this->textures[handle];
+        const MappedTextureData& source = texture.Source;
+        VALX_ASSERT(residentMip <= texture.BaseMip && (residentMip >= texture.ResidentMip || (residentMip + 1 == texture.ResidentMip && stagingBuffer != nullptr)));
+
+        auto replacement = std::make_unique<VulkanTexture>(GetResidentTextureInfo(texture.Name, source, texture.TextureFormat, residentMip));
+        TransitionImage(commandBuffer, *replacement, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        TransitionImage(commandBuffer, *texture.Texture, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            SAMPLING_STAGES, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+        // mips both textures hold move over on the GPU, only a newly streamed mip comes from the staging memory
+        std::vector<VkImageCopy> imageCopies;
+        for (uint32_t mip = std::max(residentMip, texture.ResidentMip); mip < source.MipCount; mip++)
+        {
+            VkImageCopy& copy = imageCopies.emplace_back();
+            copy.srcSubresource = VkImageSubresourceLayers{ VK_IMAGE_ASPECT_COLOR_BIT, mip - texture.ResidentMip, 0, source.Layers };
+            copy.dstSubresource = VkImageSubresourceLayers{ VK_IMAGE_ASPECT_COLOR_BIT, mip - residentMip, 0, source.Layers };
+            copy.extent = VkExtent3D{ std::max(source.Width >> mip, 1u), std::max(source.Height >> mip, 1u), 1 };
+        }
+        vkCmdCopyImage(commandBuffer, static_cast<VkImage>(texture.Texture->GetHandle()), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            static_cast<VkImage>(replacement->GetHandle()), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(imageCopies.size()), imageCopies.data());
+
+        if (residentMip < texture.ResidentMip)
+        {
+            std::vector<VkBufferImageCopy> regions;
+            size_t stride = GetLayerStagingStride(this->GetResidentSubresource(texture, 0, residentMip), texture.TextureFormat);
+            for (uint32_t layer = 0; layer < source.Layers; layer++)
+            {
+                TextureSubresource subresource = this->GetResidentSubresource(texture, layer, residentMip);
+                subresource.Offset = stagingOffset + layer * stride;
+                subresource.Mip = 0;
+                regions.push_back(ConvertTextureSubresourceVulkan(subresource, texture.TextureFormat));
+            }
+            vkCmdCopyBufferToImage(commandBuffer, static_cast<VkBuffer>(stagingBuffer->GetHandle()), static_cast<VkImage>(replacement->GetHandle()),
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+        }
+
+        TransitionImage(commandBuffer, *replacement, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, SAMPLING_STAGES, VK_ACCESS_SHADER_READ_BIT);
+
+        // frames in flight may still sample the old texture
+        this->statistics.ResidentBytes -= this->GetResidentByteSize(texture);
+        this->retiredTextures.push_back(RetiredTexture{ this->frameCounter, std::move(texture.Texture) });
+        texture.Texture = std::move(replacement);
+        texture.ResidentMip = residentMip;
+        this->statistics.ResidentBytes += this->GetResidentByteSize(texture);
+
+        if (std::find(this->changedTextures.begin(), this->changedTextures.end(), handle) == this->changedTextures.end())
+            this->changedTextures.push_back(handle);
+    }
+
+    void VulkanTextureStreamer::Update(CommandBuffer& commandBuffer)
+    {
+        VkCommandBuffer vkCommandBuffer = static_cast<VkCommandBuffer>(commandBuffer.GetHandle());
+        this->changedTextures.clear();
+        this->budgetBytes = this->ComputeBudget();
+
+        this->retiredTextures.erase(std::remove_if(this->retiredTextures.begin(), this->retiredTextures.end(), [this](const RetiredTexture& retired)
+        {
+            return retired.Frame + this->info.FramesInFlight <= this->frameCounter;
+        }), this->retiredTextures.end());
+
+        std::vector<LoadedMip> loadedMips;
+        {
+            std::scoped_lock lock(this->loadedMipsMutex);
+            loadedMips = std::move(this->loadedMips);
+            this->loadedMips.clear();
+        }
+
+        // the budget is checked when a load finishes, since evictions and requests change while it runs. Mips queued for upload
+        // count against it already, and their textures are kept from being evicted until the copies are recorded
+        std::vector<LoadedMip> uploads;
+        std::vector<LoadedMip> deferred;
+        uint64_t uploadBytes = 0;
+        uint64_t queuedResidentBytes = 0;
+        for (LoadedMip& loadedMip : loadedMips)
+        {
+            StreamedTexture& texture = this->textures[loadedMip.Handle];
+            if (!texture.IsUsed || texture.Generation != loadedMip.Generation)
+                continue;
+            if (uploadBytes != 0 && uploadBytes + loadedMip.Bytes.size() > this->info.MaxUploadBytesPerFrame)
+            {
+                deferred.push_back(std::move(loadedMip));
+                continue;
+            }
+
+            texture.IsLoading = false;
+            uint64_t mipByteSize = this->GetMipByteSize(texture, loadedMip.Mip);
+            if (loadedMip.Mip + 1 != texture.ResidentMip || !this->EvictFor(vkCommandBuffer, queuedResidentBytes + mipByteSize, loadedMip.Handle))
+                continue;
+            texture.IsUploadQueued = true;
+            queuedResidentBytes += mipByteSize;
+            uploadBytes += loadedMip.Bytes.size();
+            uploads.push_back(std::move(loadedMip));
+        }
+        if (!deferred.empty())
+        {
+            std::scoped_lock lock(this->loadedMipsMutex);
+            std::move(deferred.begin(), deferred.end(), std::back_inserter(this->loadedMips));
+        }
+
+        if (!uploads.empty())
+        {
+            // the buffer of this frame slot was last read FramesInFlight frames ago, so it can be rewritten or replaced
+            std::unique_ptr<VulkanBuffer>& stagingBuffer = this->stagingBuffers[this->frameCounter % this->stagingBuffers.size()];
+            if (stagingBuffer == nullptr || stagingBuffer->GetInfo().Size < uploadBytes)
+            {
+                BufferInfo stagingInfo;
+                stagingInfo.Name = fmt::format("texture streamer staging {}", this->frameCounter % this->stagingBuffers.size());
+                stagingInfo.Flags = BufferFlags::COPY_SRC;
+                stagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+                stagingInfo.Size = static_cast<uint32_t>(std::max(uploadBytes, this->info.MaxUploadBytesPerFrame));
+                stagingBuffer = std::make_unique<VulkanBuffer>(stagingInfo);
+            }
+
+            uint8_t* staging = stagingBuffer->MapMemory();
+            size_t stagingOffset = 0;
+            for (const LoadedMip& upload : uploads)
+            {
+                std::memcpy(staging + stagingOffset, upload.Bytes.data(), upload.Bytes.size());
+                stagingOffset += upload.Bytes.size();
+            }
+            stagingBuffer->UnmapMemory();
+
+            stagingOffset = 0;
+            for (const LoadedMip& upload : uploads)
+            {
+                this->ReplaceTexture(vkCommandBuffer, upload.Handle, upload.Mip, stagingBuffer.get(), stagingOffset);
+                this->textures[upload.Handle].IsUploadQueued = false;
+                stagingOffset += upload.Bytes.size();
+                this->statistics.StreamedMips++;
+            }
+        }
+
+        // the budget may have shrunk since the last frame
+        this->EvictFor(vkCommandBuffer, 0, ~0u);
+
+        this->loads.erase(std::remove_if(this->loads.begin(), this->loads.end(), [](const std::future<void>& load)
+        {
+            return load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), this->loads.end());
+        this->ScheduleLoads();
+
+        this->statistics.BudgetBytes = this->budgetBytes;
+        this->statistics.TextureCount = static_cast<uint32_t>(this->textures.size() - this->freeHandles.size());
+        this->statistics.PendingLoads = static_cast<uint32_t>(this->loads.size());
+        this->frameCounter++;
+    }
+
+    Texture& VulkanTextureStreamer::GetTexture(StreamedTextureHandle handle)
+    {
+        VALX_ASSERT(this->textures[handle].IsUsed);
+        return *this->textures[handle].Texture;
+    }
+
+    const std::vector<StreamedTextureHandle>& VulkanTextureStreamer::GetChangedTextures() const
+    {
+        return this->changedTextures;
+    }
+
+    uint32_t VulkanTextureStreamer::GetResidentMip(StreamedTextureHandle handle) const
+    {
+        return this->textures[handle].ResidentMip;
+    }
+
+    TextureStreamerStatistics VulkanTextureStreamer::GetStatistics() const
+    {
+        return this->statistics;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "api/TextureStreamer.h"
+#include "api/TextureLoader.h"
+#include "VulkanTexture.h"
+#include "VulkanBuffer.h"
+
+#include <vulkan/vulkan.h>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace VALX
+{
+    class VulkanTextureStreamer : public TextureStreamer
+    {
+        struct StreamedTexture
+        {
+            std::string Name;
+            MappedTextureData Source;
+            // the format of the file, or its fallback if the device can not sample that. Streamed mips are converted when they are read
+            Format TextureFormat = Format::UNKNOWN;
+            std::unique_ptr<VulkanTexture> Texture;
+            // mips from ResidentMip to the end of the chain are in the texture, BaseMip is the coarsest ResidentMip can get
+            uint32_t ResidentMip = 0;
+            uint32_t BaseMip = 0;
+            uint32_t DesiredMip = 0;
+            float ScreenSize = 0.0f;
+            float Distance = 0.0f;
+            uint64_t LastUsedFrame = 0;
+            // loads of a removed texture finish after its slot may have been reused, they are matched by generation
+            uint32_t Generation = 0;
+            bool IsLoading = false;
+            // a loaded mip of this texture is copied later in the same Update, it must not lose mips before that
+            bool IsUploadQueued = false;
+            bool IsUsed = false;
+        };
+
+        struct LoadedMip
+        {
+            StreamedTextureHandle Handle = 0;
+            uint32_t Generation = 0;
+            uint32_t Mip = 0;
+            // every layer of the mip at the aligned offsets of the staging layout
+            std::vector<uint8_t> Bytes;
+        };
+
+        struct RetiredTexture
+        {
+            uint64_t Frame = 0;
+            std::unique_ptr<VulkanTexture> Texture;
+        };
+
+        TextureStreamerInfo info;
+        std::vector<StreamedTexture> textures;
+        std::vector<StreamedTextureHandle> freeHandles;
+        std::vector<StreamedTextureHandle> changedTextures;
+        std::vector<RetiredTexture> retiredTextures;
+        // one per frame in flight, grown when a mip does not fit
+        std::vector<std::unique_ptr<VulkanBuffer>> stagingBuffers;
+        uint64_t frameCounter = 1;
+
+        std::vector<std::future<void>> loads;
+        std::vector<LoadedMip> loadedMips;
+        std::mutex loadedMipsMutex;
+
+        uint64_t budgetBytes = 0;
+        TextureStreamerStatistics statistics;
+
+        uint64_t ComputeBudget() const;
+        // one layer of a mip as it is laid out in the resident texture
+        TextureSubresource GetResidentSubresource(const StreamedTexture& texture, uint32_t layer, uint32_t mip) const;
+        uint64_t GetMipByteSize(const StreamedTexture& texture, uint32_t mip) const;
+        uint64_t GetResidentByteSize(const StreamedTexture& texture) const;
+        // evicts single mips until the bytes fit into the budget, false if the rest is needed by textures larger on screen than the requester
+        bool EvictFor(VkCommandBuffer commandBuffer, uint64_t bytes, StreamedTextureHandle requester);
+        void ScheduleLoads();
+        void ReplaceTexture(VkCommandBuffer commandBuffer, StreamedTextureHandle handle, uint32_t residentMip, const VulkanBuffer* stagingBuffer, size_t stagingOffset);
+
+    public:
+        VulkanTextureStreamer(const TextureStreamerInfo& info);
+        virtual ~VulkanTextureStreamer() override;
+
+        VALX_NO_COPY_NO_MOVE(VulkanTextureStreamer);
+
+        virtual StreamedTextureHandle AddTexture(const std::string& filePath, const std::string& name) override;
+        virtual void RemoveTexture(StreamedTextureHandle handle) override;
+        virtual void RequestTexture(StreamedTextureHandle handle, float screenSize, float distance) override;
+        virtual void Update(CommandBuffer& commandBuffer) override;
+        virtual Texture& GetTexture(StreamedTextureHandle handle) override;
+        virtual const std::vector<StreamedTextureHandle>& GetChangedTextures() const override;
+        virtual uint32_t GetResidentMip(StreamedTextureHandle handle) const override;
+        virtual TextureStreamerStatistics GetStatistics() const override;
+    };
+}
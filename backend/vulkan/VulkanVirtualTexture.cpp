@@ -0,0 +1,579 @@
+#include "VulkanVirtualTexture.h"
+#include "VulkanContext.h"
+#include "Utilities.h"
+#include "api/ThreadPool.h"
+#include "api/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace VALX
+{
+    // page lookups and feedback for the shaders, the constants describing the texture are prepended by BuildShaderSource
+    static const char* VirtualTextureShaderSource = R"(
+layout(set = VIRTUAL_TEXTURE_FEEDBACK_SET, binding = VIRTUAL_TEXTURE_FEEDBACK_BINDING, std430) buffer bVirtualTextureFeedback
+{
+    uint vtRequestCount;
+    uint vtRequests[VT_FEEDBACK_CAPACITY];
+    // one bit per page of every mip, only the first request of a page is appended
+    uint vtRequestedPages[];
+};
+
+// lod in texels of the top mip from the screen space derivatives, fragment shaders only
+float GetVirtualTextureLod(vec2 uv)
+{
+    vec2 dx = dFdx(uv * VT_VIRTUAL_SIZE);
+    vec2 dy = dFdy(uv * VT_VIRTUAL_SIZE);
+    return 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+}
+
+int GetVirtualTextureMip(float lod)
+{
+    return clamp(int(floor(lod)), 0, VT_MIP_COUNT - 1);
+}
+
+vec2 GetVirtualTextureMipSize(int mip)
+{
+    return max(floor(VT_VIRTUAL_SIZE / exp2(float(mip))), vec2(1.0));
+}
+
+uvec2 GetVirtualTexturePage(vec2 uv, int mip)
+{
+    return min(uvec2(clamp(uv, 0.0, 1.0) * GetVirtualTextureMipSize(mip) / VT_PAGE_SIZE), VT_MIP_PAGE_COUNTS[mip] - 1u);
+}
+
+void RequestVirtualTexturePage(vec2 uv, float lod)
+{
+    int mip = GetVirtualTextureMip(lod);
+    uvec2 page = GetVirtualTexturePage(uv, mip);
+    uint index = VT_MIP_FIRST_PAGE[mip] + page.y * VT_MIP_PAGE_COUNTS[mip].x + page.x;
+    uint bit = 1u << (index & 31u);
+    if ((atomicOr(vtRequestedPages[index >> 5], bit) & bit) != 0u)
+        return;
+
+    uint request = atomicAdd(vtRequestCount, 1u);
+    if (request < VT_FEEDBACK_CAPACITY)
+        vtRequests[request] = (uint(mip) << 28) | (page.y << 14) | page.x;
+}
+
+// the indirection entry names the physical slot and the mip of the resident page, which may be coarser than the requested one
+vec4 SampleVirtualTexture(sampler2D physicalTexture, usampler2D indirectionTexture, vec2 uv, float lod)
+{
+    int mip = GetVirtualTextureMip(lod);
+    uint entry = texelFetch(indirectionTexture, ivec2(GetVirtualTexturePage(uv, mip)), mip).r;
+    vec2 slot = vec2(float(entry & 0x3FFu), float((entry >> 10) & 0x3FFu));
+    int residentMip = int((entry >> 20) & 0xFu);
+
+    vec2 texel = clamp(uv, 0.0, 1.0) * GetVirtualTextureMipSize(residentMip);
+    vec2 page = vec2(GetVirtualTexturePage(uv, residentMip));
+    vec2 physicalTexel = slot * VT_SLOT_SIZE + VT_PAGE_BORDER + (texel - page * VT_PAGE_SIZE);
+    return textureLod(physicalTexture, physicalTexel / VT_PHYSICAL_SIZE, 0.0);
+}
+)";
+
+    constexpr uint32_t MAX_VIRTUAL_MIPS = 16;
+    constexpr uint32_t PAGE_COORDINATE_BITS = 14;
+    constexpr uint32_t PAGE_COORDINATE_MASK = (1u << PAGE_COORDINATE_BITS) - 1;
+    constexpr uint32_t MAX_PHYSICAL_PAGES_PER_AXIS = 1024;
+    constexpr uint32_t INVALID_SLOT = ~0u;
+
+    // mip in the top 4 bits, then y and x, as the shader writes requests
+    static uint32_t PackPage(uint32_t mip, uint32_t x, uint32_t y)
+    {
+        return (mip << (2 * PAGE_COORDINATE_BITS)) | (y << PAGE_COORDINATE_BITS) | x;
+    }
+
+    static uint32_t GetPageMip(uint32_t page)
+    {
+        return page >> (2 * PAGE_COORDINATE_BITS);
+    }
+
+    static uint32_t GetPageX(uint32_t page)
+    {
+        return page & PAGE_COORDINATE_MASK;
+    }
+
+    static uint32_t GetPageY(uint32_t page)
+    {
+        return (page >> PAGE_COORDINATE_BITS) & PAGE_COORDINATE_MASK;
+    }
+
+    static uint32_t GetNextPowerOfTwo(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    static void TransitionImage(VkCommandBuffer commandBuffer, const VulkanTexture& texture, VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = static_cast<VkImage>(texture.GetHandle());
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = GetTextureMipCount(texture.GetInfo());
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = texture.GetInfo().Layers;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    VulkanVirtualTexture::VulkanVirtualTexture(const VirtualTextureInfo& info)
+        : info(info)
+    {
+        this->source = GetVulkanContext()->GetTextureLoader()->MapDDSFile(info.FilePath);
+        VALX_ASSERT(!this->source.IsEmpty() && "virtual texture source could not be mapped");
+        VALX_ASSERT(this->source.Type == TextureType::TEXTURE_2D && this->source.Layers == 1);
+        uint32_t blockSize = GetFormatInfo(this->source.TextureFormat).BlockWidth;
+        VALX_ASSERT(info.PageSize % blockSize == 0 && info.PageBorder % blockSize == 0);
+        VALX_ASSERT(info.PhysicalPageCountX <= MAX_PHYSICAL_PAGES_PER_AXIS && info.PhysicalPageCountY <= MAX_PHYSICAL_PAGES_PER_AXIS);
+        VALX_ASSERT(info.FramesInFlight > 0);
+
+        // mips down to the first one that fits into a single page, or as many as the file has
+        uint32_t pageCount = 0;
+        for (uint32_t mip = 0; mip < std::min(this->source.MipCount, MAX_VIRTUAL_MIPS); mip++)
+        {
+            MipPages pages;
+            pages.CountX = (std::max(this->source.Width >> mip, 1u) + info.PageSize - 1) / info.PageSize;
+            pages.CountY = (std::max(this->source.Height >> mip, 1u) + info.PageSize - 1) / info.PageSize;
+            pages.FirstPage = pageCount;
+            pageCount += pages.CountX * pages.CountY;
+            this->mipPages.push_back(pages);
+            if (pages.CountX == 1 && pages.CountY == 1)
+                break;
+        }
+        VALX_ASSERT(this->mipPages[0].CountX <= PAGE_COORDINATE_MASK + 1 && this->mipPages[0].CountY <= PAGE_COORDINATE_MASK + 1);
+
+        const uint32_t coarsestMip = static_cast<uint32_t>(this->mipPages.size() - 1);
+        const MipPages& coarsestPages = this->mipPages[coarsestMip];
+        this->slots.resize(size_t(info.PhysicalPageCountX) * info.PhysicalPageCountY);
+        VALX_ASSERT(coarsestPages.CountX * coarsestPages.CountY < this->slots.size() && "the coarsest mip has to fit into the page cache with room to spare");
+
+        this->slotSize = info.PageSize + 2 * info.PageBorder;
+        size_t alignment = GetTextureSubresourceAlignment(this->source.TextureFormat);
+        this->slotByteSize = (GetImageByteSize(this->source.TextureFormat, this->slotSize, this->slotSize) + alignment - 1) / alignment * alignment;
+
+        TextureInfo physicalInfo;
+        physicalInfo.Name = info.Name + " physical pages";
+        physicalInfo.TextureFormat = this->source.TextureFormat;
+        physicalInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST;
+        physicalInfo.Width = info.PhysicalPageCountX * this->slotSize;
+        physicalInfo.Height = info.PhysicalPageCountY * this->slotSize;
+        this->physicalTexture = std::make_unique<VulkanTexture>(physicalInfo);
+
+        // power of two sized, so every mip of the table has room for the rounded up page counts of its virtual mip
+        TextureInfo indirectionInfo;
+        indirectionInfo.Name = info.Name + " indirection";
+        indirectionInfo.TextureFormat = Format::R32_UINT;
+        indirectionInfo.Flags = TextureFlags::SAMPLED | TextureFlags::COPY_DST;
+        indirectionInfo.Width = GetNextPowerOfTwo(this->mipPages[0].CountX);
+        indirectionInfo.Height = GetNextPowerOfTwo(this->mipPages[0].CountY);
+        indirectionInfo.Mips = static_cast<uint32_t>(this->mipPages.size());
+        this->indirectionTexture = std::make_unique<VulkanTexture>(indirectionInfo);
+
+        size_t indirectionSize = 0;
+        for (uint32_t mip = 0; mip < indirectionInfo.Mips; mip++)
+        {
+            this->indirectionMipOffsets.push_back(indirectionSize);
+            indirectionSize += size_t(std::max(indirectionInfo.Width >> mip, 1u)) * std::max(indirectionInfo.Height >> mip, 1u);
+        }
+        this->indirection.resize(indirectionSize);
+
+        for (uint32_t i = 0; i < info.FramesInFlight; i++)
+        {
+            FrameResources& frame = this->frames.emplace_back();
+
+            BufferInfo feedbackInfo;
+            feedbackInfo.Name = fmt::format("{} feedback {}", info.Name, i);
+            feedbackInfo.Flags = BufferFlags::STORAGE_BUFFER | BufferFlags::COPY_DST;
+            feedbackInfo.MemoryType = BufferMemory::FROM_GPU_TO_CPU;
+            feedbackInfo.Size = static_cast<uint32_t>(sizeof(uint32_t) * (1 + info.FeedbackCapacity + (pageCount + 31) / 32));
+            frame.FeedbackBuffer = std::make_unique<VulkanBuffer>(feedbackInfo);
+
+            BufferInfo pageStagingInfo;
+            pageStagingInfo.Name = fmt::format("{} page staging {}", info.Name, i);
+            pageStagingInfo.Flags = BufferFlags::COPY_SRC;
+            pageStagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+            pageStagingInfo.Size = static_cast<uint32_t>(this->slotByteSize * std::max(info.MaxUploadsPerFrame, 1u));
+            frame.PageStagingBuffer = std::make_unique<VulkanBuffer>(pageStagingInfo);
+
+            BufferInfo indirectionStagingInfo;
+            indirectionStagingInfo.Name = fmt::format("{} indirection staging {}", info.Name, i);
+            indirectionStagingInfo.Flags = BufferFlags::COPY_SRC;
+            indirectionStagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+            indirectionStagingInfo.Size = static_cast<uint32_t>(indirectionSize * sizeof(uint32_t));
+            frame.IndirectionStagingBuffer = std::make_unique<VulkanBuffer>(indirectionStagingInfo);
+        }
+
+        // the coarsest mip is read right away, so there is something to fall back to from the first frame on
+        BufferInfo pinnedStagingInfo;
+        pinnedStagingInfo.Name = info.Name + " pinned page staging";
+        pinnedStagingInfo.Flags = BufferFlags::COPY_SRC;
+        pinnedStagingInfo.MemoryType = BufferMemory::CPU_ONLY;
+        pinnedStagingInfo.Size = static_cast<uint32_t>(this->slotByteSize * coarsestPages.CountX * coarsestPages.CountY);
+        VulkanBuffer pinnedStagingBuffer(pinnedStagingInfo);
+
+        std::vector<VkBufferImageCopy> regions;
+        uint8_t* pinnedStaging = pinnedStagingBuffer.MapMemory();
+        for (uint32_t y = 0; y < coarsestPages.CountY; y++)
+        {
+            for (uint32_t x = 0; x < coarsestPages.CountX; x++)
+            {
+                uint32_t slot = static_cast<uint32_t>(regions.size());
+                uint32_t page = PackPage(coarsestMip, x, y);
+                size_t offset = slot * this->slotByteSize;
+                this->ReadPage(page, pinnedStaging + offset);
+                this->MakeResident(page, slot);
+                this->slots[slot].IsPinned = true;
+
+                VkBufferImageCopy& region = regions.emplace_back();
+                region.bufferOffset = offset;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = VkOffset3D{ int32_t(slot % info.PhysicalPageCountX * this->slotSize), int32_t(slot / info.PhysicalPageCountX * this->slotSize), 0 };
+                region.imageExtent = VkExtent3D{ this->slotSize, this->slotSize, 1 };
+            }
+        }
+        pinnedStagingBuffer.UnmapMemory();
+        this->RebuildIndirection();
+
+        GetVulkanContext()->ImmediateSubmit([&](VkCommandBuffer commandBuffer)
+        {
+            this->RecordPageCopies(commandBuffer, pinnedStagingBuffer, regions, VK_IMAGE_LAYOUT_UNDEFINED);
+            this->RecordIndirectionCopy(commandBuffer, *this->frames[0].IndirectionStagingBuffer, VK_IMAGE_LAYOUT_UNDEFINED);
+            for (const FrameResources& frame : this->frames)
+                vkCmdFillBuffer(commandBuffer, static_cast<VkBuffer>(frame.FeedbackBuffer->GetHandle()), 0, VK_WHOLE_SIZE, 0);
+
+            VkMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        });
+
+        this->BuildShaderSource();
+
+        GetCurrentLogger()->LogInfo("VulkanVirtualTexture", fmt::format("virtual texture `{}` created: {}x{} texels in {} mips and {} pages, {}x{} physical pages of {} texels",
+            info.Name, this->source.Width, this->source.Height, this->mipPages.size(), pageCount, info.PhysicalPageCountX, info.PhysicalPageCountY, info.PageSize));
+    }
+
+    VulkanVirtualTexture::~VulkanVirtualTexture()
+    {
+        // loads write into this object
+        for (std::future<void>& load : this->loads)
+            load.wait();
+    }
+
+    void VulkanVirtualTexture::ReadPage(uint32_t page, uint8_t* output)
+    {
+        int32_t x = int32_t(GetPageX(page) * this->info.PageSize) - int32_t(this->info.PageBorder);
+        int32_t y = int32_t(GetPageY(page) * this->info.PageSize) - int32_t(this->info.PageBorder);
+        GetVulkanContext()->GetTextureLoader()->ReadTextureRegion(this->source, 0, GetPageMip(page), x, y, this->slotSize, this->slotSize, output);
+    }
+
+    void VulkanVirtualTexture::ProcessFeedback(FrameResources& frame)
+    {
+        std::vector<uint32_t> requests;
+        const uint32_t* feedback = reinterpret_cast<const uint32_t*>(frame.FeedbackBuffer->MapMemory());
+        uint32_t requestCount = feedback[0];
+        if (requestCount > this->info.FeedbackCapacity)
+        {
+            this->statistics.DroppedRequests += requestCount - this->info.FeedbackCapacity;
+            requestCount = this->info.FeedbackCapacity;
+        }
+        requests.assign(feedback + 1, feedback + 1 + requestCount);
+        frame.FeedbackBuffer->UnmapMemory();
+
+        // coarse pages first, they are the fallback of the finer ones
+        std::sort(requests.begin(), requests.end(), [](uint32_t left, uint32_t right)
+        {
+            return GetPageMip(left) > GetPageMip(right);
+        });
+
+        for (uint32_t page : requests)
+        {
+            uint32_t mip = GetPageMip(page);
+            if (mip >= this->mipPages.size() || GetPageX(page) >= this->mipPages[mip].CountX || GetPageY(page) >= this->mipPages[mip].CountY)
+                continue;
+
+            // the page sampled in place of a missing one has to stay as well
+            this->TouchPage(page);
+            if (this->residentPages.count(page) != 0 || this->pendingPages.count(page) != 0)
+                continue;
+            if (this->pendingPages.size() >= this->info.MaxPendingLoads)
+            {
+                this->statistics.DroppedRequests++;
+                continue;
+            }
+
+            this->pendingPages.insert(page);
+            this->loads.push_back(GetThreadPool()->Submit([this, page]()
+            {
+                LoadedPage loadedPage;
+                loadedPage.Page = page;
+                loadedPage.Bytes.resize(GetImageByteSize(this->source.TextureFormat, this->slotSize, this->slotSize));
+                this->ReadPage(page, loadedPage.Bytes.data());
+
+                std::scoped_lock lock(this->loadedPagesMutex);
+                this->loadedPages.push_back(std::move(loadedPage));
+            }));
+        }
+    }
+
+    void VulkanVirtualTexture::TouchPage(uint32_t page)
+    {
+        auto resident = this->residentPages.find(page);
+        while (resident == this->residentPages.end())
+        {
+            page = PackPage(GetPageMip(page) + 1, GetPageX(page) / 2, GetPageY(page) / 2);
+            resident = this->residentPages.find(page);
+        }
+        this->slots[resident->second].LastUsedFrame = this->frameCounter;
+    }
+
+    uint32_t VulkanVirtualTexture::AllocateSlot()
+    {
+        // a free slot, otherwise the least recently used one no request of this frame needs
+        uint32_t result = INVALID_SLOT;
+        for (uint32_t slot = 0; slot < this->slots.size(); slot++)
+        {
+            const PageSlot& candidate = this->slots[slot];
+            if (!candidate.IsUsed)
+                return slot;
+            if (candidate.IsPinned || candidate.LastUsedFrame >= this->frameCounter)
+                continue;
+            if (result == INVALID_SLOT || candidate.LastUsedFrame < this->slots[result].LastUsedFrame)
+                result = slot;
+        }
+
+        if (result != INVALID_SLOT)
+        {
+            this->residentPages.erase(this->slots[result].Page);
+            this->slots[result].IsUsed = false;
+            this->statistics.EvictedPages++;
+        }
+        return result;
+    }
+
+    void VulkanVirtualTexture::MakeResident(uint32_t page, uint32_t slot)
+    {
+        PageSlot& pageSlot = this->slots[slot];
+        pageSlot.Page = page;
+        pageSlot.LastUsedFrame = this->frameCounter;
+        pageSlot.IsUsed = true;
+        this->residentPages[page] = slot;
+        this->isIndirectionDirty = true;
+        this->statistics.LoadedPages++;
+    }
+
+    void VulkanVirtualTexture::RebuildIndirection()
+    {
+        // coarse to fine, so pages that are not resident inherit the entry of the page covering them one mip up
+        const TextureInfo& indirectionInfo = this->indirectionTexture->GetInfo();
+        for (int32_t mip = int32_t(this->mipPages.size()) - 1; mip >= 0; mip--)
+        {
+            const MipPages& pages = this->mipPages[mip];
+            uint32_t rowWidth = std::max(indirectionInfo.Width >> mip, 1u);
+            uint32_t parentRowWidth = std::max(indirectionInfo.Width >> (mip + 1), 1u);
+            uint32_t* entries = this->indirection.data() + this->indirectionMipOffsets[mip];
+            const uint32_t* parentEntries = mip + 1 < int32_t(this->mipPages.size()) ? this->indirection.data() + this->indirectionMipOffsets[mip + 1] : nullptr;
+
+            for (uint32_t y = 0; y < pages.CountY; y++)
+            {
+                for (uint32_t x = 0; x < pages.CountX; x++)
+                {
+                    auto resident = this->residentPages.find(PackPage(mip, x, y));
+                    uint32_t entry = 0;
+                    if (resident != this->residentPages.end())
+                    {
+                        uint32_t slot = resident->second;
+                        entry = (slot % this->info.PhysicalPageCountX) | ((slot / this->info.PhysicalPageCountX) << 10) | (uint32_t(mip) << 20);
+                    }
+                    else
+                    {
+                        VALX_ASSERT(parentEntries != nullptr);
+                        entry = parentEntries[(y / 2) * parentRowWidth + x / 2];
+                    }
+                    entries[y * rowWidth + x] = entry;
+                }
+            }
+        }
+    }
+
+    void VulkanVirtualTexture::RecordPageCopies(VkCommandBuffer commandBuffer, const VulkanBuffer& stagingBuffer, const std::vector<VkBufferImageCopy>& regions, VkImageLayout oldLayout)
+    {
+        TransitionImage(commandBuffer, *this->physicalTexture, oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdCopyBufferToImage(commandBuffer, static_cast<VkBuffer>(stagingBuffer.GetHandle()), static_cast<VkImage>(this->physicalTexture->GetHandle()),
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+        TransitionImage(commandBuffer, *this->physicalTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    void VulkanVirtualTexture::RecordIndirectionCopy(VkCommandBuffer commandBuffer, VulkanBuffer& stagingBuffer, VkImageLayout oldLayout)
+    {
+        std::memcpy(stagingBuffer.MapMemory(), this->indirection.data(), this->indirection.size() * sizeof(uint32_t));
+        stagingBuffer.UnmapMemory();
+
+        const TextureInfo& indirectionInfo = this->indirectionTexture->GetInfo();
+        std::vector<VkBufferImageCopy> regions(this->mipPages.size());
+        for (uint32_t mip = 0; mip < regions.size(); mip++)
+        {
+            regions[mip].bufferOffset = this->indirectionMipOffsets[mip] * sizeof(uint32_t);
+            regions[mip].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[mip].imageSubresource.mipLevel = mip;
+            regions[mip].imageSubresource.layerCount = 1;
+            regions[mip].imageExtent = VkExtent3D{ std::max(indirectionInfo.Width >> mip, 1u), std::max(indirectionInfo.Height >> mip, 1u), 1 };
+        }
+
+        TransitionImage(commandBuffer, *this->indirectionTexture, oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdCopyBufferToImage(commandBuffer, static_cast<VkBuffer>(stagingBuffer.GetHandle()), static_cast<VkImage>(this->indirectionTexture->GetHandle()),
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+        TransitionImage(commandBuffer, *this->indirectionTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        this->isIndirectionDirty = false;
+    }
+
+    void VulkanVirtualTexture::BuildShaderSource()
+    {
+        std::string pageCounts;
+        std::string firstPages;
+        for (const MipPages& pages : this->mipPages)
+        {
+            pageCounts += fmt::format("{}uvec2({}u, {}u)", pageCounts.empty() ? "" : ", ", pages.CountX, pages.CountY);
+            firstPages += fmt::format("{}{}u", firstPages.empty() ? "" : ", ", pages.FirstPage);
+        }
+
+        const TextureInfo& physicalInfo = this->physicalTexture->GetInfo();
+        this->shaderSource = fmt::format(
+            "const vec2 VT_VIRTUAL_SIZE = vec2({}.0, {}.0);\n"
+            "const float VT_PAGE_SIZE = {}.0;\n"
+            "const float VT_PAGE_BORDER = {}.0;\n"
+            "const float VT_SLOT_SIZE = {}.0;\n"
+            "const vec2 VT_PHYSICAL_SIZE = vec2({}.0, {}.0);\n"
+            "const int VT_MIP_COUNT = {};\n"
+            "const uint VT_FEEDBACK_CAPACITY = {}u;\n"
+            "const uvec2 VT_MIP_PAGE_COUNTS[VT_MIP_COUNT] = uvec2[]({});\n"
+            "const uint VT_MIP_FIRST_PAGE[VT_MIP_COUNT] = uint[]({});\n",
+            this->source.Width, this->source.Height, this->info.PageSize, this->info.PageBorder, this->slotSize,
+            physicalInfo.Width, physicalInfo.Height, this->mipPages.size(), this->info.FeedbackCapacity, pageCounts, firstPages);
+        this->shaderSource += VirtualTextureShaderSource;
+    }
+
+    void VulkanVirtualTexture::Update(CommandBuffer& commandBuffer)
+    {
+        VkCommandBuffer vkCommandBuffer = static_cast<VkCommandBuffer>(commandBuffer.GetHandle());
+        this->frameCounter++;
+        this->frameIndex = this->frameCounter % this->frames.size();
+        FrameResources& frame = this->frames[this->frameIndex];
+
+        this->ProcessFeedback(frame);
+
+        // finished loads beyond the upload budget wait for the next frame
+        std::vector<LoadedPage> uploads;
+        {
+            std::scoped_lock lock(this->loadedPagesMutex);
+            size_t uploadCount = std::min(this->loadedPages.size(), size_t(this->info.MaxUploadsPerFrame));
+            uploads.assign(std::make_move_iterator(this->loadedPages.begin()), std::make_move_iterator(this->loadedPages.begin() + uploadCount));
+            this->loadedPages.erase(this->loadedPages.begin(), this->loadedPages.begin() + uploadCount);
+        }
+
+        std::vector<VkBufferImageCopy> regions;
+        uint8_t* staging = nullptr;
+        for (const LoadedPage& loadedPage : uploads)
+        {
+            this->pendingPages.erase(loadedPage.Page);
+            uint32_t slot = this->AllocateSlot();
+            if (slot == INVALID_SLOT)
+            {
+                this->statistics.DroppedRequests++;
+                continue;
+            }
+
+            if (staging == nullptr)
+                staging = frame.PageStagingBuffer->MapMemory();
+            size_t offset = regions.size() * this->slotByteSize;
+            std::memcpy(staging + offset, loadedPage.Bytes.data(), loadedPage.Bytes.size());
+            this->MakeResident(loadedPage.Page, slot);
+
+            VkBufferImageCopy& region = regions.emplace_back();
+            region.bufferOffset = offset;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = VkOffset3D{ int32_t(slot % this->info.PhysicalPageCountX * this->slotSize), int32_t(slot / this->info.PhysicalPageCountX * this->slotSize), 0 };
+            region.imageExtent = VkExtent3D{ this->slotSize, this->slotSize, 1 };
+        }
+        if (staging != nullptr)
+            frame.PageStagingBuffer->UnmapMemory();
+
+        if (!regions.empty())
+            this->RecordPageCopies(vkCommandBuffer, *frame.PageStagingBuffer, regions, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        if (this->isIndirectionDirty)
+        {
+            this->RebuildIndirection();
+            this->RecordIndirectionCopy(vkCommandBuffer, *frame.IndirectionStagingBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+
+        // the feedback buffer just read back collects the requests of this frame
+        vkCmdFillBuffer(vkCommandBuffer, static_cast<VkBuffer>(frame.FeedbackBuffer->GetHandle()), 0, VK_WHOLE_SIZE, 0);
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        this->loads.erase(std::remove_if(this->loads.begin(), this->loads.end(), [](const std::future<void>& load)
+        {
+            return load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), this->loads.end());
+
+        this->statistics.ResidentPages = static_cast<uint32_t>(this->residentPages.size());
+        this->statistics.PendingLoads = static_cast<uint32_t>(this->pendingPages.size());
+    }
+
+    void VulkanVirtualTexture::FinishFrame(CommandBuffer& commandBuffer)
+    {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(static_cast<VkCommandBuffer>(commandBuffer.GetHandle()), VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    Texture& VulkanVirtualTexture::GetPhysicalTexture()
+    {
+        return *this->physicalTexture;
+    }
+
+    Texture& VulkanVirtualTexture::GetIndirectionTexture()
+    {
+        return *this->indirectionTexture;
+    }
+
+    Buffer& VulkanVirtualTexture::GetFeedbackBuffer()
+    {
+        return *this->frames[this->frameIndex].FeedbackBuffer;
+    }
+
+    const std::string& VulkanVirtualTexture::GetShaderSource() const
+    {
+        return this->shaderSource;
+    }
+
+    VirtualTextureStatistics VulkanVirtualTexture::GetStatistics() const
+    {
+        return this->statistics;
+    }
+}
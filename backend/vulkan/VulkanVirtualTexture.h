@@ -0,0 +1,100 @@
+#pragma once
+
+#include "api/VirtualTexture.h"
+#include "api/TextureLoader.h"
+#include "VulkanTexture.h"
+#include "VulkanBuffer.h"
+
+#include <vulkan/vulkan.h>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace VALX
+{
+    class VulkanVirtualTexture : public VirtualTexture
+    {
+        struct PageSlot
+        {
+            uint32_t Page = 0;
+            uint64_t LastUsedFrame = 0;
+            bool IsUsed = false;
+            // pages of the coarsest mip are never evicted, every lookup can fall back to them
+            bool IsPinned = false;
+        };
+
+        struct LoadedPage
+        {
+            uint32_t Page = 0;
+            std::vector<uint8_t> Bytes;
+        };
+
+        struct MipPages
+        {
+            uint32_t CountX = 0;
+            uint32_t CountY = 0;
+            // index of the first page of the mip in the request bitmap
+            uint32_t FirstPage = 0;
+        };
+
+        struct FrameResources
+        {
+            std::unique_ptr<VulkanBuffer> FeedbackBuffer;
+            std::unique_ptr<VulkanBuffer> PageStagingBuffer;
+            std::unique_ptr<VulkanBuffer> IndirectionStagingBuffer;
+        };
+
+        VirtualTextureInfo info;
+        MappedTextureData source;
+        std::unique_ptr<VulkanTexture> physicalTexture;
+        std::unique_ptr<VulkanTexture> indirectionTexture;
+        std::vector<FrameResources> frames;
+        uint64_t frameCounter = 0;
+        size_t frameIndex = 0;
+
+        std::vector<MipPages> mipPages;
+        uint32_t slotSize = 0;
+        size_t slotByteSize = 0;
+        // every mip of the indirection table, packed as in the staging buffer
+        std::vector<uint32_t> indirection;
+        std::vector<size_t> indirectionMipOffsets;
+        bool isIndirectionDirty = true;
+
+        std::vector<PageSlot> slots;
+        std::unordered_map<uint32_t, uint32_t> residentPages;
+        std::unordered_set<uint32_t> pendingPages;
+        std::vector<std::future<void>> loads;
+        std::vector<LoadedPage> loadedPages;
+        std::mutex loadedPagesMutex;
+
+        VirtualTextureStatistics statistics;
+        std::string shaderSource;
+
+        void ReadPage(uint32_t page, uint8_t* output);
+        void ProcessFeedback(FrameResources& frame);
+        void TouchPage(uint32_t page);
+        uint32_t AllocateSlot();
+        void MakeResident(uint32_t page, uint32_t slot);
+        void RebuildIndirection();
+        void RecordPageCopies(VkCommandBuffer commandBuffer, const VulkanBuffer& stagingBuffer, const std::vector<VkBufferImageCopy>& regions, VkImageLayout oldLayout);
+        void RecordIndirectionCopy(VkCommandBuffer commandBuffer, VulkanBuffer& stagingBuffer, VkImageLayout oldLayout);
+        void BuildShaderSource();
+
+    public:
+        VulkanVirtualTexture(const VirtualTextureInfo& info);
+        virtual ~VulkanVirtualTexture() override;
+
+        VALX_NO_COPY_NO_MOVE(VulkanVirtualTexture);
+
+        virtual void Update(CommandBuffer& commandBuffer) override;
+        virtual void FinishFrame(CommandBuffer& commandBuffer) override;
+        virtual Texture& GetPhysicalTexture() override;
+        virtual Texture& GetIndirectionTexture() override;
+        virtual Buffer& GetFeedbackBuffer() override;
+        virtual const std::string& GetShaderSource() const override;
+        virtual VirtualTextureStatistics GetStatistics() const override;
+    };
+}
@@ -1,5 +1,6 @@
 #include <api/Context.h>
 #include <window/Window.h>
+#include <api/Logger.h>
 
 // TODO: move to dll
 #include <backend/vulkan/VulkanContext.h>
@@ -49,13 +50,17 @@ int main()
     textureInfo.Height = sandAlbedo.Height;
     textureInfo.Depth = sandAlbedo.Depth;
     textureInfo.Layers = sandAlbedo.Layers;
-    textureInfo.Mips = sandAlbedo.MipCount;
+    textureInfo.Mips = VALX::ALL_MIPS;
     textureInfo.TextureFormat = sandAlbedo.TextureFormat;
     textureInfo.Samples = VALX::SampleCount::SAMPLES_1;
     textureInfo.Type = sandAlbedo.Type;
-    textureInfo.Flags = VALX::TextureFlags::SAMPLED | VALX::TextureFlags::COPY_DST;
+    textureInfo.Flags = VALX::TextureFlags::SAMPLED | VALX::TextureFlags::COPY_DST | VALX::TextureFlags::GENERATE_MIPS;
     auto texture = context->CreateTexture(textureInfo);
 
+    VALX::TextureUploadInfo textureUploadInfo;
+    textureUploadInfo.GenerateMips = true;
+    context->UploadTexture(*texture, sandAlbedo, textureUploadInfo);
+
     VALX::SamplerInfo samplerInfo;
     samplerInfo.Name = "Simple Sampler";
     auto sampler = context->CreateSampler(samplerInfo);
@@ -67,6 +72,9 @@ int main()
     bufferInfo.Name = "Uniform Buffer";
     auto buffer = context->CreateBuffer(bufferInfo);
 
+    // compiled bytecode is reused across runs, only edited shaders go through the compiler again
+    shaderLoader->SetCacheDirectory((std::filesystem::temp_directory_path() / "valx_shader_cache").string());
+
     VALX::ShaderInfo shaderInfo;
     shaderInfo.Stages.push_back(
         shaderLoader->LoadFromSourceFile("main_vertex.glsl", VALX::ShaderStage::VERTEX, VALX::ShaderLanguage::GLSL)
@@ -75,6 +83,10 @@ int main()
         shaderLoader->LoadFromSourceFile("main_fragment.glsl", VALX::ShaderStage::FRAGMENT, VALX::ShaderLanguage::GLSL)
     );
     shaderInfo.Name = "Main Shader";
+
+    VALX::ShaderCacheStatistics shaderCacheStatistics = shaderLoader->GetCacheStatistics();
+    VALX::GetCurrentLogger()->LogInfo("Dummy", fmt::format("shader cache: {} hits, {} misses, {:.2f} ms compiling",
+        shaderCacheStatistics.Hits, shaderCacheStatistics.Misses, shaderCacheStatistics.CompileMilliseconds));
     auto shader = context->CreateShader(shaderInfo);
 
     while (!window.ShouldClose())
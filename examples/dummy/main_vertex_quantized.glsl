@@ -0,0 +1,54 @@
+#version 460
+
+// VALX::VertexFormat::QUANTIZED, see VALX::QuantizedVertex
+layout(location = 0) in vec4 iPosition; // snorm16, w stores bitangent sign
+layout(location = 1) in vec2 iTexCoord; // half
+layout(location = 2) in vec2 iNormal; // snorm16 octahedral
+layout(location = 3) in vec2 iTangent; // snorm16 octahedral
+layout(location = 5) in vec3 iInstancePosition;
+layout(location = 6) in uint iMaterialIndex;
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout(location = 0) out vec3 vPosition;
+layout(location = 1) out vec2 vTexCoord;
+layout(location = 2) out flat uint vMaterialIndex;
+layout(location = 3) out mat3 vNormalMatrix;
+
+layout(set = 0, binding = 0) uniform uCameraBuffer
+{
+    mat4 uViewProjection;
+    vec3 uCameraPosition;
+};
+
+layout(set = 0, binding = 1) uniform uModelBuffer
+{
+    mat3 uModel;
+    vec3 uPositionOffset;
+    vec3 uPositionScale;
+};
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-direction.z, 0.0);
+    direction.xy += mix(vec2(t), vec2(-t), greaterThanEqual(direction.xy, vec2(0.0)));
+    return normalize(direction);
+}
+
+void main()
+{
+    vec3 position = uPositionOffset + iPosition.xyz * uPositionScale;
+    vec3 normal = DecodeOctahedral(iNormal);
+    vec3 tangent = DecodeOctahedral(iTangent);
+    vec3 bitangent = cross(normal, tangent) * iPosition.w;
+
+    vPosition = (uModel * position) + iInstancePosition;
+    gl_Position = uViewProjection * vec4(vPosition, 1.0);
+    vTexCoord = iTexCoord;
+    vMaterialIndex = iMaterialIndex;
+    vNormalMatrix = uModel * mat3(tangent, bitangent, normal);
+}
\ No newline at end of file
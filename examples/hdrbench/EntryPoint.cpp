@@ -0,0 +1,84 @@
+#include <api/Format.h>
+#include <api/SIMD.h>
+#include <api/Logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+// converts a synthetic 4K RGBA float environment map to half floats and to packed R11G11B10 with the scalar reference and the
+// SIMD kernels, then compares the time, the throughput and the results bit for bit
+int main()
+{
+    constexpr uint32_t WIDTH = 4096;
+    constexpr uint32_t HEIGHT = 2048;
+    constexpr size_t TEXEL_COUNT = size_t(WIDTH) * HEIGHT;
+    constexpr int REPETITION_COUNT = 5;
+
+    // radiance spread over many orders of magnitude, with values beyond the range of both targets and a few negative ones
+    std::vector<float> source(TEXEL_COUNT * 4);
+    std::mt19937 generator(42);
+    std::normal_distribution<float> exponent(0.0f, 4.0f);
+    for (size_t i = 0; i < source.size(); i++)
+        source[i] = i % 4 == 3 ? 1.0f : std::exp2(exponent(generator)) * (i % 97 == 0 ? -1.0f : 1.0f);
+
+    VALX::GetCurrentLogger()->LogInfo("HDRBench", fmt::format("{}x{} texels, SIMD level {}", WIDTH, HEIGHT,
+        VALX::GetSIMDLevelName(VALX::GetSIMDLevel())));
+
+    auto measure = [&](const std::function<void()>& convert)
+    {
+        double bestTime = 1e30;
+        for (int repetition = 0; repetition < REPETITION_COUNT; repetition++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            convert();
+            bestTime = std::min(bestTime, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return bestTime;
+    };
+    auto report = [&](const char* kernel, const char* variant, double time, double referenceTime, size_t mismatches)
+    {
+        double gigabytesPerSecond = source.size() * sizeof(float) / (time * 1e6);
+        VALX::GetCurrentLogger()->LogInfo("HDRBench", fmt::format("{:>10} {:>6}: {:8.2f} ms, {:6.2f} GB/s read, {:5.2f}x, {} texels differ from scalar",
+            kernel, variant, time, gigabytesPerSecond, referenceTime / time, mismatches));
+    };
+
+    std::vector<uint16_t> halfReference(source.size()), halfResult(source.size());
+    double halfReferenceTime = measure([&]() { VALX::ConvertFloatToHalf(source.data(), halfReference.data(), source.size(), false); });
+    double halfTime = measure([&]() { VALX::ConvertFloatToHalf(source.data(), halfResult.data(), source.size(), true); });
+    size_t halfMismatches = 0;
+    for (size_t i = 0; i < TEXEL_COUNT; i++)
+        halfMismatches += std::memcmp(&halfReference[i * 4], &halfResult[i * 4], 4 * sizeof(uint16_t)) != 0;
+    report("half", "scalar", halfReferenceTime, halfReferenceTime, 0);
+    report("half", "simd", halfTime, halfReferenceTime, halfMismatches);
+
+    std::vector<uint32_t> packedReference(TEXEL_COUNT), packedResult(TEXEL_COUNT);
+    double packedReferenceTime = measure([&]() { VALX::ConvertFloatToR11G11B10(source.data(), packedReference.data(), TEXEL_COUNT, false); });
+    double packedTime = measure([&]() { VALX::ConvertFloatToR11G11B10(source.data(), packedResult.data(), TEXEL_COUNT, true); });
+    size_t packedMismatches = 0;
+    for (size_t i = 0; i < TEXEL_COUNT; i++)
+        packedMismatches += packedReference[i] != packedResult[i];
+    report("r11g11b10", "scalar", packedReferenceTime, packedReferenceTime, 0);
+    report("r11g11b10", "simd", packedTime, packedReferenceTime, packedMismatches);
+
+    // round trip error of the packed format relative to the source, 6 and 5 bit mantissas bound it by 2^-7 and 2^-6
+    double maxRelativeError = 0.0;
+    for (size_t i = 0; i < TEXEL_COUNT; i++)
+    {
+        float decoded[3];
+        VALX::R11G11B10ToFloat(packedResult[i], decoded[0], decoded[1], decoded[2]);
+        for (int channel = 0; channel < 3; channel++)
+        {
+            float value = source[i * 4 + channel];
+            if (value > 1e-3f && value < 6e4f)
+                maxRelativeError = std::max(maxRelativeError, double(std::abs(decoded[channel] - value) / value));
+        }
+    }
+    VALX::GetCurrentLogger()->LogInfo("HDRBench", fmt::format("r11g11b10 max relative error {:.5f}", maxRelativeError));
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <api/MipBuilder.h>
+#include <api/TextureLoader.h>
+#include <api/Logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+
+// builds the mip chain of the sample albedo with the scalar reference and the SIMD kernels and compares time and results,
+// then compares a cold and a warm load of the cooked albedo through the texture cache
+int main()
+{
+    if (std::filesystem::exists(APPLICATION_WORKING_DIRECTORY))
+        std::filesystem::current_path(APPLICATION_WORKING_DIRECTORY);
+
+    VALX::TextureLoader textureLoader;
+    VALX::TextureData source = textureLoader.LoadTextureFromFile("../textures/sand_albedo.jpg");
+    source.TextureFormat = VALX::Format::R8G8B8A8_SRGB;
+
+    constexpr int REPETITION_COUNT = 5;
+    const std::pair<VALX::MipFilter, const char*> filters[] = {
+        { VALX::MipFilter::BOX, "box" },
+        { VALX::MipFilter::KAISER, "kaiser" },
+        { VALX::MipFilter::LANCZOS3, "lanczos3" },
+    };
+
+    for (const auto& [filter, filterName] : filters)
+    {
+        VALX::TextureData reference;
+        double referenceTime = 0.0;
+        for (int variant = 0; variant < 3; variant++)
+        {
+            VALX::MipBuildInfo info;
+            info.Filter = filter;
+            info.UseSIMD = variant != 0;
+            info.Multithreaded = variant == 2;
+
+            VALX::TextureData result;
+            double bestTime = 1e30;
+            for (int repetition = 0; repetition < REPETITION_COUNT; repetition++)
+            {
+                result = source;
+                auto start = std::chrono::steady_clock::now();
+                VALX::BuildMips(result, info);
+                bestTime = std::min(bestTime, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            if (variant == 0)
+            {
+                reference = result;
+                referenceTime = bestTime;
+            }
+
+            // both chains share one layout, so the blobs compare byte by byte
+            int maxDifference = 0;
+            for (size_t i = 0; i < result.Bytes.size(); i++)
+                maxDifference = std::max(maxDifference, std::abs(int(result.Bytes[i]) - int(reference.Bytes[i])));
+
+            const char* variantNames[] = { "scalar", "simd", "simd + threads" };
+            VALX::GetCurrentLogger()->LogInfo("MipBench", fmt::format("{:>8} {:>14}: {:8.2f} ms, {:5.2f}x, max difference to scalar {}",
+                filterName, variantNames[variant], bestTime, referenceTime / bestTime, maxDifference));
+        }
+    }
+
+    // cooking writes the entry on the first load, the second one reads it back
+    std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "valx_mipbench_cache";
+    std::filesystem::remove_all(cacheDirectory);
+    textureLoader.SetCacheDirectory(cacheDirectory.string());
+
+    VALX::TextureCookInfo cookInfo;
+    cookInfo.BuildMips = true;
+    cookInfo.Compress = true;
+    const char* loadNames[] = { "cold", "warm" };
+    for (const char* loadName : loadNames)
+    {
+        auto start = std::chrono::steady_clock::now();
+        VALX::TextureData cooked = textureLoader.LoadTextureFromFile("../textures/sand_albedo.jpg", cookInfo);
+        double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        VALX::GetCurrentLogger()->LogInfo("MipBench", fmt::format("{} cooked load: {:8.2f} ms, {} mips", loadName, loadTime, cooked.MipCount));
+    }
+
+    VALX::TextureCacheStatistics statistics = textureLoader.GetCacheStatistics();
+    VALX::GetCurrentLogger()->LogInfo("MipBench", fmt::format("texture cache: {} hits, {} misses, hit rate {:.0f}%, {:.2f} MB saved",
+        statistics.Hits, statistics.Misses, statistics.GetHitRate() * 100.0, statistics.BytesSaved / 1e6));
+    std::filesystem::remove_all(cacheDirectory);
+
+    return 0;
+}